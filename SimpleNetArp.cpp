@@ -0,0 +1,81 @@
+#include "SimpleNetArp.h"
+
+namespace SimpleNet {
+
+static const uint16_t DISCARD_PORT = 9;
+static const unsigned long STEP_TIMEOUT = 5000; ///< Guard in case the chip reports neither SEND_OK nor TIMEOUT.
+
+NetArpCheck::NetArpCheck() {
+    _checkingGateway = false;
+    _gatewayResolved = false;
+    memset(_gatewayMac, 0, sizeof(_gatewayMac));
+    _sentAt = 0;
+}
+
+bool NetArpCheck::start(IPAddress localIp, IPAddress gateway) {
+    if (!_socket.openUdp(NetSocket::ephemeralPort())) {
+        return false;
+    }
+
+    _gateway = gateway;
+    _checkingGateway = false;
+    _gatewayResolved = false;
+    if (!sendProbe(localIp)) {
+        _socket.close();
+        return false;
+    }
+    return true;
+}
+
+NetArpResult NetArpCheck::poll() {
+    if (!isRunning()) {
+        return NET_ARP_CLEAR;
+    }
+
+    if (!_socket.sendComplete()) {
+        if (millis() - _sentAt < STEP_TIMEOUT) {
+            return NET_ARP_PENDING;
+        }
+        return finish(NET_ARP_CLEAR); // No verdict from the chip: assume nobody answered.
+    }
+
+    if (!_checkingGateway) {
+        if (!_socket.sendFailed()) {
+            return finish(NET_ARP_CONFLICT); // Somebody resolved our own address.
+        }
+        if (_gateway == IPAddress(0, 0, 0, 0)) {
+            return finish(NET_ARP_CLEAR);
+        }
+        _checkingGateway = true;
+        if (!sendProbe(_gateway)) {
+            return finish(NET_ARP_CLEAR);
+        }
+        return NET_ARP_PENDING;
+    }
+
+    if (!_socket.sendFailed()) {
+        _socket.destinationMac(_gatewayMac);
+        _gatewayResolved = true;
+    }
+    return finish(NET_ARP_CLEAR);
+}
+
+/**
+ * @brief Private method to send the one-byte datagram that makes the chip ARP for target.
+ */
+bool NetArpCheck::sendProbe(IPAddress target) {
+    static const uint8_t probe = 0;
+    _socket.setDestination(target, DISCARD_PORT);
+    _sentAt = millis();
+    return _socket.send(&probe, 1) == 1;
+}
+
+/**
+ * @brief Private method to release the socket and pass the result through.
+ */
+NetArpResult NetArpCheck::finish(NetArpResult result) {
+    _socket.close();
+    return result;
+}
+
+} // namespace SimpleNet
@@ -0,0 +1,78 @@
+#ifndef SIMPLE_NET_ARP_H
+#define SIMPLE_NET_ARP_H
+
+#include <Arduino.h>
+#include "SimpleNetSocket.h"
+
+namespace SimpleNet {
+
+/**
+ * @brief Outcome of a NetArpCheck.
+ */
+enum NetArpResult {
+    NET_ARP_PENDING,  ///< An ARP exchange is still running.
+    NET_ARP_CLEAR,    ///< Nobody else answers for our address; see gatewayResolved().
+    NET_ARP_CONFLICT  ///< Another host answered ARP for our address.
+};
+
+/**
+ * @brief Non-blocking duplicate address check and gateway MAC lookup for a static address.
+ * @details The chip does its own ARP, so both steps send one byte of UDP (to the
+ * discard port) and read the outcome from the SEND result:
+ * - To our own address. The chip's ARP requests for it double as gratuitous ARP
+ *   announcements, and an answer to them (SEND_OK) means another host holds the
+ *   address. No answer (TIMEOUT) means the address is free.
+ * - To the gateway. On SEND_OK the chip has resolved its MAC, which is kept for
+ *   NetChip::pinGateway().
+ *
+ * Each step takes as long as the chip's ARP retries when nobody answers, i.e. the
+ * Ethernet library's retransmission timeout times (count + 1): 1.8 s by default.
+ * The socket is held only from start() until the result is known.
+ */
+class NetArpCheck {
+public:
+    NetArpCheck();
+
+    /**
+     * @brief Starts the check of localIp, followed by the lookup of gateway (skipped if 0.0.0.0).
+     * @return false if no hardware socket is free.
+     */
+    bool start(IPAddress localIp, IPAddress gateway);
+
+    /**
+     * @brief Advances the check without waiting; the socket is released once the
+     * result is NET_ARP_CLEAR or NET_ARP_CONFLICT.
+     */
+    NetArpResult poll();
+
+    void stop() { _socket.close(); }
+
+    bool isRunning() const { return _socket.isOpen(); }
+
+    /**
+     * @brief Runs the check on chip instead of the library chip.
+     */
+    void attach(NetChip& chip) { _socket.attach(chip); }
+
+    /**
+     * @brief Returns true if the last check learned the gateway's MAC.
+     */
+    bool gatewayResolved() const { return _gatewayResolved; }
+
+    const uint8_t* gatewayMac() const { return _gatewayMac; }
+
+private:
+    NetSocket     _socket;
+    IPAddress     _gateway;
+    bool          _checkingGateway;  ///< Second step: resolving the gateway.
+    bool          _gatewayResolved;
+    uint8_t       _gatewayMac[6];
+    unsigned long _sentAt;
+
+    bool sendProbe(IPAddress target);
+    NetArpResult finish(NetArpResult result);
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_ARP_H
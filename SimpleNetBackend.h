@@ -0,0 +1,82 @@
+#ifndef SIMPLE_NET_BACKEND_H
+#define SIMPLE_NET_BACKEND_H
+
+#include <Arduino.h>
+#include <Ethernet.h>
+#include "SimpleNetDhcp.h"
+#include "SimpleNetSpi.h"
+#include "SimpleNetChip.h"
+
+namespace SimpleNet {
+
+/**
+ * @brief The default backend of SimpleNetManagerT: the Ethernet library's global Ethernet object.
+ * @details A backend supplies the chip calls the connection state machine makes
+ * (chip setup, address configuration, the link check, SPI clock tuning) and the DHCP client type it
+ * drives. Every call here is an inline forward to Ethernet, so the production build
+ * compiles to the same code as calling Ethernet directly; the manager's NetChip
+ * stays the library chip. NetW5500Backend drives a further chip, and NetSimBackend
+ * (SimpleNetSim.h) stands in for both in host-side simulation.
+ */
+class NetEthernetBackend {
+public:
+    typedef DhcpClient Dhcp;
+
+    void init(NetChip&, uint8_t csPin) { Ethernet.init(csPin); }
+
+    void configure(NetChip&, byte mac[], IPAddress ip, IPAddress dns, IPAddress gateway, IPAddress subnet) {
+        Ethernet.begin(mac, ip, dns, gateway, subnet);
+    }
+
+    void setAddresses(NetChip&, IPAddress ip, IPAddress subnet, IPAddress gateway, IPAddress dns) {
+        Ethernet.setLocalIP(ip);
+        Ethernet.setSubnetMask(subnet);
+        Ethernet.setGatewayIP(gateway);
+        Ethernet.setDnsServerIP(dns);
+    }
+
+    bool linkUp(NetChip&) { return Ethernet.linkStatus() == LinkON; }
+
+    uint32_t tuneSpi(uint32_t clock, bool probe, byte mac[]) {
+        return probe ? NetSpi::probe(clock, mac) : NetSpi::select(clock, mac);
+    }
+
+    bool checkSpi() { return NetSpi::verify(); }
+};
+
+/**
+ * @brief Backend for a W5500 on its own chip select pin, next to the library chip.
+ * @details The manager's NetChip is moved to the CS pin and every register access
+ * goes through it, so the Ethernet library's global state is never touched. The DNS
+ * server is kept by the manager's resolver; the chip has no register for it. The
+ * SPI clock is the shared NetSpi one, which the library chip's manager tunes.
+ * @code
+ * SimpleNetManagerT<NET_MODE_ANY, NetNoDebug, 9, NetW5500Backend> secondNet(mac2);
+ * @endcode
+ */
+class NetW5500Backend {
+public:
+    typedef DhcpClient Dhcp;
+
+    void init(NetChip& chip, uint8_t csPin) { chip.setCsPin(csPin); }
+
+    void configure(NetChip& chip, byte mac[], IPAddress ip, IPAddress, IPAddress gateway, IPAddress subnet) {
+        chip.reset();
+        chip.setMac(mac);
+        chip.setAddresses(ip, subnet, gateway);
+    }
+
+    void setAddresses(NetChip& chip, IPAddress ip, IPAddress subnet, IPAddress gateway, IPAddress) {
+        chip.setAddresses(ip, subnet, gateway);
+    }
+
+    bool linkUp(NetChip& chip) { return chip.linkUp(); }
+
+    uint32_t tuneSpi(uint32_t, bool, byte[]) { return NetSpi::clock(); }
+
+    bool checkSpi() { return true; }
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_BACKEND_H
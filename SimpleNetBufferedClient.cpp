@@ -0,0 +1,155 @@
+#include "SimpleNetBufferedClient.h"
+
+namespace SimpleNet {
+
+BufferedClientBase::BufferedClientBase(EthernetClient& client, uint8_t* txBuffer, size_t txSize, uint8_t* rxBuffer, size_t rxSize)
+    : _client(client), _tx(txBuffer), _txSize(txSize), _txLength(0),
+      _rx(rxBuffer), _rxSize(rxSize), _rxPos(0), _rxLength(0) {
+}
+
+int BufferedClientBase::connect(IPAddress ip, uint16_t port) {
+    _txLength = 0;
+    _rxPos = _rxLength = 0;
+    clearWriteError();
+    return _client.connect(ip, port);
+}
+
+int BufferedClientBase::connect(const char* host, uint16_t port) {
+    _txLength = 0;
+    _rxPos = _rxLength = 0;
+    clearWriteError();
+    return _client.connect(host, port);
+}
+
+size_t BufferedClientBase::write(uint8_t b) {
+    if (_txLength == _txSize) {
+        flush();
+        if (_txLength == _txSize) return 0; // The chip took nothing; see flush().
+    }
+    _tx[_txLength++] = b;
+    return 1;
+}
+
+/**
+ * @brief Stages the data, sending full buffers as single bursts.
+ * @details Writes at least as large as the staging buffer go to the chip directly
+ * after any staged bytes, so large payloads are not copied twice. The count
+ * returned is short once the staging buffer is full and the chip takes no more.
+ */
+size_t BufferedClientBase::write(const uint8_t* buf, size_t size) {
+    if (size >= _txSize) {
+        flush();
+        if (_txLength > 0) return 0; // Staged bytes must go first.
+        size_t sent = _client.write(buf, size);
+        if (sent < size) setWriteError();
+        return sent;
+    }
+
+    size_t written = 0;
+    while (written < size) {
+        if (_txLength == _txSize) {
+            flush();
+            if (_txLength == _txSize) break;
+        }
+        size_t chunk = _txSize - _txLength;
+        if (chunk > size - written) chunk = size - written;
+        memcpy(_tx + _txLength, buf + written, chunk);
+        _txLength += chunk;
+        written += chunk;
+    }
+    return written;
+}
+
+int BufferedClientBase::available() {
+    return (int)(_rxLength - _rxPos) + _client.available();
+}
+
+int BufferedClientBase::read() {
+    if (_rxPos == _rxLength && !fillRx()) {
+        return -1;
+    }
+    return _rx[_rxPos++];
+}
+
+/**
+ * @brief Serves staged bytes first, then reads the rest straight into buf.
+ */
+int BufferedClientBase::read(uint8_t* buf, size_t size) {
+    size_t staged = _rxLength - _rxPos;
+    if (staged > size) staged = size;
+    memcpy(buf, _rx + _rxPos, staged);
+    _rxPos += staged;
+
+    if (staged < size) {
+        int direct = _client.read(buf + staged, size - staged);
+        if (direct > 0) return staged + direct;
+    }
+    return staged > 0 ? (int)staged : -1;
+}
+
+int BufferedClientBase::peek() {
+    if (_rxPos == _rxLength && !fillRx()) {
+        return -1;
+    }
+    return _rx[_rxPos];
+}
+
+/**
+ * @brief Hands the staged bytes to the chip and keeps whatever it did not take.
+ * @details A short write leaves the unsent tail staged for the next flush(); if the
+ * connection is gone it also sets the write error, see getWriteError().
+ */
+void BufferedClientBase::flush() {
+    if (_txLength == 0) {
+        return;
+    }
+
+    size_t sent = _client.write(_tx, _txLength);
+    if (sent >= _txLength) {
+        _txLength = 0;
+        return;
+    }
+    memmove(_tx, _tx + sent, _txLength - sent);
+    _txLength -= sent;
+    if (!_client.connected()) {
+        setWriteError();
+    }
+}
+
+/**
+ * @brief Flushes, then closes; bytes the chip did not take are dropped.
+ */
+void BufferedClientBase::stop() {
+    flush();
+    _client.stop();
+    _txLength = 0;
+    _rxPos = _rxLength = 0;
+}
+
+uint8_t BufferedClientBase::connected() {
+    return (_rxPos < _rxLength) || _client.connected();
+}
+
+BufferedClientBase::operator bool() {
+    return (bool)_client;
+}
+
+int BufferedClientBase::txFree() {
+    return _client.availableForWrite();
+}
+
+int BufferedClientBase::rxAvailable() {
+    return _client.available();
+}
+
+/**
+ * @brief Refills the receive buffer with one bulk read from the chip.
+ */
+bool BufferedClientBase::fillRx() {
+    int got = _client.read(_rx, _rxSize);
+    _rxPos = 0;
+    _rxLength = (got > 0) ? (size_t)got : 0;
+    return _rxLength > 0;
+}
+
+} // namespace SimpleNet
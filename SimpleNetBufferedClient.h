@@ -0,0 +1,102 @@
+#ifndef SIMPLE_NET_BUFFERED_CLIENT_H
+#define SIMPLE_NET_BUFFERED_CLIENT_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include <Ethernet.h>
+
+namespace SimpleNet {
+
+/**
+ * @brief Size-independent part of BufferedClient; all logic lives here.
+ * @details Each EthernetClient::write() or read() call is its own SPI burst with
+ * register setup around it. This wrapper stages small writes in RAM and hands them
+ * to the chip in one burst when the buffer fills (or on flush()), and refills its
+ * receive buffer with one bulk read. Large writes and reads bypass the buffers.
+ */
+class BufferedClientBase : public Client {
+public:
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char* host, uint16_t port) override;
+    size_t write(uint8_t b) override;
+    size_t write(const uint8_t* buf, size_t size) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buf, size_t size) override;
+    int peek() override;
+
+    /**
+     * @brief Hands the staged bytes to the chip; any it does not take stay staged.
+     */
+    void flush() override;
+
+    /**
+     * @brief Flushes staged bytes, then closes the connection and drops what is left.
+     */
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override;
+
+    /**
+     * @brief Returns the free space in the chip's TX buffer for this socket.
+     * @details Writers can size a batch to this to avoid waiting inside write().
+     */
+    int txFree();
+
+    /**
+     * @brief Returns the number of received bytes still in the chip (not yet staged).
+     */
+    int rxAvailable();
+
+    /**
+     * @brief Returns the number of bytes staged for sending, including any a flush() could not hand over.
+     */
+    size_t txPending() const { return _txLength; }
+
+    /**
+     * @brief Returns the wrapped client.
+     */
+    EthernetClient& client() { return _client; }
+
+protected:
+    BufferedClientBase(EthernetClient& client, uint8_t* txBuffer, size_t txSize, uint8_t* rxBuffer, size_t rxSize);
+
+private:
+    EthernetClient& _client;
+    uint8_t*        _tx;
+    size_t          _txSize;
+    size_t          _txLength;
+    uint8_t*        _rx;
+    size_t          _rxSize;
+    size_t          _rxPos;
+    size_t          _rxLength;
+
+    bool fillRx();
+};
+
+/**
+ * @brief An EthernetClient wrapper with statically allocated staging buffers.
+ * @tparam TxSize Transmit staging buffer in bytes. Up to the socket buffer (2 KB) is useful.
+ * @tparam RxSize Receive staging buffer in bytes.
+ */
+template <size_t TxSize = 256, size_t RxSize = 64>
+class BufferedClient : public BufferedClientBase {
+    static_assert(TxSize > 0 && RxSize > 0, "BufferedClient buffers must not be empty");
+
+public:
+    /**
+     * @brief Wraps a client, e.g. netManager.getClient() or one from a ClientPool.
+     */
+    explicit BufferedClient(EthernetClient& client)
+        : BufferedClientBase(client, _txStorage, TxSize, _rxStorage, RxSize) {
+    }
+
+private:
+    uint8_t _txStorage[TxSize];
+    uint8_t _rxStorage[RxSize];
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_BUFFERED_CLIENT_H
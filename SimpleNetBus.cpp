@@ -0,0 +1,40 @@
+#include "SimpleNetBus.h"
+
+namespace SimpleNet {
+
+volatile uint8_t NetBusLock::_owner = NET_BUS_FREE;
+void (* volatile NetBusLock::_releaseHook)() = nullptr;
+
+bool NetBusLock::tryAcquire(uint8_t owner) {
+#if defined(__AVR__)
+    // No compare-and-swap instruction: mask interrupts for the few instructions
+    // of the test-and-set, restoring the previous state (this may run inside an ISR).
+    uint8_t sreg = SREG;
+    cli();
+    bool acquired = (_owner == NET_BUS_FREE);
+    if (acquired) _owner = owner;
+    SREG = sreg;
+    return acquired;
+#else
+    uint8_t expected = NET_BUS_FREE;
+    return __atomic_compare_exchange_n(&_owner, &expected, owner, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+#endif
+}
+
+void NetBusLock::release(uint8_t owner) {
+    if (_owner != owner) {
+        return;
+    }
+
+#if defined(__AVR__)
+    _owner = NET_BUS_FREE; // A single byte store is atomic.
+#else
+    __atomic_store_n(&_owner, NET_BUS_FREE, __ATOMIC_RELEASE);
+#endif
+    void (*hook)() = _releaseHook;
+    if (hook) {
+        hook();
+    }
+}
+
+} // namespace SimpleNet
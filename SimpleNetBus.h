@@ -0,0 +1,57 @@
+#ifndef SIMPLE_NET_BUS_H
+#define SIMPLE_NET_BUS_H
+
+#include <Arduino.h>
+
+namespace SimpleNet {
+
+/// Bus owner value meaning "free".
+static const uint8_t NET_BUS_FREE = 0;
+
+/// Bus owner used by SimpleNetManager::loop(); sketches pick their own values from 2 up.
+static const uint8_t NET_BUS_NETWORK = 1;
+
+/**
+ * @brief A one-byte ownership flag for sharing the SPI bus with interrupt-driven devices.
+ * @details Nobody ever waits for the flag. tryAcquire() either takes the bus or
+ * returns false at once, so it is safe to call from an interrupt handler; the
+ * caller defers its transfer instead. SimpleNetManager::loop() takes the flag for
+ * the whole tick and, if another owner holds it, skips the tick and tries again on
+ * the next call. Device code that samples from an ISR claims the flag around its
+ * transfer, sets a pending flag of its own when the claim fails, and finishes the
+ * transfer from the release hook.
+ *
+ * The flag only coordinates code that uses it: Ethernet calls the sketch makes
+ * outside loop() (for example through getClient()) should be wrapped in
+ * tryAcquire()/release() as well when an ISR shares the bus.
+ */
+class NetBusLock {
+public:
+    /**
+     * @brief Takes the bus for owner if it is free.
+     * @return false if another owner holds it.
+     */
+    static bool tryAcquire(uint8_t owner);
+
+    /**
+     * @brief Frees the bus if owner holds it, then runs the release hook.
+     */
+    static void release(uint8_t owner);
+
+    static uint8_t owner() { return _owner; }
+    static bool    isFree() { return _owner == NET_BUS_FREE; }
+
+    /**
+     * @brief Sets a function run after every release(), in the context of the
+     * caller of release(). Typically it completes a transfer an ISR had to defer.
+     */
+    static void setReleaseHook(void (*hook)()) { _releaseHook = hook; }
+
+private:
+    static volatile uint8_t _owner;
+    static void (* volatile _releaseHook)();
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_BUS_H
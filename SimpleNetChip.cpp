@@ -0,0 +1,310 @@
+#include "SimpleNetChip.h"
+
+namespace SimpleNet {
+
+// W5500 SPI frame: 16-bit address, control byte (block select << 3 | write << 2), data.
+static const uint8_t W5500_WRITE = 0x04;
+static const uint8_t W5500_COMMON = 0x00;
+static const uint8_t W5500_VERSIONR = 0x39;
+static const uint8_t W5500_VERSION = 0x04;
+static const uint8_t MR_RESET = 0x80;
+static const uint8_t PHYCFGR_LINK = 0x01;
+static const uint16_t W5500_SOCKET_BUFFER = 2048; ///< Sn_RXBUF_SIZE after reset; never changed here.
+
+// W5500 interrupt registers.
+static const uint8_t W5500_SIR = 0x17;
+static const uint8_t W5500_SIMR = 0x18;
+static const uint8_t W5500_SN_IMR = 0x2C;
+static const uint8_t SOCKET_EVENTS = SnIR::SEND_OK | SnIR::TIMEOUT | SnIR::RECV | SnIR::DISCON | SnIR::CON;
+
+/// Block select of socket s: its registers, TX buffer (+ 1) or RX buffer (+ 2).
+static uint8_t socketBlock(uint8_t s, uint8_t block) {
+    return (uint8_t)(((s << 2) | (block + 1)) << 3);
+}
+
+static NetChip libraryChip; // Constant-initialised, so usable from other constructors.
+
+NetChip& NetChip::library() {
+    return libraryChip;
+}
+
+bool NetChip::reset() {
+    if (isLibrary()) {
+        return true;
+    }
+
+    pinMode(_csPin, OUTPUT);
+    digitalWrite(_csPin, HIGH);
+    SPI.begin();
+
+    SPI.beginTransaction(NetSpi::settings());
+    writeCommon(0, MR_RESET);
+    for (uint8_t i = 0; i < 20 && (readCommon(0) & MR_RESET); i++) {
+        delay(1);
+    }
+    bool found = readCommon(W5500_VERSIONR) == W5500_VERSION;
+    SPI.endTransaction();
+    return found;
+}
+
+uint8_t NetChip::type() const {
+    return isLibrary() ? W5100.getChip() : 55;
+}
+
+uint8_t NetChip::maxSockets() const {
+    uint8_t count = (type() == 51) ? 4 : 8;
+    return count < MAX_SOCK_NUM ? count : MAX_SOCK_NUM;
+}
+
+uint16_t NetChip::rxBufferSize() const {
+    return isLibrary() ? W5100.SSIZE : W5500_SOCKET_BUFFER;
+}
+
+void NetChip::setMac(const uint8_t mac[6]) {
+    SPI.beginTransaction(NetSpi::settings());
+    writeCommon(NET_SHAR, mac, 6);
+    SPI.endTransaction();
+}
+
+void NetChip::setAddresses(IPAddress ip, IPAddress subnet, IPAddress gateway) {
+    uint8_t address[8] = { gateway[0], gateway[1], gateway[2], gateway[3],
+                            subnet[0], subnet[1], subnet[2], subnet[3] };
+    uint8_t local[4] = { ip[0], ip[1], ip[2], ip[3] };
+    SPI.beginTransaction(NetSpi::settings());
+    writeCommon(NET_GAR, address, 8);
+    writeCommon(NET_SIPR, local, 4);
+    SPI.endTransaction();
+}
+
+IPAddress NetChip::gateway() {
+    uint8_t address[4];
+    SPI.beginTransaction(NetSpi::settings());
+    readCommon(NET_GAR, address, 4);
+    SPI.endTransaction();
+    return IPAddress(address[0], address[1], address[2], address[3]);
+}
+
+bool NetChip::linkUp() {
+    if (isLibrary()) {
+        return Ethernet.linkStatus() == LinkON;
+    }
+
+    SPI.beginTransaction(NetSpi::settings());
+    bool up = readCommon(NET_PHYCFGR) & PHYCFGR_LINK;
+    SPI.endTransaction();
+    return up;
+}
+
+void NetChip::readCommon(uint16_t reg, uint8_t* buf, uint16_t len) {
+    if (isLibrary()) {
+        W5100.read(reg, buf, len);
+    } else {
+        frame(reg, W5500_COMMON, buf, nullptr, len);
+    }
+}
+
+void NetChip::writeCommon(uint16_t reg, const uint8_t* buf, uint16_t len) {
+    if (isLibrary()) {
+        W5100.write(reg, buf, len);
+    } else {
+        frame(reg, W5500_COMMON | W5500_WRITE, nullptr, buf, len);
+    }
+}
+
+uint8_t NetChip::readCommon(uint16_t reg) {
+    uint8_t value;
+    readCommon(reg, &value, 1);
+    return value;
+}
+
+void NetChip::writeCommon(uint16_t reg, uint8_t value) {
+    writeCommon(reg, &value, 1);
+}
+
+void NetChip::readSn(uint8_t s, uint8_t reg, uint8_t* buf, uint16_t len) {
+    if (isLibrary()) {
+        W5100.read(socketBase(s) + reg, buf, len);
+    } else {
+        frame(reg, socketBlock(s, 0), buf, nullptr, len);
+    }
+}
+
+void NetChip::writeSn(uint8_t s, uint8_t reg, const uint8_t* buf, uint16_t len) {
+    if (isLibrary()) {
+        W5100.write(socketBase(s) + reg, buf, len);
+    } else {
+        frame(reg, socketBlock(s, 0) | W5500_WRITE, nullptr, buf, len);
+    }
+}
+
+uint8_t NetChip::readSn(uint8_t s, uint8_t reg) {
+    uint8_t value;
+    readSn(s, reg, &value, 1);
+    return value;
+}
+
+void NetChip::writeSn(uint8_t s, uint8_t reg, uint8_t value) {
+    writeSn(s, reg, &value, 1);
+}
+
+uint16_t NetChip::readSn16(uint8_t s, uint8_t reg) {
+    uint8_t value[2];
+    readSn(s, reg, value, 2);
+    return ((uint16_t)value[0] << 8) | value[1];
+}
+
+void NetChip::writeSn16(uint8_t s, uint8_t reg, uint16_t value) {
+    uint8_t bytes[2] = { (uint8_t)(value >> 8), (uint8_t)value };
+    writeSn(s, reg, bytes, 2);
+}
+
+void NetChip::command(uint8_t s, uint8_t cmd) {
+    if (isLibrary()) {
+        W5100.execCmdSn(s, (SockCMD)cmd);
+        return;
+    }
+
+    writeSn(s, NET_SN_CR, cmd);
+    while (readSn(s, NET_SN_CR)) {
+        // The chip clears CR once it has taken the command.
+    }
+}
+
+void NetChip::writeTx(uint8_t s, uint16_t ptr, const uint8_t* data, uint16_t len) {
+    if (!isLibrary()) {
+        frame(ptr, socketBlock(s, 1) | W5500_WRITE, nullptr, data, len); // The W5500 wraps by itself.
+        return;
+    }
+
+    uint16_t offset = ptr & W5100.SMASK;
+    uint16_t dst = W5100.SBASE(s) + offset;
+    if (W5100.hasOffsetAddressMapping() || offset + len <= W5100.SSIZE) {
+        W5100.write(dst, data, len);
+    } else {
+        uint16_t first = W5100.SSIZE - offset;
+        W5100.write(dst, data, first);
+        W5100.write(W5100.SBASE(s), data + first, len - first);
+    }
+}
+
+void NetChip::readRx(uint8_t s, uint16_t ptr, uint8_t* data, uint16_t len) {
+    if (!isLibrary()) {
+        frame(ptr, socketBlock(s, 2), data, nullptr, len);
+        return;
+    }
+
+    uint16_t offset = ptr & W5100.SMASK;
+    uint16_t src = W5100.RBASE(s) + offset;
+    if (W5100.hasOffsetAddressMapping() || offset + len <= W5100.SSIZE) {
+        W5100.read(src, data, len);
+    } else {
+        uint16_t first = W5100.SSIZE - offset;
+        W5100.read(src, data, first);
+        W5100.read(W5100.RBASE(s), data + first, len - first);
+    }
+}
+
+void NetChip::pinGateway(IPAddress localIp, IPAddress subnet, IPAddress gateway, const uint8_t mac[6]) {
+    _pinMask = subnet;
+    _pinNetwork = (uint32_t)localIp & _pinMask;
+    _pinGateway = gateway;
+    memcpy(_pinMac, mac, 6);
+}
+
+const uint8_t* NetChip::pinnedMac(IPAddress ip) const {
+    // Datagrams for another subnet (or the gateway itself) go to the pinned MAC.
+    uint32_t destination = ip;
+    bool routed = _pinGateway != 0 && destination != 0xFFFFFFFFUL && (ip[0] & 0xF0) != 0xE0
+                  && ((destination & _pinMask) != _pinNetwork || destination == _pinGateway);
+    return routed ? _pinMac : nullptr;
+}
+
+bool NetChip::enableInterrupts(bool enabled) {
+    _interrupts = enabled && type() == 55;
+    if (type() != 55) {
+        return !enabled;
+    }
+
+    SPI.beginTransaction(NetSpi::settings());
+    for (uint8_t s = 0; s < 8; s++) {
+        // Anything may have happened while the sockets were polled; check each once.
+        _flags[s] = SnIR::RECV | NET_SN_IR_STATUS;
+        if (_openSockets & (1 << s)) writeSn(s, W5500_SN_IMR, SOCKET_EVENTS);
+    }
+    writeCommon(W5500_SIMR, _interrupts ? _openSockets : 0);
+    SPI.endTransaction();
+    return true;
+}
+
+void NetChip::serviceInterrupts() {
+    if (!_interrupts) {
+        return;
+    }
+
+    SPI.beginTransaction(NetSpi::settings());
+    uint8_t sockets = readCommon(W5500_SIR) & _openSockets;
+    for (uint8_t s = 0; sockets; s++, sockets >>= 1) {
+        if (!(sockets & 1)) continue;
+
+        uint8_t flags = readSn(s, NET_SN_IR) & SOCKET_EVENTS;
+        writeSn(s, NET_SN_IR, flags);
+        if (flags & (SnIR::CON | SnIR::DISCON | SnIR::TIMEOUT)) flags |= NET_SN_IR_STATUS;
+        _flags[s] |= flags;
+    }
+    SPI.endTransaction();
+}
+
+uint8_t NetChip::takeFlags(uint8_t s, uint8_t mask) {
+    uint8_t flags;
+    if (_interrupts) {
+        flags = _flags[s] & mask;
+        _flags[s] &= ~mask;
+    } else {
+        flags = readSn(s, NET_SN_IR) & mask;
+        if (flags) writeSn(s, NET_SN_IR, flags);
+    }
+    return flags;
+}
+
+void NetChip::socketOpened(uint8_t s) {
+    _openSockets |= 1 << s;
+    _flags[s] = SnIR::RECV | NET_SN_IR_STATUS;
+    if (_interrupts) {
+        writeSn(s, W5500_SN_IMR, SOCKET_EVENTS);
+        writeCommon(W5500_SIMR, _openSockets);
+    }
+}
+
+void NetChip::socketClosed(uint8_t s) {
+    _openSockets &= ~(1 << s);
+    _flags[s] = 0;
+    if (_interrupts) {
+        writeCommon(W5500_SIMR, _openSockets);
+    }
+}
+
+/**
+ * @brief Private method for one W5500 frame on the chip's own select line.
+ */
+void NetChip::frame(uint16_t address, uint8_t control, uint8_t* in, const uint8_t* out, uint16_t len) {
+    digitalWrite(_csPin, LOW);
+    SPI.transfer(address >> 8);
+    SPI.transfer(address & 0xFF);
+    SPI.transfer(control);
+    for (uint16_t i = 0; i < len; i++) {
+        uint8_t value = SPI.transfer(out ? out[i] : 0);
+        if (in) in[i] = value;
+    }
+    digitalWrite(_csPin, HIGH);
+}
+
+/**
+ * @brief Private method for the library chip's address of socket s's registers.
+ */
+uint16_t NetChip::socketBase(uint8_t s) const {
+    uint8_t chip = W5100.getChip();
+    uint16_t base = (chip == 55) ? 0x1000 : (chip == 52) ? 0x4000 : 0x0400;
+    return base + s * 0x100;
+}
+
+} // namespace SimpleNet
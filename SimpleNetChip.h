@@ -0,0 +1,199 @@
+#ifndef SIMPLE_NET_CHIP_H
+#define SIMPLE_NET_CHIP_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <Ethernet.h>
+#include <utility/w5100.h>
+#include "SimpleNetSpi.h"
+
+namespace SimpleNet {
+
+/// CS pin value that selects the chip the Ethernet library drives.
+static const uint8_t NET_CHIP_LIBRARY = 0xFF;
+
+// Socket register offsets; the same on the W5100, W5200 and W5500.
+static const uint8_t NET_SN_MR = 0x00;
+static const uint8_t NET_SN_CR = 0x01;
+static const uint8_t NET_SN_IR = 0x02;
+static const uint8_t NET_SN_SR = 0x03;
+static const uint8_t NET_SN_PORT = 0x04;
+static const uint8_t NET_SN_DHAR = 0x06;
+static const uint8_t NET_SN_DIPR = 0x0C;
+static const uint8_t NET_SN_DPORT = 0x10;
+static const uint8_t NET_SN_PROTO = 0x14;
+static const uint8_t NET_SN_TX_FSR = 0x20;
+static const uint8_t NET_SN_TX_WR = 0x24;
+static const uint8_t NET_SN_RX_RSR = 0x26;
+static const uint8_t NET_SN_RX_RD = 0x28;
+
+// Common register offsets used here.
+static const uint8_t NET_GAR = 0x01;
+static const uint8_t NET_SUBR = 0x05;
+static const uint8_t NET_SHAR = 0x09;
+static const uint8_t NET_SIPR = 0x0F;
+static const uint8_t NET_PHYCFGR = 0x2E; ///< W5500 only.
+
+/// Latched socket flag that marks a possible status change (CON, DISCON or TIMEOUT seen).
+static const uint8_t NET_SN_IR_STATUS = 0x80;
+
+/**
+ * @brief One W5x00 chip: its registers, socket buffers and the state tied to it.
+ * @details The Ethernet library drives a single chip through global state, so a
+ * second chip cannot go through it. A NetChip is either that library chip, reached
+ * through W5100.read()/write(), or a W5500 on its own chip select pin, framed
+ * directly on the SPI bus. NetSocket, NetPhy and the manager take their chip from
+ * here, so two managers can each run a chip of their own.
+ *
+ * The register and buffer calls expect the caller's SPI transaction; reset(),
+ * setMac(), setAddresses(), gateway(), linkUp(), enableInterrupts() and
+ * serviceInterrupts() begin their own.
+ */
+class NetChip {
+public:
+    /**
+     * @brief The library chip, or the W5500 whose chip select is on csPin.
+     */
+    constexpr explicit NetChip(uint8_t csPin = NET_CHIP_LIBRARY)
+        : _csPin(csPin), _pinNetwork(0), _pinMask(0), _pinGateway(0), _pinMac{0, 0, 0, 0, 0, 0},
+          _interrupts(false), _openSockets(0), _flags{0, 0, 0, 0, 0, 0, 0, 0} {}
+
+    /**
+     * @brief Returns the chip the Ethernet library drives; sockets use it by default.
+     */
+    static NetChip& library();
+
+    void    setCsPin(uint8_t csPin) { _csPin = csPin; }
+    uint8_t csPin() const { return _csPin; }
+    bool    isLibrary() const { return _csPin == NET_CHIP_LIBRARY; }
+
+    /**
+     * @brief Soft-resets a W5500 on its own pin and checks its version register.
+     * @details The library chip is reset by Ethernet.begin(); this returns true for it.
+     */
+    bool reset();
+
+    /**
+     * @brief Returns 51, 52 or 55 for the W5100, W5200 or W5500; 55 for a chip on its own pin.
+     */
+    uint8_t type() const;
+
+    /**
+     * @brief Returns the number of hardware sockets the chip provides.
+     */
+    uint8_t maxSockets() const;
+
+    /**
+     * @brief Returns the RX buffer size of each socket: the library's setting for the
+     * library chip, the W5500's 2 KB reset default for a chip on its own pin.
+     */
+    uint16_t rxBufferSize() const;
+
+    void setMac(const uint8_t mac[6]);
+    void setAddresses(IPAddress ip, IPAddress subnet, IPAddress gateway);
+    IPAddress gateway();
+
+    /**
+     * @brief Reads the link bit of the W5500's PHYCFGR.
+     */
+    bool linkUp();
+
+    void    readCommon(uint16_t reg, uint8_t* buf, uint16_t len);
+    void    writeCommon(uint16_t reg, const uint8_t* buf, uint16_t len);
+    uint8_t readCommon(uint16_t reg);
+    void    writeCommon(uint16_t reg, uint8_t value);
+
+    void     readSn(uint8_t s, uint8_t reg, uint8_t* buf, uint16_t len);
+    void     writeSn(uint8_t s, uint8_t reg, const uint8_t* buf, uint16_t len);
+    uint8_t  readSn(uint8_t s, uint8_t reg);
+    void     writeSn(uint8_t s, uint8_t reg, uint8_t value);
+    uint16_t readSn16(uint8_t s, uint8_t reg);
+    void     writeSn16(uint8_t s, uint8_t reg, uint16_t value);
+
+    /**
+     * @brief Writes a socket command and waits for the chip to take it (a few microseconds).
+     */
+    void command(uint8_t s, uint8_t cmd);
+
+    /**
+     * @brief Copies data into a socket's circular TX buffer at ptr.
+     */
+    void writeTx(uint8_t s, uint16_t ptr, const uint8_t* data, uint16_t len);
+
+    /**
+     * @brief Copies data out of a socket's circular RX buffer at ptr.
+     */
+    void readRx(uint8_t s, uint16_t ptr, uint8_t* data, uint16_t len);
+
+    /**
+     * @brief Pins the gateway's MAC address for UDP datagrams that leave the subnet.
+     * @details The chip keeps no ARP cache: each socket resolves the next hop again
+     * after it is opened, which delays its first datagram by an ARP round trip. With
+     * a pinned MAC those datagrams go out at once (SEND_MAC). Broadcast and multicast
+     * destinations are unaffected. The pin holds until unpinGateway().
+     */
+    void pinGateway(IPAddress localIp, IPAddress subnet, IPAddress gateway, const uint8_t mac[6]);
+    void unpinGateway() { _pinGateway = 0; }
+
+    /**
+     * @brief Returns the pinned gateway MAC to use for ip, or nullptr to resolve it by ARP.
+     */
+    const uint8_t* pinnedMac(IPAddress ip) const;
+
+    /**
+     * @brief Takes socket events from the INTn line instead of reading each socket's registers.
+     * @details W5500 only. The chip raises INTn for the sockets NetSocket has open;
+     * serviceInterrupts() reads which ones and latches their flags. Until the next
+     * event, a socket's status(), rxAvailable() and sendComplete() then answer
+     * without an SPI transfer. Sockets of the Ethernet library are left alone.
+     * Call again after the chip has been reset.
+     * @return false if the chip has no INTn support; socket registers are then polled.
+     */
+    bool enableInterrupts(bool enabled);
+    bool interruptsEnabled() const { return _interrupts; }
+
+    /**
+     * @brief Reads the socket interrupt register once and latches and clears the
+     * flags of each socket it names, which releases INTn.
+     */
+    void serviceInterrupts();
+
+    /**
+     * @brief Returns true if any flag in mask is latched for socket s; always true without interrupts.
+     */
+    bool hasFlags(uint8_t s, uint8_t mask) const { return !_interrupts || (_flags[s] & mask); }
+    void clearFlags(uint8_t s, uint8_t mask) { _flags[s] &= ~mask; }
+
+    /**
+     * @brief Returns and clears socket s's flags in mask (SnIR bits, NET_SN_IR_STATUS).
+     * @details With interrupts these are the latched flags and no transfer is made;
+     * otherwise Sn_IR is read and the flags found are cleared there.
+     */
+    uint8_t takeFlags(uint8_t s, uint8_t mask);
+
+    /**
+     * @brief Called by NetSocket when it opens or closes hardware socket s.
+     */
+    void socketOpened(uint8_t s);
+    void socketClosed(uint8_t s);
+
+private:
+    uint8_t  _csPin;
+
+    // The gateway MAC pinned by pinGateway(); a zero gateway means none.
+    uint32_t _pinNetwork;
+    uint32_t _pinMask;
+    uint32_t _pinGateway;
+    uint8_t  _pinMac[6];
+
+    bool     _interrupts;
+    uint8_t  _openSockets;  ///< Sockets NetSocket holds; only these raise INTn.
+    uint8_t  _flags[8];     ///< Latched Sn_IR flags of each socket, see takeFlags().
+
+    void frame(uint16_t address, uint8_t control, uint8_t* in, const uint8_t* out, uint16_t len);
+    uint16_t socketBase(uint8_t s) const;
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_CHIP_H
@@ -0,0 +1,158 @@
+#include "SimpleNetClientPool.h"
+
+namespace SimpleNet {
+
+ClientPoolBase::ClientPoolBase(SimpleNetManagerBase& manager, PooledClient* slots, uint8_t capacity)
+    : NetService(manager), _manager(manager), _slots(slots), _capacity(capacity), _connectTimeout(1000) {
+    // Slots are not constructed yet; only remember where they live.
+}
+
+/**
+ * @brief Reuses an idle connection to host:port, or opens a new one once the name is cached.
+ */
+EthernetClient* ClientPoolBase::acquire(const char* host, uint16_t port) {
+    if (!_manager.isConnected() || host == nullptr || strlen(host) >= SIMPLE_NET_POOL_HOST_LEN) {
+        return nullptr;
+    }
+
+    PooledClient* slot = find(host, IPAddress(0, 0, 0, 0), port);
+    if (slot) {
+        return checkOut(slot);
+    }
+
+    // A cached name is answered from inside resolve(); otherwise the lookup runs
+    // from loop() and fills the cache for a later call.
+    _resolved = IPAddress(0, 0, 0, 0);
+    if (!_manager.resolve(host, onResolved, this) || _resolved == IPAddress(0, 0, 0, 0)) {
+        return nullptr;
+    }
+
+    slot = claim();
+    if (!slot || !connect(slot, _resolved, port)) {
+        return nullptr;
+    }
+    strcpy(slot->host, host);
+    return checkOut(slot);
+}
+
+/**
+ * @brief Reuses an idle connection to ip:port or opens a new one.
+ */
+EthernetClient* ClientPoolBase::acquire(IPAddress ip, uint16_t port) {
+    if (!_manager.isConnected()) {
+        return nullptr;
+    }
+
+    PooledClient* slot = find(nullptr, ip, port);
+    if (slot) {
+        return checkOut(slot);
+    }
+
+    slot = claim();
+    if (!slot || !connect(slot, ip, port)) {
+        return nullptr;
+    }
+    slot->host[0] = '\0';
+    return checkOut(slot);
+}
+
+/**
+ * @brief Marks a connection idle, or closes it when asked to.
+ */
+void ClientPoolBase::release(EthernetClient* client, bool close) {
+    for (uint8_t i = 0; i < _capacity; i++) {
+        PooledClient& slot = _slots[i];
+        if (&slot.client == client) {
+            if (close) {
+                slot.client.stop();
+                slot.port = 0;
+            }
+            slot.inUse = false;
+            slot.lastUsed = millis();
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Closes all connections. Called by the manager when it leaves NET_CONNECTED.
+ */
+void ClientPoolBase::invalidate() {
+    for (uint8_t i = 0; i < _capacity; i++) {
+        _slots[i].client.stop();
+        _slots[i].inUse = false;
+        _slots[i].port = 0;
+    }
+}
+
+uint8_t ClientPoolBase::inUseCount() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < _capacity; i++) {
+        if (_slots[i].inUse) count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Finds an idle, still-open connection to the endpoint.
+ * @details Idle connections the peer has closed in the meantime are reclaimed here.
+ */
+PooledClient* ClientPoolBase::find(const char* host, IPAddress ip, uint16_t port) {
+    for (uint8_t i = 0; i < _capacity; i++) {
+        PooledClient& slot = _slots[i];
+        if (slot.inUse || slot.port != port) continue;
+
+        bool sameEndpoint = host ? (strcmp(slot.host, host) == 0) : (slot.host[0] == '\0' && slot.ip == ip);
+        if (!sameEndpoint) continue;
+
+        if (slot.client.connected()) {
+            return &slot;
+        }
+        slot.client.stop();
+        slot.port = 0;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Picks a free slot, closing the least recently used idle connection if needed.
+ */
+PooledClient* ClientPoolBase::claim() {
+    PooledClient* oldest = nullptr;
+    for (uint8_t i = 0; i < _capacity; i++) {
+        PooledClient& slot = _slots[i];
+        if (slot.inUse) continue;
+        if (slot.port == 0) return &slot;
+        if (!oldest || (long)(slot.lastUsed - oldest->lastUsed) < 0) oldest = &slot;
+    }
+    if (oldest) {
+        oldest->client.stop();
+        oldest->port = 0;
+    }
+    return oldest;
+}
+
+/**
+ * @brief Private method to open a claimed slot; waits for the TCP handshake.
+ */
+bool ClientPoolBase::connect(PooledClient* slot, IPAddress ip, uint16_t port) {
+    slot->client.setConnectionTimeout(_connectTimeout);
+    if (!slot->client.connect(ip, port)) {
+        return false;
+    }
+    slot->ip = ip;
+    slot->port = port;
+    return true;
+}
+
+EthernetClient* ClientPoolBase::checkOut(PooledClient* slot) {
+    slot->inUse = true;
+    slot->lastUsed = millis();
+    return &slot->client;
+}
+
+void ClientPoolBase::onResolved(IPAddress ip, void* context) {
+    static_cast<ClientPoolBase*>(context)->_resolved = ip;
+}
+
+} // namespace SimpleNet
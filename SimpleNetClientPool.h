@@ -0,0 +1,117 @@
+#ifndef SIMPLE_NET_CLIENT_POOL_H
+#define SIMPLE_NET_CLIENT_POOL_H
+
+#include <Arduino.h>
+#include <Ethernet.h>
+#include "SimpleNetManager.h"
+
+#ifndef SIMPLE_NET_POOL_HOST_LEN
+#define SIMPLE_NET_POOL_HOST_LEN 32 ///< Longest hostname (including terminator) a pool slot remembers.
+#endif
+
+namespace SimpleNet {
+
+/**
+ * @brief One pooled connection and the endpoint it belongs to.
+ */
+struct PooledClient {
+    EthernetClient client;
+    char           host[SIMPLE_NET_POOL_HOST_LEN];
+    IPAddress      ip;
+    uint16_t       port;
+    bool           inUse;
+    unsigned long  lastUsed;
+
+    PooledClient() : port(0), inUse(false), lastUsed(0) { host[0] = '\0'; }
+};
+
+/**
+ * @brief Size-independent part of ClientPool; all logic lives here.
+ * @details Connections are keyed by host:port (or ip:port). A released connection
+ * stays open and is handed out again by the next acquire() for the same endpoint,
+ * saving a TCP handshake. When every slot is taken, the least recently used idle
+ * one is closed and reused. All slots are closed when the manager leaves NET_CONNECTED.
+ */
+class ClientPoolBase : public NetService {
+public:
+    /**
+     * @brief Returns an open connection to host:port, connecting if needed.
+     * @details The name is resolved through the manager's DNS cache, never by a
+     * blocking lookup. While it is not cached, this starts the lookup and returns
+     * nullptr; call again on a later loop(). A new connection then blocks for the
+     * TCP handshake, as acquire(IPAddress, uint16_t) does.
+     * @return nullptr if not connected to the network, the name is not resolved yet,
+     * no slot is free or the connect failed.
+     */
+    EthernetClient* acquire(const char* host, uint16_t port);
+
+    /**
+     * @brief Returns an open connection to ip:port, connecting if needed.
+     * @details Reusing an idle connection is immediate. A new one is opened with
+     * EthernetClient::connect(), which waits for the TCP handshake: up to the
+     * connection timeout (see setConnectionTimeout()) for a host that does not answer.
+     */
+    EthernetClient* acquire(IPAddress ip, uint16_t port);
+
+    /**
+     * @brief Bounds how long acquire() waits for a new connection's handshake (default 1,000 ms).
+     */
+    void setConnectionTimeout(uint16_t timeout) { _connectTimeout = timeout; }
+
+    /**
+     * @brief Hands a connection back to the pool. It stays open for reuse.
+     * @param close Close the connection instead of keeping it idle.
+     */
+    void release(EthernetClient* client, bool close = false);
+
+    /**
+     * @brief Closes every pooled connection, in use or not.
+     */
+    void invalidate();
+
+    uint8_t capacity() const { return _capacity; }
+    uint8_t inUseCount() const;
+
+protected:
+    ClientPoolBase(SimpleNetManagerBase& manager, PooledClient* slots, uint8_t capacity);
+
+    void networkDown() override { invalidate(); }
+
+private:
+    SimpleNetManagerBase& _manager;
+    PooledClient*         _slots;
+    uint8_t               _capacity;
+    uint16_t              _connectTimeout;
+    IPAddress             _resolved;   ///< Set by onResolved() when a name is answered from the cache.
+
+    PooledClient* find(const char* host, IPAddress ip, uint16_t port);
+    PooledClient* claim();
+    bool connect(PooledClient* slot, IPAddress ip, uint16_t port);
+    EthernetClient* checkOut(PooledClient* slot);
+    static void onResolved(IPAddress ip, void* context);
+};
+
+/**
+ * @brief A statically allocated pool of up to MAX_SOCK_NUM TCP connections.
+ * @tparam N Number of pooled sockets. Leave hardware sockets free for DHCP and UDP users.
+ */
+template <uint8_t N>
+class ClientPool : public ClientPoolBase {
+    static_assert(N > 0 && N <= MAX_SOCK_NUM, "ClientPool size must fit the chip's hardware sockets");
+
+public:
+    /**
+     * @brief Creates the pool and attaches it to the manager's connection state.
+     * @param manager The manager whose disconnects should invalidate this pool.
+     */
+    explicit ClientPool(SimpleNetManagerBase& manager)
+        : ClientPoolBase(manager, _storage, N) {
+    }
+
+private:
+    PooledClient _storage[N];
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_CLIENT_POOL_H
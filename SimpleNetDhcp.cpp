@@ -0,0 +1,452 @@
+#include "SimpleNetDhcp.h"
+
+namespace SimpleNet {
+
+// --- Protocol Constants (RFC 2131 / RFC 2132) ---
+static const uint16_t DHCP_CLIENT_PORT = 68;
+static const uint16_t DHCP_SERVER_PORT = 67;
+
+static const uint8_t MSG_DISCOVER = 1;
+static const uint8_t MSG_OFFER    = 2;
+static const uint8_t MSG_REQUEST  = 3;
+static const uint8_t MSG_ACK      = 5;
+static const uint8_t MSG_NAK      = 6;
+
+static const uint8_t OPT_PAD           = 0;
+static const uint8_t OPT_SUBNET_MASK   = 1;
+static const uint8_t OPT_ROUTER        = 3;
+static const uint8_t OPT_DNS_SERVER    = 6;
+static const uint8_t OPT_REQUESTED_IP  = 50;
+static const uint8_t OPT_LEASE_TIME    = 51;
+static const uint8_t OPT_MESSAGE_TYPE  = 53;
+static const uint8_t OPT_SERVER_ID     = 54;
+static const uint8_t OPT_PARAM_REQUEST = 55;
+static const uint8_t OPT_T1            = 58;
+static const uint8_t OPT_T2            = 59;
+static const uint8_t OPT_CLIENT_ID     = 61;
+static const uint8_t OPT_END           = 255;
+
+static const uint16_t MIN_MESSAGE_SIZE  = 300; // BOOTP minimum; some servers drop shorter packets.
+static const uint16_t COOKIE_OFFSET     = 236;
+static const unsigned long RETRANSMIT_START = 4000;
+static const unsigned long RETRANSMIT_MAX   = 32000;
+static const uint8_t MAX_REQUEST_TRIES  = 4;
+static const uint8_t MAX_REBOOT_TRIES   = 2; // Then fall back to DISCOVER.
+
+// Longest lease honoured, in seconds. Keeps all lease arithmetic well inside
+// the 49-day millis() wrap; longer (or infinite) leases are simply renewed early.
+static const unsigned long MAX_LEASE_SECONDS = 24UL * 24UL * 3600UL;
+
+static uint32_t readUint32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+DhcpClient::DhcpClient() {
+    memset(_mac, 0, sizeof(_mac));
+    _state = DHCP_IDLE;
+    _xid = 0;
+    _rng = 0;
+    _timeout = 0;
+    _attemptStart = 0;
+    _lastSend = 0;
+    _retransmit = RETRANSMIT_START;
+    _requestTries = 0;
+    _leaseStart = 0;
+    _leaseTime = 0;
+    _t1 = 0;
+    _t2 = 0;
+}
+
+/**
+ * @brief Resets the client and queues a DISCOVER, or a REQUEST for the remembered
+ * address, for the next step().
+ */
+bool DhcpClient::start(const byte mac[], unsigned long timeout, const DhcpLease* remembered) {
+    stop();
+    memcpy(_mac, mac, 6);
+    _timeout = timeout;
+    _attemptStart = millis();
+
+    _xid = nextXid();
+
+    if (!openSocket()) {
+        _state = DHCP_FAILED;
+        return false;
+    }
+    _state = DHCP_INIT;
+
+    if (remembered) {
+        // Sent from here rather than step(): the REQUEST is out one tick sooner.
+        _localIp = IPAddress(remembered->localIp);
+        _state = DHCP_REBOOTING;
+        send(MSG_REQUEST);
+        markSent(_attemptStart, true);
+        _requestTries = 1;
+    }
+    return true;
+}
+
+/**
+ * @brief Runs at most one send and one receive of the acquisition exchange.
+ */
+DhcpState DhcpClient::step() {
+    unsigned long now = millis();
+    Reply reply;
+
+    switch (_state) {
+        case DHCP_INIT:
+            send(MSG_DISCOVER);
+            markSent(now, true);
+            _state = DHCP_SELECTING;
+            break;
+
+        case DHCP_SELECTING:
+            if (receive(reply) == MSG_OFFER) {
+                accept(reply);
+                send(MSG_REQUEST);
+                markSent(now, true);
+                _requestTries = 1;
+                _state = DHCP_REQUESTING;
+            } else if (retransmitDue(now)) {
+                send(MSG_DISCOVER);
+                markSent(now, false);
+            }
+            break;
+
+        case DHCP_REQUESTING:
+            switch (receive(reply)) {
+                case MSG_ACK:
+                    accept(reply);
+                    bind(now);
+                    return _state;
+                case MSG_NAK:
+                    _state = DHCP_INIT;
+                    break;
+                default:
+                    if (retransmitDue(now)) {
+                        if (_requestTries >= MAX_REQUEST_TRIES) {
+                            _state = DHCP_INIT; // The offer went stale; start over.
+                        } else {
+                            send(MSG_REQUEST);
+                            markSent(now, false);
+                            _requestTries++;
+                        }
+                    }
+                    break;
+            }
+            break;
+
+        case DHCP_REBOOTING:
+            switch (receive(reply)) {
+                case MSG_ACK:
+                    accept(reply);
+                    bind(now);
+                    return _state;
+                case MSG_NAK:
+                    // The address is no longer ours (other subnet, or reassigned).
+                    _localIp = IPAddress(0, 0, 0, 0);
+                    _state = DHCP_INIT;
+                    break;
+                default:
+                    if (retransmitDue(now)) {
+                        if (_requestTries >= MAX_REBOOT_TRIES) {
+                            _localIp = IPAddress(0, 0, 0, 0);
+                            _state = DHCP_INIT;
+                        } else {
+                            send(MSG_REQUEST);
+                            markSent(now, true);
+                            _requestTries++;
+                        }
+                    }
+                    break;
+            }
+            break;
+
+        default:
+            return _state;
+    }
+
+    if (now - _attemptStart >= _timeout) {
+        stop();
+        _state = DHCP_FAILED;
+    }
+    return _state;
+}
+
+/**
+ * @brief Moves through BOUND, RENEWING and REBINDING as the lease timers expire.
+ */
+DhcpLeaseEvent DhcpClient::maintain() {
+    if (_state != DHCP_BOUND && _state != DHCP_RENEWING && _state != DHCP_REBINDING) {
+        return DHCP_LEASE_NONE;
+    }
+
+    unsigned long now = millis();
+    unsigned long elapsed = (now - _leaseStart) / 1000UL;
+
+    if (elapsed >= _leaseTime) {
+        stop();
+        return DHCP_LEASE_LOST;
+    }
+
+    if (_state == DHCP_BOUND) {
+        if (elapsed < _t1 || !openSocket()) {
+            return DHCP_LEASE_NONE;
+        }
+        _xid++;
+        _state = DHCP_RENEWING;
+        send(MSG_REQUEST);
+        markSent(now, true);
+        return DHCP_LEASE_NONE;
+    }
+
+    if (_state == DHCP_RENEWING && elapsed >= _t2) {
+        _state = DHCP_REBINDING;
+        _lastSend = now - _retransmit; // Send the rebinding request right away.
+    }
+
+    Reply reply;
+    switch (receive(reply)) {
+        case MSG_ACK: {
+            bool renewed = (_state == DHCP_RENEWING);
+            accept(reply);
+            bind(now);
+            return renewed ? DHCP_LEASE_RENEWED : DHCP_LEASE_REBOUND;
+        }
+        case MSG_NAK:
+            stop();
+            return DHCP_LEASE_LOST;
+        default:
+            if (retransmitDue(now)) {
+                send(MSG_REQUEST);
+                markSent(now, false);
+            }
+            return DHCP_LEASE_NONE;
+    }
+}
+
+/**
+ * @brief Drops all state and closes the UDP socket.
+ */
+void DhcpClient::stop() {
+    _udp.close();
+    _state = DHCP_IDLE;
+    _localIp = IPAddress(0, 0, 0, 0);
+    _serverId = IPAddress(0, 0, 0, 0);
+}
+
+void DhcpClient::getLease(DhcpLease& lease) const {
+    memset(&lease, 0, sizeof(lease)); // Padding included, so stores compare and checksum stable bytes.
+    memcpy(lease.mac, _mac, 6);
+    for (uint8_t i = 0; i < 4; i++) {
+        lease.localIp[i] = _localIp[i];
+        lease.serverId[i] = _serverId[i];
+    }
+    lease.leaseTime = _leaseTime;
+}
+
+bool DhcpClient::openSocket() {
+    return _udp.open(DHCP_CLIENT_PORT);
+}
+
+/**
+ * @brief Private method for a fresh transaction ID from the client's own generator.
+ * @details The sketch's random() is left alone. The generator is seeded once, from
+ * the MAC and the time of the first attempt, so nodes booting together do not collide.
+ */
+uint32_t DhcpClient::nextXid() {
+    if (_rng == 0) {
+        uint32_t state = 0x811C9DC5UL ^ micros();
+        for (uint8_t i = 0; i < 6; i++) {
+            state = (state ^ _mac[i]) * 16777619UL; // FNV-1a
+        }
+        _rng = state ? state : 0x9E3779B9UL;
+    }
+    _rng ^= _rng << 13; // xorshift32
+    _rng ^= _rng >> 17;
+    _rng ^= _rng << 5;
+    return _rng;
+}
+
+/**
+ * @brief Builds a client message straight into the chip's TX buffer.
+ * @details All messages are broadcast, including renewals. That costs nothing on
+ * a LAN and means the server's address never has to be resolved by ARP.
+ * An INIT-REBOOT request names the address but no server, so any server that
+ * knows the lease can confirm it.
+ */
+void DhcpClient::send(uint8_t messageType) {
+    uint8_t buffer[32];
+    uint16_t length = 0;
+    bool withServerId = (_state == DHCP_SELECTING || _state == DHCP_REQUESTING);
+    bool renewing = (_state == DHCP_RENEWING || _state == DHCP_REBINDING);
+
+    if (!_udp.beginPacket(IPAddress(255, 255, 255, 255), DHCP_SERVER_PORT)) {
+        return;
+    }
+
+    // op, htype, hlen, hops, xid, secs, flags, ciaddr, yiaddr, siaddr, giaddr.
+    memset(buffer, 0, sizeof(buffer));
+    buffer[0] = 1; // BOOTREQUEST
+    buffer[1] = 1; // Ethernet
+    buffer[2] = 6;
+    buffer[4] = (uint8_t)(_xid >> 24);
+    buffer[5] = (uint8_t)(_xid >> 16);
+    buffer[6] = (uint8_t)(_xid >> 8);
+    buffer[7] = (uint8_t)_xid;
+    buffer[10] = 0x80; // Ask for broadcast replies; we have no address yet.
+    if (renewing) {
+        for (uint8_t i = 0; i < 4; i++) buffer[12 + i] = _localIp[i];
+    }
+    length += _udp.write(buffer, 28);
+
+    // chaddr (16 bytes), then sname and file (192 bytes of zeros).
+    memset(buffer, 0, sizeof(buffer));
+    memcpy(buffer, _mac, 6);
+    length += _udp.write(buffer, 16);
+    memset(buffer, 0, 6);
+    for (uint8_t i = 0; i < 6; i++) {
+        length += _udp.write(buffer, 32);
+    }
+
+    uint8_t n = 0;
+    buffer[n++] = 99; buffer[n++] = 130; buffer[n++] = 83; buffer[n++] = 99; // Magic cookie
+    buffer[n++] = OPT_MESSAGE_TYPE; buffer[n++] = 1; buffer[n++] = messageType;
+    buffer[n++] = OPT_CLIENT_ID; buffer[n++] = 7; buffer[n++] = 1;
+    memcpy(buffer + n, _mac, 6); n += 6;
+    if (messageType == MSG_REQUEST && !renewing) {
+        buffer[n++] = OPT_REQUESTED_IP; buffer[n++] = 4;
+        for (uint8_t i = 0; i < 4; i++) buffer[n++] = _localIp[i];
+        if (withServerId) {
+            buffer[n++] = OPT_SERVER_ID; buffer[n++] = 4;
+            for (uint8_t i = 0; i < 4; i++) buffer[n++] = _serverId[i];
+        }
+    }
+    length += _udp.write(buffer, n);
+
+    n = 0;
+    buffer[n++] = OPT_PARAM_REQUEST; buffer[n++] = 6;
+    buffer[n++] = OPT_SUBNET_MASK; buffer[n++] = OPT_ROUTER; buffer[n++] = OPT_DNS_SERVER;
+    buffer[n++] = OPT_LEASE_TIME; buffer[n++] = OPT_T1; buffer[n++] = OPT_T2;
+    buffer[n++] = OPT_END;
+    length += _udp.write(buffer, n);
+
+    memset(buffer, 0, sizeof(buffer));
+    while (length < MIN_MESSAGE_SIZE) {
+        uint16_t pad = MIN_MESSAGE_SIZE - length;
+        length += _udp.write(buffer, pad < sizeof(buffer) ? pad : sizeof(buffer));
+    }
+
+    _udp.endPacket();
+}
+
+/**
+ * @brief Parses at most one pending datagram.
+ * @return The DHCP message type, or 0 if nothing relevant was received.
+ */
+uint8_t DhcpClient::receive(Reply& reply) {
+    if (_udp.parsePacket() == 0) {
+        return 0;
+    }
+
+    uint8_t buffer[32];
+    uint8_t messageType = 0;
+
+    // op, htype, hlen, hops, xid, secs, flags, ciaddr, yiaddr, siaddr, giaddr.
+    if (_udp.read(0, buffer, 28) != 28 || buffer[0] != 2 || readUint32(buffer + 4) != _xid) {
+        _udp.discard();
+        return 0;
+    }
+    reply.yourIp = IPAddress(buffer[16], buffer[17], buffer[18], buffer[19]);
+    reply.subnetMask = _subnetMask;
+    reply.gatewayIp = _gatewayIp;
+    reply.dnsServerIp = _dnsServerIp;
+    reply.serverId = IPAddress(buffer[20], buffer[21], buffer[22], buffer[23]);
+    reply.leaseTime = 0;
+    reply.t1 = 0;
+    reply.t2 = 0;
+
+    if (_udp.read(28, buffer, 16) != 16 || memcmp(buffer, _mac, 6) != 0) {
+        _udp.discard();
+        return 0;
+    }
+
+    // sname and file are never read; the magic cookie follows them.
+    if (_udp.read(COOKIE_OFFSET, buffer, 4) != 4 || buffer[0] != 99 || buffer[1] != 130 || buffer[2] != 83 || buffer[3] != 99) {
+        _udp.discard();
+        return 0;
+    }
+
+    // Options are read in place; skipping one costs no transfer.
+    uint16_t offset = COOKIE_OFFSET + 4;
+    for (;;) {
+        int code = _udp.peek(offset++);
+        if (code == OPT_END || code < 0) break;
+        if (code == OPT_PAD) continue;
+
+        int length = _udp.peek(offset++);
+        if (length < 0) break;
+        uint8_t kept = (uint8_t)length < sizeof(buffer) ? (uint8_t)length : sizeof(buffer);
+        if (_udp.read(offset, buffer, kept) != kept) break;
+        offset += length;
+
+        switch (code) {
+            case OPT_MESSAGE_TYPE: if (kept >= 1) messageType = buffer[0]; break;
+            case OPT_SUBNET_MASK:  if (kept >= 4) reply.subnetMask = IPAddress(buffer); break;
+            case OPT_ROUTER:       if (kept >= 4) reply.gatewayIp = IPAddress(buffer); break;
+            case OPT_DNS_SERVER:   if (kept >= 4) reply.dnsServerIp = IPAddress(buffer); break;
+            case OPT_SERVER_ID:    if (kept >= 4) reply.serverId = IPAddress(buffer); break;
+            case OPT_LEASE_TIME:   if (kept >= 4) reply.leaseTime = readUint32(buffer); break;
+            case OPT_T1:           if (kept >= 4) reply.t1 = readUint32(buffer); break;
+            case OPT_T2:           if (kept >= 4) reply.t2 = readUint32(buffer); break;
+            default: break;
+        }
+    }
+
+    _udp.discard();
+    return messageType;
+}
+
+/**
+ * @brief Takes over the addresses and timers from a server reply.
+ */
+void DhcpClient::accept(const Reply& reply) {
+    _localIp = reply.yourIp;
+    _subnetMask = reply.subnetMask;
+    _gatewayIp = reply.gatewayIp;
+    _dnsServerIp = reply.dnsServerIp;
+    _serverId = reply.serverId;
+
+    _leaseTime = reply.leaseTime;
+    if (_leaseTime == 0 || _leaseTime > MAX_LEASE_SECONDS) _leaseTime = MAX_LEASE_SECONDS;
+    _t1 = (reply.t1 != 0 && reply.t1 < _leaseTime) ? reply.t1 : _leaseTime / 2;
+    _t2 = (reply.t2 != 0 && reply.t2 < _leaseTime) ? reply.t2 : (_leaseTime / 8) * 7;
+    if (_t2 < _t1) _t2 = _t1;
+}
+
+bool DhcpClient::retransmitDue(unsigned long now) {
+    return now - _lastSend >= _retransmit;
+}
+
+/**
+ * @brief Records a transmission and doubles the retransmission timeout (RFC 2131, 4.1).
+ */
+void DhcpClient::markSent(unsigned long now, bool first) {
+    _lastSend = now;
+    if (first) {
+        _retransmit = RETRANSMIT_START;
+    } else if (_retransmit < RETRANSMIT_MAX) {
+        _retransmit *= 2;
+    }
+}
+
+/**
+ * @brief Enters BOUND; the socket is released until the next renewal.
+ */
+void DhcpClient::bind(unsigned long now) {
+    _udp.close();
+    _leaseStart = now;
+    _state = DHCP_BOUND;
+}
+
+} // namespace SimpleNet
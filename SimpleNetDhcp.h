@@ -0,0 +1,144 @@
+#ifndef SIMPLE_NET_DHCP_H
+#define SIMPLE_NET_DHCP_H
+
+#include <Arduino.h>
+#include <Ethernet.h>
+#include "SimpleNetLeaseStore.h"
+#include "SimpleNetUdp.h"
+
+namespace SimpleNet {
+
+/**
+ * @brief Client states of the DHCP exchange (RFC 2131, section 4.4).
+ * @details DHCP_INIT, DHCP_SELECTING, DHCP_REQUESTING and DHCP_REBOOTING are the
+ * sub-states of NET_CONNECTING; the remaining states are only reached while connected.
+ */
+enum DhcpState {
+    DHCP_IDLE,       ///< No lease and no exchange in progress.
+    DHCP_INIT,       ///< A DISCOVER is due to be sent.
+    DHCP_SELECTING,  ///< DISCOVER sent, waiting for an OFFER.
+    DHCP_REQUESTING, ///< REQUEST sent, waiting for the ACK.
+    DHCP_REBOOTING,  ///< REQUEST for a remembered address sent (INIT-REBOOT), waiting for the ACK.
+    DHCP_BOUND,      ///< A lease is held.
+    DHCP_RENEWING,   ///< T1 expired, renewing the lease.
+    DHCP_REBINDING,  ///< T2 expired, rebinding the lease with any server.
+    DHCP_FAILED      ///< The acquisition attempt timed out.
+};
+
+/**
+ * @brief Result of a lease maintenance step while bound.
+ */
+enum DhcpLeaseEvent {
+    DHCP_LEASE_NONE,    ///< Nothing happened.
+    DHCP_LEASE_RENEWED, ///< The lease was extended by the original server.
+    DHCP_LEASE_REBOUND, ///< The lease was extended by another server.
+    DHCP_LEASE_LOST     ///< The lease expired or was refused.
+};
+
+/**
+ * @brief A DHCP client that advances one bounded step per call.
+ * @details Unlike Ethernet.begin(mac), nothing here waits for the network. Each
+ * call to step() or maintain() sends at most one packet and parses at most one
+ * received packet, so the cost of a call is a handful of SPI transactions.
+ */
+class DhcpClient {
+public:
+    DhcpClient();
+
+    /**
+     * @brief Starts a new acquisition (DISCOVER/OFFER/REQUEST/ACK).
+     * @details With a remembered lease the client first asks for that address
+     * directly (INIT-REBOOT, RFC 2131 section 3.2), which takes a single round trip.
+     * A NAK, or no answer, falls back to DISCOVER within the same attempt.
+     * @param mac The 6-byte MAC address used as client hardware address.
+     * @param timeout Time in milliseconds after which the attempt is abandoned.
+     * @param remembered A previous lease to reclaim, or nullptr.
+     * @return false if no hardware socket was free for the UDP exchange.
+     */
+    bool start(const byte mac[], unsigned long timeout, const DhcpLease* remembered = nullptr);
+
+    /**
+     * @brief Advances the acquisition by one step.
+     * @return The new state; DHCP_BOUND on success, DHCP_FAILED on timeout.
+     */
+    DhcpState step();
+
+    /**
+     * @brief Handles renewal and rebinding of a held lease.
+     * @details Must be called regularly while bound. Renewal starts at T1 and
+     * rebinding at T2; the lease is reported lost when it expires.
+     */
+    DhcpLeaseEvent maintain();
+
+    /**
+     * @brief Abandons any exchange or lease and releases the UDP socket.
+     */
+    void stop();
+
+    /**
+     * @brief Runs the exchange on chip instead of the library chip.
+     */
+    void attach(NetChip& chip) { _udp.attach(chip); }
+
+    DhcpState state() const { return _state; }
+    IPAddress localIP() const { return _localIp; }
+    IPAddress subnetMask() const { return _subnetMask; }
+    IPAddress gatewayIP() const { return _gatewayIp; }
+    IPAddress dnsServerIP() const { return _dnsServerIp; }
+    IPAddress serverIP() const { return _serverId; }
+    unsigned long leaseTime() const { return _leaseTime; }
+
+    /**
+     * @brief Fills in the current lease for a LeaseStore.
+     */
+    void getLease(DhcpLease& lease) const;
+
+private:
+    UdpEndpoint   _udp;
+    byte          _mac[6];
+    DhcpState     _state;
+    uint32_t      _xid;
+    uint32_t      _rng;  ///< xorshift32 state for transaction IDs, independent of the sketch's random().
+
+    unsigned long _timeout;
+    unsigned long _attemptStart;
+    unsigned long _lastSend;
+    unsigned long _retransmit;
+    uint8_t       _requestTries;
+
+    IPAddress     _localIp;
+    IPAddress     _subnetMask;
+    IPAddress     _gatewayIp;
+    IPAddress     _dnsServerIp;
+    IPAddress     _serverId;
+
+    unsigned long _leaseStart;
+    unsigned long _leaseTime;
+    unsigned long _t1;
+    unsigned long _t2;
+
+    /** @brief Fields parsed from one server reply. */
+    struct Reply {
+        IPAddress     yourIp;
+        IPAddress     subnetMask;
+        IPAddress     gatewayIp;
+        IPAddress     dnsServerIp;
+        IPAddress     serverId;
+        unsigned long leaseTime;
+        unsigned long t1;
+        unsigned long t2;
+    };
+
+    bool     openSocket();
+    uint32_t nextXid();
+    void     send(uint8_t messageType);
+    uint8_t  receive(Reply& reply);
+    void     accept(const Reply& reply);
+    bool     retransmitDue(unsigned long now);
+    void     markSent(unsigned long now, bool first);
+    void     bind(unsigned long now);
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_DHCP_H
@@ -0,0 +1,294 @@
+#include "SimpleNetDns.h"
+#include "SimpleNetSocket.h"
+
+namespace SimpleNet {
+
+static const uint16_t DNS_PORT = 53;
+static const unsigned long DNS_DEFAULT_TIMEOUT = 1000;
+static const uint8_t DNS_DEFAULT_TRIES = 3;
+
+static const uint8_t TYPE_A   = 1;
+static const uint8_t CLASS_IN = 1;
+
+DnsResolver::DnsResolver() {
+    _nextId = 0;
+    _timeout = DNS_DEFAULT_TIMEOUT;
+    _tries = DNS_DEFAULT_TRIES;
+    memset(_cache, 0, sizeof(_cache));
+    memset(_queries, 0, sizeof(_queries));
+}
+
+/**
+ * @brief Answers from the cache if possible, otherwise queues a query.
+ */
+bool DnsResolver::resolve(const char* host, DnsCallback callback, void* context) {
+    if (host == nullptr || strlen(host) >= SIMPLE_NET_DNS_HOST_LEN) {
+        return false;
+    }
+
+    IPAddress ip;
+    if (ip.fromString(host) || lookup(host, ip)) {
+        if (callback) callback(ip, context);
+        return true;
+    }
+
+    // A caller that retries until answered (ClientPool::acquire()) needs only one query.
+    uint32_t hash = hashName(host);
+    for (uint8_t i = 0; i < SIMPLE_NET_DNS_MAX_PENDING; i++) {
+        const Query& query = _queries[i];
+        if (query.hash == hash && query.callback == callback && query.context == context) {
+            return true;
+        }
+    }
+
+    for (uint8_t i = 0; i < SIMPLE_NET_DNS_MAX_PENDING; i++) {
+        Query& query = _queries[i];
+        if (query.hash != 0) continue;
+
+        strcpy(query.host, host);
+        query.hash = hash;
+        query.tries = 0;
+        query.callback = callback;
+        query.context = context;
+        if (_nextId == 0) _nextId = (uint16_t)random(1, 0x10000);
+        query.id = _nextId++;
+        return true;
+    }
+    return false;
+}
+
+bool DnsResolver::lookup(const char* host, IPAddress& ip) {
+    uint32_t hash = hashName(host);
+    unsigned long now = millis();
+
+    for (uint8_t i = 0; i < SIMPLE_NET_DNS_CACHE_SIZE; i++) {
+        CacheEntry& entry = _cache[i];
+        if (entry.hash != hash) continue;
+        if ((long)(entry.expires - now) <= 0) {
+            entry.hash = 0;
+            return false;
+        }
+        ip = IPAddress(entry.ip);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Runs at most one receive and one send; closes the socket once idle.
+ */
+void DnsResolver::poll() {
+    if (pending() == 0) {
+        _udp.close();
+        return;
+    }
+
+    if (_udp.isOpen()) {
+        receive();
+    }
+
+    unsigned long now = millis();
+    for (uint8_t i = 0; i < SIMPLE_NET_DNS_MAX_PENDING; i++) {
+        Query& query = _queries[i];
+        if (query.hash == 0 || (query.tries > 0 && now - query.sentAt < _timeout)) continue;
+
+        if (query.tries >= _tries) {
+            complete(query, IPAddress(0, 0, 0, 0));
+        } else {
+            // A send that failed still counts, so a lookup always ends.
+            query.tries++;
+            query.sentAt = now;
+            if (!sendQuery(query)) {
+                query.tries--; // The previous query is still going out: send on the next tick.
+            }
+        }
+        break;
+    }
+}
+
+/**
+ * @brief Drops all cached answers; pending callbacks are told the lookup failed.
+ */
+void DnsResolver::flush() {
+    memset(_cache, 0, sizeof(_cache));
+    for (uint8_t i = 0; i < SIMPLE_NET_DNS_MAX_PENDING; i++) {
+        if (_queries[i].hash != 0) complete(_queries[i], IPAddress(0, 0, 0, 0));
+    }
+    _udp.close();
+}
+
+uint8_t DnsResolver::pending() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < SIMPLE_NET_DNS_MAX_PENDING; i++) {
+        if (_queries[i].hash != 0) count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Writes a standard recursive A query for the hostname in one packet.
+ * @return false if the socket is still sending the previous query; nothing was sent.
+ */
+bool DnsResolver::sendQuery(Query& query) {
+    if (!_udp.isOpen() && !_udp.open(NetSocket::ephemeralPort())) {
+        return true; // Counted as a try, so the lookup still ends.
+    }
+
+    // Header (12) + encoded name (host length + 2) + type and class (4).
+    uint8_t buffer[12 + SIMPLE_NET_DNS_HOST_LEN + 1 + 4];
+    memset(buffer, 0, 12);
+    buffer[0] = (uint8_t)(query.id >> 8);
+    buffer[1] = (uint8_t)query.id;
+    buffer[2] = 0x01; // RD: ask the server to recurse.
+    buffer[5] = 1;    // QDCOUNT
+
+    uint8_t n = 12;
+    const char* label = query.host;
+    while (*label) {
+        const char* end = strchr(label, '.');
+        uint8_t length = end ? (uint8_t)(end - label) : (uint8_t)strlen(label);
+        if (length == 0 || length > 63) {
+            complete(query, IPAddress(0, 0, 0, 0));
+            return true;
+        }
+        buffer[n++] = length;
+        memcpy(buffer + n, label, length);
+        n += length;
+        label += length;
+        if (*label == '.') label++;
+    }
+    buffer[n++] = 0;
+    buffer[n++] = 0; buffer[n++] = TYPE_A;
+    buffer[n++] = 0; buffer[n++] = CLASS_IN;
+
+    if (!_udp.beginPacket(_server, DNS_PORT)) return false;
+    _udp.write(buffer, n);
+    _udp.endPacket();
+    return true;
+}
+
+/**
+ * @brief Parses one pending datagram in place and completes the query it answers.
+ */
+void DnsResolver::receive() {
+    if (_udp.parsePacket() == 0) {
+        return;
+    }
+
+    uint8_t header[12];
+    if (_udp.read(0, header, sizeof(header)) != sizeof(header) || !(header[2] & 0x80)) {
+        _udp.discard();
+        return;
+    }
+
+    uint16_t id = ((uint16_t)header[0] << 8) | header[1];
+    Query* query = nullptr;
+    for (uint8_t i = 0; i < SIMPLE_NET_DNS_MAX_PENDING; i++) {
+        if (_queries[i].hash != 0 && _queries[i].tries > 0 && _queries[i].id == id) {
+            query = &_queries[i];
+        }
+    }
+    if (!query) {
+        _udp.discard();
+        return;
+    }
+
+    // Any RCODE other than NOERROR (e.g. NXDOMAIN) is a definite answer.
+    IPAddress ip(0, 0, 0, 0);
+    uint16_t questions = ((uint16_t)header[4] << 8) | header[5];
+    uint16_t answers = ((uint16_t)header[6] << 8) | header[7];
+    bool ok = (header[3] & 0x0F) == 0;
+    uint16_t offset = sizeof(header);
+
+    for (uint16_t i = 0; ok && i < questions; i++) {
+        ok = skipName(offset);
+        offset += 4; // Type and class.
+    }
+    for (uint16_t i = 0; ok && i < answers; i++) {
+        uint8_t record[10];
+        if (!skipName(offset) || _udp.read(offset, record, sizeof(record)) != sizeof(record)) break;
+        offset += sizeof(record);
+
+        uint16_t type = ((uint16_t)record[0] << 8) | record[1];
+        uint16_t rclass = ((uint16_t)record[2] << 8) | record[3];
+        unsigned long ttl = ((unsigned long)record[4] << 24) | ((unsigned long)record[5] << 16) |
+                            ((unsigned long)record[6] << 8) | record[7];
+        uint16_t length = ((uint16_t)record[8] << 8) | record[9];
+
+        // CNAME records come first; the first A record is the answer.
+        if (type == TYPE_A && rclass == CLASS_IN && length == 4) {
+            uint8_t address[4];
+            if (_udp.read(offset, address, 4) != 4) break;
+            ip = IPAddress(address);
+            store(query->hash, ip, ttl);
+            break;
+        }
+        offset += length;
+    }
+
+    _udp.discard();
+    complete(*query, ip);
+}
+
+/**
+ * @brief Caches an answer in a free or expired slot, else over the one expiring first.
+ */
+void DnsResolver::store(uint32_t hash, IPAddress ip, unsigned long ttl) {
+    if (ttl == 0) return;
+    if (ttl > SIMPLE_NET_DNS_MAX_TTL) ttl = SIMPLE_NET_DNS_MAX_TTL;
+
+    unsigned long now = millis();
+    CacheEntry* slot = &_cache[0];
+    for (uint8_t i = 0; i < SIMPLE_NET_DNS_CACHE_SIZE; i++) {
+        CacheEntry& entry = _cache[i];
+        if (entry.hash == hash || entry.hash == 0 || (long)(entry.expires - now) <= 0) {
+            slot = &entry;
+            break;
+        }
+        if ((long)(entry.expires - slot->expires) < 0) slot = &entry;
+    }
+
+    slot->hash = hash;
+    for (uint8_t i = 0; i < 4; i++) slot->ip[i] = ip[i];
+    slot->expires = now + ttl * 1000UL;
+}
+
+/**
+ * @brief Frees the query slot, then reports the result.
+ * @details The slot is released first so the callback may start a new lookup.
+ */
+void DnsResolver::complete(Query& query, IPAddress ip) {
+    DnsCallback callback = query.callback;
+    void* context = query.context;
+    query.hash = 0;
+    if (callback) callback(ip, context);
+}
+
+/**
+ * @brief Moves offset past an encoded name: labels up to a zero length or a compression pointer.
+ * @details Only the length bytes are read; the labels stay in the chip.
+ */
+bool DnsResolver::skipName(uint16_t& offset) {
+    while (true) {
+        int length = _udp.peek(offset++);
+        if (length < 0) return false;
+        if (length == 0) return true;
+        if ((length & 0xC0) == 0xC0) return _udp.peek(offset++) >= 0;
+        offset += length;
+    }
+}
+
+/**
+ * @brief FNV-1a over the lowercased name; 0 is reserved for unused slots.
+ */
+uint32_t DnsResolver::hashName(const char* host) {
+    uint32_t hash = 2166136261UL;
+    for (; *host; host++) {
+        char c = *host;
+        if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+        hash = (hash ^ (uint8_t)c) * 16777619UL;
+    }
+    return hash ? hash : 1;
+}
+
+} // namespace SimpleNet
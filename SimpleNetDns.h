@@ -0,0 +1,119 @@
+#ifndef SIMPLE_NET_DNS_H
+#define SIMPLE_NET_DNS_H
+
+#include <Arduino.h>
+#include <Ethernet.h>
+#include "SimpleNetUdp.h"
+
+#ifndef SIMPLE_NET_DNS_CACHE_SIZE
+#define SIMPLE_NET_DNS_CACHE_SIZE 4 ///< Resolved hostnames kept until their TTL expires.
+#endif
+
+#ifndef SIMPLE_NET_DNS_MAX_PENDING
+#define SIMPLE_NET_DNS_MAX_PENDING 2 ///< Lookups that can be in flight at once.
+#endif
+
+#ifndef SIMPLE_NET_DNS_HOST_LEN
+#define SIMPLE_NET_DNS_HOST_LEN 40 ///< Longest hostname (plus terminator) a lookup accepts.
+#endif
+
+#ifndef SIMPLE_NET_DNS_MAX_TTL
+#define SIMPLE_NET_DNS_MAX_TTL 86400UL ///< Upper bound in seconds on how long an answer is cached.
+#endif
+
+namespace SimpleNet {
+
+/// Lookup result callback; ip is 0.0.0.0 if the name could not be resolved.
+typedef void (*DnsCallback)(IPAddress ip, void* context);
+
+/**
+ * @brief An asynchronous DNS resolver with a small TTL-respecting cache.
+ * @details resolve() only queues the question. poll() sends at most one query and
+ * parses at most one answer per call, so a slow or absent DNS server never holds
+ * up loop(). Answers are cached for their TTL, keyed by a 32-bit hash of the
+ * lowercased hostname; the names themselves are not kept. The UDP socket is only
+ * held while a lookup is in flight.
+ */
+class DnsResolver {
+public:
+    DnsResolver();
+
+    /**
+     * @brief Sets the DNS server queries are sent to.
+     */
+    void setServer(IPAddress server) { _server = server; }
+
+    /**
+     * @brief Looks up host and reports the address through callback.
+     * @details Dotted-decimal addresses and cached names are answered at once,
+     * from inside this call. Otherwise the callback runs from a later poll(). A
+     * lookup of the same name for the same callback and context is only queued once.
+     * @return false if the name is too long or all lookup slots are busy.
+     */
+    bool resolve(const char* host, DnsCallback callback, void* context = nullptr);
+
+    /**
+     * @brief Returns true and sets ip if host is in the cache and still fresh.
+     */
+    bool lookup(const char* host, IPAddress& ip);
+
+    /**
+     * @brief Sends due queries and handles one received answer.
+     */
+    void poll();
+
+    /**
+     * @brief Empties the cache and fails every lookup in flight.
+     */
+    void flush();
+
+    /**
+     * @brief Sets the time in milliseconds to wait for an answer and the number of tries.
+     */
+    void setTimeout(unsigned long timeout, uint8_t tries) { _timeout = timeout; _tries = tries; }
+
+    uint8_t pending() const;
+
+    /**
+     * @brief Sends queries through chip instead of the library chip.
+     */
+    void attach(NetChip& chip) { _udp.attach(chip); }
+
+private:
+    struct CacheEntry {
+        uint32_t      hash;
+        uint8_t       ip[4];
+        unsigned long expires; ///< millis() value; an entry with hash 0 is unused.
+    };
+
+    struct Query {
+        char          host[SIMPLE_NET_DNS_HOST_LEN];
+        uint32_t      hash;
+        uint16_t      id;
+        uint8_t       tries; ///< Queries sent so far.
+        unsigned long sentAt;
+        DnsCallback   callback;
+        void*         context;
+    };
+
+    UdpEndpoint   _udp;
+    IPAddress     _server;
+    uint16_t      _nextId;
+    unsigned long _timeout;
+    uint8_t       _tries;
+
+    CacheEntry    _cache[SIMPLE_NET_DNS_CACHE_SIZE];
+    Query         _queries[SIMPLE_NET_DNS_MAX_PENDING];
+
+    bool sendQuery(Query& query);
+    void receive();
+    void store(uint32_t hash, IPAddress ip, unsigned long ttl);
+    void complete(Query& query, IPAddress ip);
+    bool skipName(uint16_t& offset);
+
+    static uint32_t hashName(const char* host);
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_DNS_H
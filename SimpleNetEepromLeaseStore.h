@@ -0,0 +1,78 @@
+#ifndef SIMPLE_NET_EEPROM_LEASE_STORE_H
+#define SIMPLE_NET_EEPROM_LEASE_STORE_H
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "SimpleNetLeaseStore.h"
+
+namespace SimpleNet {
+
+/**
+ * @brief Keeps the last DHCP lease in EEPROM.
+ * @details The record takes sizeof(DhcpLease) + 2 bytes from the given address: a
+ * marker, the lease and a checksum. Only bytes that differ are written, so renewals
+ * of an unchanged lease cost no EEPROM cycles. This header is not included by
+ * SimpleNetManager.h, so boards without an EEPROM library are unaffected.
+ *
+ * On ESP8266/ESP32 the emulated EEPROM must be opened with EEPROM.begin() first;
+ * save() and clear() commit it.
+ */
+class EepromLeaseStore : public LeaseStore {
+public:
+    /**
+     * @param address First EEPROM byte of the record.
+     */
+    explicit EepromLeaseStore(int address = 0) : _address(address) {}
+
+    bool load(DhcpLease& lease) override {
+        uint8_t* bytes = (uint8_t*)&lease;
+        if (EEPROM.read(_address) != MARKER) return false;
+        for (uint8_t i = 0; i < sizeof(DhcpLease); i++) {
+            bytes[i] = EEPROM.read(_address + 1 + i);
+        }
+        return EEPROM.read(_address + 1 + sizeof(DhcpLease)) == checksum(lease);
+    }
+
+    void save(const DhcpLease& lease) override {
+        const uint8_t* bytes = (const uint8_t*)&lease;
+        writeByte(_address, MARKER);
+        for (uint8_t i = 0; i < sizeof(DhcpLease); i++) {
+            writeByte(_address + 1 + i, bytes[i]);
+        }
+        writeByte(_address + 1 + sizeof(DhcpLease), checksum(lease));
+        commit();
+    }
+
+    void clear() override {
+        writeByte(_address, 0);
+        commit();
+    }
+
+private:
+    static const uint8_t MARKER = 0xD4;
+
+    int _address;
+
+    static uint8_t checksum(const DhcpLease& lease) {
+        const uint8_t* bytes = (const uint8_t*)&lease;
+        uint8_t sum = MARKER;
+        for (uint8_t i = 0; i < sizeof(DhcpLease); i++) {
+            sum = (uint8_t)((sum << 1) | (sum >> 7)) ^ bytes[i];
+        }
+        return sum;
+    }
+
+    static void writeByte(int address, uint8_t value) {
+        if (EEPROM.read(address) != value) EEPROM.write(address, value);
+    }
+
+    static void commit() {
+#if defined(ESP8266) || defined(ESP32)
+        EEPROM.commit();
+#endif
+    }
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_EEPROM_LEASE_STORE_H
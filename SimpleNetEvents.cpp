@@ -0,0 +1,65 @@
+#include "SimpleNetEvents.h"
+
+namespace SimpleNet {
+
+EventQueue::EventQueue() {
+    _head = 0;
+    _count = 0;
+    _dropped = 0;
+    for (uint8_t i = 0; i < SIMPLE_NET_MAX_LISTENERS; i++) {
+        _listeners[i].callback = nullptr;
+        _listeners[i].context = nullptr;
+    }
+}
+
+bool EventQueue::subscribe(NetEventListener listener, void* context) {
+    if (listener == nullptr) return false;
+    for (uint8_t i = 0; i < SIMPLE_NET_MAX_LISTENERS; i++) {
+        if (_listeners[i].callback == nullptr) {
+            _listeners[i].callback = listener;
+            _listeners[i].context = context;
+            return true;
+        }
+    }
+    return false;
+}
+
+void EventQueue::unsubscribe(NetEventListener listener, void* context) {
+    for (uint8_t i = 0; i < SIMPLE_NET_MAX_LISTENERS; i++) {
+        if (_listeners[i].callback == listener && _listeners[i].context == context) {
+            _listeners[i].callback = nullptr;
+            _listeners[i].context = nullptr;
+        }
+    }
+}
+
+void EventQueue::publish(NetEvent event) {
+    if (_count == SIMPLE_NET_EVENT_QUEUE_SIZE) {
+        // Keep the newest state; a stale CONNECTED is worth less than the DISCONNECTED after it.
+        _head = (_head + 1) % SIMPLE_NET_EVENT_QUEUE_SIZE;
+        _count--;
+        _dropped++;
+    }
+    _events[(_head + _count) % SIMPLE_NET_EVENT_QUEUE_SIZE] = event;
+    _count++;
+}
+
+uint8_t EventQueue::dispatch(uint8_t maxEvents) {
+    uint8_t delivered = 0;
+    while (_count > 0 && delivered < maxEvents) {
+        NetEvent event = _events[_head];
+        _head = (_head + 1) % SIMPLE_NET_EVENT_QUEUE_SIZE;
+        _count--;
+        delivered++;
+
+        // Listeners may publish or (un)subscribe; the table is re-read on every iteration.
+        for (uint8_t i = 0; i < SIMPLE_NET_MAX_LISTENERS; i++) {
+            if (_listeners[i].callback) {
+                _listeners[i].callback(event, _listeners[i].context);
+            }
+        }
+    }
+    return delivered;
+}
+
+} // namespace SimpleNet
@@ -0,0 +1,88 @@
+#ifndef SIMPLE_NET_EVENTS_H
+#define SIMPLE_NET_EVENTS_H
+
+#include <Arduino.h>
+
+#ifndef SIMPLE_NET_EVENT_QUEUE_SIZE
+#define SIMPLE_NET_EVENT_QUEUE_SIZE 8 ///< Pending events the queue can hold.
+#endif
+
+#ifndef SIMPLE_NET_MAX_LISTENERS
+#define SIMPLE_NET_MAX_LISTENERS 4 ///< Event listeners that can be registered at once.
+#endif
+
+namespace SimpleNet {
+
+/**
+ * @brief Network events published by SimpleNetManager.
+ */
+enum NetEvent {
+    NET_EVENT_CONNECTED,     ///< The manager entered NET_CONNECTED.
+    NET_EVENT_DISCONNECTED,  ///< The manager left NET_CONNECTED.
+    NET_EVENT_LEASE_RENEWED, ///< The DHCP lease was renewed or rebound.
+    NET_EVENT_IP_CHANGED,    ///< The local IP address differs from the previous one.
+    NET_EVENT_LINK_UP,       ///< The physical link came up.
+    NET_EVENT_LINK_DOWN,     ///< The physical link went down.
+    NET_EVENT_DEGRADED,      ///< The reachability probe target stopped answering (NET_DEGRADED).
+    NET_EVENT_RECOVERED,     ///< The probe target answers again (back to NET_CONNECTED).
+    NET_EVENT_ADDRESS_CONFLICT ///< Another host uses the static address (NET_ADDRESS_CONFLICT).
+};
+
+/// Listener type; context is the pointer given at registration.
+typedef void (*NetEventListener)(NetEvent event, void* context);
+
+/**
+ * @brief A fixed-size ring buffer of events with a fixed table of listeners.
+ * @details Publishing only stores the event, so it costs the state machine a few
+ * instructions regardless of how many listeners there are or how long they run.
+ * Events are delivered later by dispatch(), to every listener in registration order.
+ */
+class EventQueue {
+public:
+    EventQueue();
+
+    /**
+     * @brief Registers a listener. The same function may be added with different contexts.
+     * @return false if the listener table is full.
+     */
+    bool subscribe(NetEventListener listener, void* context = nullptr);
+
+    /**
+     * @brief Removes a listener registered with the same function and context.
+     */
+    void unsubscribe(NetEventListener listener, void* context = nullptr);
+
+    /**
+     * @brief Stores an event; the oldest one is dropped if the queue is full.
+     */
+    void publish(NetEvent event);
+
+    /**
+     * @brief Delivers up to maxEvents queued events to all listeners.
+     * @return The number of events delivered.
+     */
+    uint8_t dispatch(uint8_t maxEvents = SIMPLE_NET_EVENT_QUEUE_SIZE);
+
+    uint8_t pending() const { return _count; }
+
+    /**
+     * @brief Returns how many events were dropped because the queue was full.
+     */
+    unsigned long dropped() const { return _dropped; }
+
+private:
+    struct Listener {
+        NetEventListener callback;
+        void*            context;
+    };
+
+    NetEvent      _events[SIMPLE_NET_EVENT_QUEUE_SIZE];
+    uint8_t       _head;
+    uint8_t       _count;
+    unsigned long _dropped;
+    Listener      _listeners[SIMPLE_NET_MAX_LISTENERS];
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_EVENTS_H
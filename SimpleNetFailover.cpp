@@ -0,0 +1,70 @@
+#include "SimpleNetFailover.h"
+
+namespace SimpleNet {
+
+NetFailover::NetFailover() {
+    _count = 0;
+    _active = NET_NO_INTERFACE;
+    _failbackDelay = 5000;
+    _switches = 0;
+    _onSwitch = nullptr;
+}
+
+bool NetFailover::add(NetInterface& interface) {
+    if (_count >= SIMPLE_NET_MAX_INTERFACES) {
+        return false;
+    }
+
+    _links[_count].interface = &interface;
+    _links[_count].up = false;
+    _links[_count].changedAt = millis();
+    _count++;
+    return true;
+}
+
+void NetFailover::loop() {
+    unsigned long now = millis();
+    for (uint8_t i = 0; i < _count; i++) {
+        Link& link = _links[i];
+        link.interface->loop();
+        bool up = link.interface->isUp();
+        if (up != link.up) {
+            link.up = up;
+            link.changedAt = now;
+        }
+    }
+
+    int8_t best = choose(now);
+    if (best != _active) {
+        // A backup that is left behind stays up, so its connection would linger unused.
+        if (isConnected()) {
+            _links[_active].interface->client().stop();
+        }
+        _active = best;
+        _switches++;
+        if (_onSwitch) {
+            _onSwitch(_active);
+        }
+    }
+}
+
+/**
+ * @brief Private method to pick the highest-ranked usable interface.
+ */
+int8_t NetFailover::choose(unsigned long now) const {
+    bool activeUp = isConnected() && _links[_active].up;
+    for (uint8_t i = 0; i < _count; i++) {
+        const Link& link = _links[i];
+        if (!link.up) {
+            continue;
+        }
+        // Only hold traffic back from a recovered interface while the current one still works.
+        if (activeUp && (int8_t)i < _active && now - link.changedAt < _failbackDelay) {
+            continue;
+        }
+        return i;
+    }
+    return NET_NO_INTERFACE;
+}
+
+} // namespace SimpleNet
@@ -0,0 +1,97 @@
+#ifndef SIMPLE_NET_FAILOVER_H
+#define SIMPLE_NET_FAILOVER_H
+
+#include <Arduino.h>
+#include "SimpleNetInterface.h"
+
+#ifndef SIMPLE_NET_MAX_INTERFACES
+#define SIMPLE_NET_MAX_INTERFACES 2 ///< Interfaces a NetFailover can manage.
+#endif
+
+namespace SimpleNet {
+
+/// Interface index meaning "no interface is up".
+static const int8_t NET_NO_INTERFACE = -1;
+
+/// Callback type for NetFailover switches; active is the new index or NET_NO_INTERFACE.
+typedef void (*NetFailoverCallback)(int8_t active);
+
+/**
+ * @brief Keeps several interfaces connected and routes traffic through the best one.
+ * @details Interfaces are ranked in the order they were added, the first being the
+ * primary. Every interface is driven on each loop(), so the backups stay connected
+ * (hot standby) and a switch never waits for DHCP or a retry interval. When the
+ * active interface goes down, the next interface that is up takes over within the
+ * same loop() call. Traffic only moves back up to a higher-ranked interface once it
+ * has been up for the failback delay, so a flapping primary does not bounce every
+ * connection.
+ *
+ * Connections are not migrated: a switch stops the client of the old interface
+ * (before the onSwitch() callback), and the application reconnects through client().
+ */
+class NetFailover {
+public:
+    NetFailover();
+
+    /**
+     * @brief Adds an interface below those added before it.
+     * @return false if SIMPLE_NET_MAX_INTERFACES are already added.
+     */
+    bool add(NetInterface& interface);
+
+    /**
+     * @brief Drives every interface and switches the active one if needed.
+     */
+    void loop();
+
+    /**
+     * @brief Sets how long a higher-ranked interface must stay up before traffic
+     * moves back to it (default 5,000 ms; 0 switches back at once).
+     */
+    void setFailbackDelay(unsigned long delay) { _failbackDelay = delay; }
+
+    /**
+     * @brief Registers a function called after every switch, including to and from
+     * NET_NO_INTERFACE.
+     */
+    void onSwitch(NetFailoverCallback callback) { _onSwitch = callback; }
+
+    bool          isConnected() const { return _active != NET_NO_INTERFACE; }
+    int8_t        activeIndex() const { return _active; }
+    NetInterface* active() { return isConnected() ? _links[_active].interface : nullptr; }
+
+    /**
+     * @brief Returns the client of the active interface, or nullptr if none is up.
+     */
+    Client* client() { return isConnected() ? &_links[_active].interface->client() : nullptr; }
+
+    /**
+     * @brief Returns whether the interface at index was up at the last loop().
+     */
+    bool isUp(uint8_t index) const { return index < _count && _links[index].up; }
+
+    /**
+     * @brief Returns how many times the active interface has changed.
+     */
+    unsigned long switchCount() const { return _switches; }
+
+private:
+    struct Link {
+        NetInterface* interface;
+        bool          up;
+        unsigned long changedAt; ///< millis() of the last up/down change.
+    };
+
+    Link                _links[SIMPLE_NET_MAX_INTERFACES];
+    uint8_t             _count;
+    int8_t              _active;
+    unsigned long       _failbackDelay;
+    unsigned long       _switches;
+    NetFailoverCallback _onSwitch;
+
+    int8_t choose(unsigned long now) const;
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_FAILOVER_H
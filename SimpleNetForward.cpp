@@ -0,0 +1,206 @@
+#include "SimpleNetForward.h"
+
+namespace SimpleNet {
+
+static const unsigned long FORWARD_RETRY_DELAY = 5000;     ///< After a failed connect.
+static const unsigned long FORWARD_CONNECT_TIMEOUT = 10000; ///< For the handshake and for closing.
+static const uint8_t       RECORD_HEADER_SIZE = 2;          ///< Big-endian record length.
+
+StoreAndForward::StoreAndForward(SimpleNetManagerBase& manager, RecordStore& store)
+    : NetService(manager), _manager(manager), _store(store) {
+    _socket.attach(manager.chip());
+    _port = 0;
+    _head = 0;
+    _used = 0;
+    _records = 0;
+    _dropped = 0;
+    _drainLimit = 512;
+    _idleTimeout = 5000;
+    _lastAttempt = 0;
+    _lastActivity = 0;
+    _established = false;
+}
+
+void StoreAndForward::setDestination(IPAddress ip, uint16_t port) {
+    _ip = ip;
+    _port = port;
+    _socket.close(); // Reconnects to the new destination on the next tick.
+}
+
+bool StoreAndForward::push(const uint8_t* data, uint16_t len) {
+    if (len == 0 || len > SIMPLE_NET_FORWARD_MAX_RECORD || (uint32_t)len + RECORD_HEADER_SIZE > _store.size()) {
+        return false;
+    }
+
+    while (_store.size() - _used < (uint32_t)len + RECORD_HEADER_SIZE) {
+        dropOldest();
+        _dropped++;
+    }
+
+    uint8_t header[RECORD_HEADER_SIZE] = { (uint8_t)(len >> 8), (uint8_t)len };
+    uint32_t tail = _head + _used;
+    storeAt(tail, header, RECORD_HEADER_SIZE);
+    storeAt(tail + RECORD_HEADER_SIZE, data, len);
+    _used += len + RECORD_HEADER_SIZE;
+    _records++;
+    return true;
+}
+
+void StoreAndForward::clear() {
+    _head = 0;
+    _used = 0;
+    _records = 0;
+}
+
+/**
+ * @brief The first connection attempt after a connect happens on the next tick.
+ */
+void StoreAndForward::networkUp() {
+    _lastAttempt = millis() - FORWARD_RETRY_DELAY;
+}
+
+/**
+ * @brief Connects when there is something to send and drains the ring. Called by loop().
+ */
+void StoreAndForward::poll() {
+    if (!_manager.isConnected() || _port == 0) {
+        return;
+    }
+
+    unsigned long now = millis();
+    if (!_socket.isOpen()) {
+        if (_records == 0 || now - _lastAttempt < FORWARD_RETRY_DELAY) {
+            return;
+        }
+        _lastAttempt = now;
+        _established = false;
+        if (!_socket.openTcp() || !_socket.connect(_ip, _port)) {
+            _socket.close(); // No free socket; try again after the retry delay.
+        }
+        return;
+    }
+
+    uint8_t status = _socket.status();
+    if (status == SnSR::ESTABLISHED) {
+        if (!_established) {
+            _established = true;
+            _lastActivity = now;
+        }
+        drain(now);
+    } else if (status == SnSR::CLOSE_WAIT) {
+        _socket.disconnect(); // The server closed its side; records left wait for the next connection.
+    } else if (status == SnSR::CLOSED || now - _lastAttempt >= FORWARD_CONNECT_TIMEOUT) {
+        // Refused, reset, finished closing, or stuck in a handshake or close. The
+        // retry delay runs from the start of the attempt or the close.
+        _socket.close();
+    }
+}
+
+/**
+ * @brief Private method to move whole records from the ring into the TX buffer, one SEND per tick.
+ */
+void StoreAndForward::drain(unsigned long now) {
+    if (_records == 0) {
+        if (_idleTimeout > 0 && now - _lastActivity >= _idleTimeout) {
+            _socket.disconnect();
+            _lastAttempt = now; // Times the close.
+        }
+        return;
+    }
+    if (!_socket.sendComplete()) {
+        return;
+    }
+
+    uint16_t free = _socket.txFree();
+    uint16_t batch = 0;
+    while (_records > 0) {
+        uint16_t len = recordLength(_head);
+        if ((uint32_t)batch + len > free || (batch > 0 && (uint32_t)batch + len > _drainLimit)) {
+            break;
+        }
+
+        uint8_t chunk[SIMPLE_NET_FORWARD_CHUNK];
+        for (uint16_t done = 0; done < len; ) {
+            uint16_t part = len - done;
+            if (part > sizeof(chunk)) part = sizeof(chunk);
+            loadFrom(_head + RECORD_HEADER_SIZE + done, chunk, part);
+            _socket.writeAt(batch + done, chunk, part);
+            done += part;
+        }
+        batch += len;
+        dropOldest();
+    }
+
+    if (batch > 0) {
+        _socket.commit(batch);
+        _lastActivity = now;
+    }
+}
+
+unsigned long StoreAndForward::wakeDelay() {
+    if (!_manager.isConnected() || _port == 0) {
+        return NET_WAKE_NEVER;
+    }
+
+    unsigned long now = millis();
+    if (!_socket.isOpen()) {
+        if (_records == 0) {
+            return NET_WAKE_NEVER;
+        }
+        return now - _lastAttempt >= FORWARD_RETRY_DELAY ? 0 : FORWARD_RETRY_DELAY - (now - _lastAttempt);
+    }
+    if (_records > 0 || !_established) {
+        return 0; // Sending, or a handshake in progress.
+    }
+    if (_idleTimeout == 0) {
+        return NET_WAKE_NEVER;
+    }
+    return now - _lastActivity >= _idleTimeout ? 0 : _idleTimeout - (now - _lastActivity);
+}
+
+/**
+ * @brief Private method to remove the oldest record from the ring.
+ */
+void StoreAndForward::dropOldest() {
+    uint16_t size = recordLength(_head) + RECORD_HEADER_SIZE;
+    _head = (_head + size) % _store.size();
+    _used -= size;
+    _records--;
+    if (_records == 0) {
+        _head = 0; // Lets the next records start without a wrap.
+    }
+}
+
+uint16_t StoreAndForward::recordLength(uint32_t address) {
+    uint8_t header[RECORD_HEADER_SIZE];
+    loadFrom(address, header, RECORD_HEADER_SIZE);
+    return ((uint16_t)header[0] << 8) | header[1];
+}
+
+/**
+ * @brief Private method to write to the ring, splitting the write where it wraps.
+ */
+void StoreAndForward::storeAt(uint32_t address, const uint8_t* data, uint16_t len) {
+    uint32_t size = _store.size();
+    address %= size;
+    uint16_t first = (address + len > size) ? size - address : len;
+    _store.write(address, data, first);
+    if (first < len) {
+        _store.write(0, data + first, len - first);
+    }
+}
+
+/**
+ * @brief Private method to read from the ring, splitting the read where it wraps.
+ */
+void StoreAndForward::loadFrom(uint32_t address, uint8_t* buf, uint16_t len) {
+    uint32_t size = _store.size();
+    address %= size;
+    uint16_t first = (address + len > size) ? size - address : len;
+    _store.read(address, buf, first);
+    if (first < len) {
+        _store.read(0, buf + first, len - first);
+    }
+}
+
+} // namespace SimpleNet
@@ -0,0 +1,113 @@
+#ifndef SIMPLE_NET_FORWARD_H
+#define SIMPLE_NET_FORWARD_H
+
+#include <Arduino.h>
+#include "SimpleNetManager.h"
+#include "SimpleNetSocket.h"
+#include "SimpleNetRecordStore.h"
+
+#ifndef SIMPLE_NET_FORWARD_MAX_RECORD
+#define SIMPLE_NET_FORWARD_MAX_RECORD 512 ///< Longest record push() accepts; must fit a socket's TX buffer.
+#endif
+
+#ifndef SIMPLE_NET_FORWARD_CHUNK
+#define SIMPLE_NET_FORWARD_CHUNK 32 ///< Staging buffer for copying records from the store to the chip.
+#endif
+
+namespace SimpleNet {
+
+/**
+ * @brief Queues outbound records while offline and streams them to a TCP server.
+ * @details push() stores a record in a ring on the given RecordStore, whether or
+ * not the network is up; when the ring is full the oldest records are dropped.
+ * While connected, the queue keeps one TCP connection to the destination and
+ * drains the ring from loop(): each tick packs as many whole records as the
+ * drain limit allows into the socket's TX buffer and sends them with a single
+ * SEND. A backlog built up during an outage therefore goes out in a few large
+ * segments over one connection, without holding up loop(). The connection is
+ * closed again after the idle timeout.
+ *
+ * Records are sent back to back exactly as pushed, so they should carry their
+ * own framing (a newline, a length prefix). A record leaves the queue when it
+ * is handed to the chip; TCP cannot confirm delivery without an acknowledgement
+ * from the application protocol.
+ */
+class StoreAndForward : public NetService {
+public:
+    StoreAndForward(SimpleNetManagerBase& manager, RecordStore& store);
+
+    /**
+     * @brief Sets the server the records are sent to.
+     */
+    void setDestination(IPAddress ip, uint16_t port);
+
+    /**
+     * @brief Queues a record.
+     * @return false if len is 0, above SIMPLE_NET_FORWARD_MAX_RECORD, or larger than the store.
+     */
+    bool push(const uint8_t* data, uint16_t len);
+    bool push(const char* text) { return push((const uint8_t*)text, strlen(text)); }
+
+    /**
+     * @brief Sets the most bytes sent per loop() tick (default 512). A single record
+     * longer than the limit is still sent on its own.
+     */
+    void setDrainLimit(uint16_t bytesPerTick) { _drainLimit = bytesPerTick; }
+
+    /**
+     * @brief Sets how long the connection stays open with nothing to send
+     * (default 5,000 ms; 0 keeps it open).
+     */
+    void setIdleTimeout(unsigned long timeout) { _idleTimeout = timeout; }
+
+    /**
+     * @brief Drops every queued record.
+     */
+    void clear();
+
+    uint16_t pendingRecords() const { return _records; }
+
+    /**
+     * @brief Returns the bytes of the store in use, including two bytes per record.
+     */
+    uint32_t pendingBytes() const { return _used; }
+
+    /**
+     * @brief Returns how many records were dropped because the store was full.
+     */
+    unsigned long dropped() const { return _dropped; }
+
+protected:
+    void poll() override;
+    void networkUp() override;
+    void networkDown() override { _socket.close(); }
+    unsigned long wakeDelay() override;
+
+private:
+    SimpleNetManagerBase& _manager;
+    RecordStore&   _store;
+    NetSocket      _socket;
+    IPAddress      _ip;
+    uint16_t       _port;
+
+    uint32_t       _head;      ///< Store address of the oldest record.
+    uint32_t       _used;
+    uint16_t       _records;
+    unsigned long  _dropped;
+
+    uint16_t       _drainLimit;
+    unsigned long  _idleTimeout;
+    unsigned long  _lastAttempt;  ///< Start of the current or last connection attempt.
+    unsigned long  _lastActivity; ///< Last SEND, or when the connection was established.
+    bool           _established;
+
+    void drain(unsigned long now);
+    void dropOldest();
+    uint16_t recordLength(uint32_t address);
+    void storeAt(uint32_t address, const uint8_t* data, uint16_t len);
+    void loadFrom(uint32_t address, uint8_t* buf, uint16_t len);
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_FORWARD_H
@@ -0,0 +1,483 @@
+#include "SimpleNetHttp.h"
+
+namespace SimpleNet {
+
+static const unsigned long HTTP_DEFAULT_TIMEOUT = 10000;
+
+static bool headerIs(const char* line, const char* name, uint8_t nameLength) {
+    return strncasecmp(line, name, nameLength) == 0 && line[nameLength] == ':';
+}
+
+static int hexValue(uint8_t c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+HttpRequest::HttpRequest(SimpleNetManagerBase& manager)
+    : NetService(manager), _manager(manager) {
+    _socket.attach(manager.chip());
+    _state = HTTP_IDLE;
+    _error = HTTP_ERROR_NONE;
+    _port = 0;
+    _head[0] = '\0';
+    _headLength = 0;
+    _headSent = 0;
+    _headOverflow = false;
+    _headOnly = false;
+    _body = nullptr;
+    _bodyLength = 0;
+    _bodySent = 0;
+    _rxPos = 0;
+    _rxLength = 0;
+    _lineLength = 0;
+    _statusLine = true;
+    _statusCode = 0;
+    _contentLength = -1;
+    _bodyRemaining = 0;
+    _chunked = false;
+    _chunkState = CHUNK_SIZE;
+    _chunkRemaining = 0;
+    _timeout = HTTP_DEFAULT_TIMEOUT;
+    _lastProgress = 0;
+    _onData = nullptr;
+    _onComplete = nullptr;
+    _onError = nullptr;
+    _destroyed = nullptr;
+}
+
+/**
+ * @brief Lets a poll() that is inside a callback of this request see that it is gone.
+ */
+HttpRequest::~HttpRequest() {
+    if (_destroyed) *_destroyed = true;
+}
+
+/**
+ * @brief Resets the request and writes the request line and Host header.
+ */
+bool HttpRequest::begin(IPAddress ip, uint16_t port, const char* host, const char* method, const char* path) {
+    abort();
+
+    _ip = ip;
+    _port = port;
+    _error = HTTP_ERROR_NONE;
+    _headLength = 0;
+    _headOverflow = false;
+    _headOnly = (strcmp(method, "HEAD") == 0);
+    _body = nullptr;
+    _bodyLength = 0;
+
+    appendHead(method);
+    appendHead(" ");
+    appendHead(path);
+    appendHead(" HTTP/1.1\r\nHost: ");
+    appendHead(host);
+    appendHead("\r\nConnection: close\r\n");
+    return !_headOverflow;
+}
+
+bool HttpRequest::addHeader(const char* name, const char* value) {
+    appendHead(name);
+    appendHead(": ");
+    appendHead(value);
+    appendHead("\r\n");
+    return !_headOverflow;
+}
+
+void HttpRequest::setBody(const uint8_t* body, uint16_t length) {
+    _body = body;
+    _bodyLength = length;
+}
+
+/**
+ * @brief Completes the head and issues the non-blocking connect.
+ */
+bool HttpRequest::send() {
+    if (isBusy() || _port == 0) {
+        return false;
+    }
+
+    if (_bodyLength > 0) {
+        char digits[6];
+        uint8_t n = sizeof(digits) - 1;
+        uint16_t value = _bodyLength;
+        digits[n] = '\0';
+        do {
+            digits[--n] = '0' + (value % 10);
+            value /= 10;
+        } while (value > 0);
+        appendHead("Content-Length: ");
+        appendHead(digits + n);
+        appendHead("\r\n");
+    }
+    appendHead("\r\n");
+
+    HttpError error = HTTP_ERROR_NONE;
+    if (_headOverflow) {
+        error = HTTP_ERROR_OVERFLOW;
+    } else if (!_manager.isConnected()) {
+        error = HTTP_ERROR_NOT_CONNECTED;
+    } else if (!_socket.openTcp()) {
+        error = HTTP_ERROR_NO_SOCKET;
+    }
+    if (error != HTTP_ERROR_NONE) {
+        _error = error;
+        _state = HTTP_ERROR;
+        _port = 0; // The head is consumed; begin() must be called again.
+        return false;
+    }
+
+    _headSent = 0;
+    _bodySent = 0;
+    _rxPos = 0;
+    _rxLength = 0;
+    _lineLength = 0;
+    _statusLine = true;
+    _statusCode = 0;
+    _contentLength = -1;
+    _chunked = false;
+
+    _socket.connect(_ip, _port);
+    _state = HTTP_CONNECTING;
+    _lastProgress = millis();
+    return true;
+}
+
+void HttpRequest::abort() {
+    _socket.close();
+    _state = HTTP_IDLE;
+}
+
+int HttpRequest::available() {
+    if (_state != HTTP_BODY) return 0;
+    return (_rxLength - _rxPos) + _socket.rxAvailable();
+}
+
+/**
+ * @brief Reads decoded body bytes, honouring Content-Length and chunk boundaries.
+ */
+int HttpRequest::read(uint8_t* buf, uint16_t len) {
+    if (_state != HTTP_BODY) return 0;
+
+    uint16_t total = 0;
+    while (total < len) {
+        uint16_t want = len - total;
+        if (_chunked) {
+            if (!chunkReady()) break;
+            if (want > _chunkRemaining) want = _chunkRemaining;
+        } else if (_contentLength >= 0) {
+            if (_bodyRemaining == 0) break;
+            if (want > _bodyRemaining) want = _bodyRemaining;
+        }
+
+        uint16_t got = readRaw(buf + total, want);
+        if (got == 0) break;
+        total += got;
+
+        if (_chunked) {
+            _chunkRemaining -= got;
+            if (_chunkRemaining == 0) _chunkState = CHUNK_DATA_END;
+        } else if (_contentLength >= 0) {
+            _bodyRemaining -= got;
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Advances the request by one tick. Called by SimpleNetManager::loop().
+ */
+void HttpRequest::poll() {
+    if (!isBusy()) return;
+
+    unsigned long now = millis();
+    bool failed = false;
+    switch (_state) {
+        case HTTP_CONNECTING: {
+            uint8_t status = _socket.status();
+            if (status == SnSR::ESTABLISHED) {
+                _state = HTTP_SENDING;
+                _lastProgress = now;
+            } else if (status == SnSR::CLOSED) {
+                fail(HTTP_ERROR_CONNECT);
+                return;
+            }
+            break;
+        }
+
+        case HTTP_SENDING: {
+            uint16_t queued = 0;
+            if (_headSent < _headLength) {
+                queued = _socket.send((const uint8_t*)_head + _headSent, _headLength - _headSent);
+                _headSent += queued;
+            } else if (_bodySent < _bodyLength) {
+                queued = _socket.send(_body + _bodySent, _bodyLength - _bodySent);
+                _bodySent += queued;
+            }
+            if (queued > 0) {
+                _lastProgress = now;
+            }
+            if (_headSent == _headLength && _bodySent == _bodyLength) {
+                _state = HTTP_HEADERS;
+            } else if (queued == 0 && _socket.status() == SnSR::CLOSED) {
+                fail(HTTP_ERROR_CONNECT);
+                return;
+            }
+            break;
+        }
+
+        case HTTP_HEADERS:
+            if (parseHeaders(failed)) {
+                if (failed) return; // onError may have destroyed the request.
+                _lastProgress = now;
+            } else if (_socket.status() == SnSR::CLOSED) {
+                fail(HTTP_ERROR_PROTOCOL);
+                return;
+            }
+            if (_state != HTTP_BODY) break;
+            // The stage buffer may already hold body bytes.
+            // Fall through.
+
+        case HTTP_BODY:
+            if (available() > 0) {
+                _lastProgress = now;
+                if (_onData) {
+                    if (!notify(_onData)) return;
+                } else {
+                    uint8_t discard[32];
+                    while (read(discard, sizeof(discard)) > 0) {}
+                }
+            }
+            if (bodyComplete()) {
+                finish();
+                return;
+            }
+            if (_state == HTTP_BODY && available() == 0) {
+                uint8_t status = _socket.status();
+                if (status != SnSR::ESTABLISHED) {
+                    // Peer closed: that ends an unframed body, and truncates a framed one.
+                    if (_chunked || _contentLength >= 0) fail(HTTP_ERROR_PROTOCOL);
+                    else finish();
+                    return;
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if (isBusy() && now - _lastProgress >= _timeout) {
+        fail(HTTP_ERROR_TIMEOUT);
+    }
+}
+
+void HttpRequest::networkDown() {
+    if (isBusy()) {
+        fail(HTTP_ERROR_NETWORK_DOWN);
+    }
+}
+
+bool HttpRequest::appendHead(const char* text) {
+    uint16_t length = strlen(text);
+    if (_headLength + length >= SIMPLE_NET_HTTP_HEAD_SIZE) {
+        _headOverflow = true;
+        return false;
+    }
+    memcpy(_head + _headLength, text, length);
+    _headLength += length;
+    _head[_headLength] = '\0';
+    return true;
+}
+
+/**
+ * @brief Consumes header bytes from the stage buffer, one line at a time.
+ * @param failed Set if a bad status line failed the request; the caller must then
+ * return without touching members, since onError may have destroyed it.
+ * @return true if any bytes were consumed.
+ */
+bool HttpRequest::parseHeaders(bool& failed) {
+    bool progress = false;
+    uint8_t c;
+
+    while (_state == HTTP_HEADERS && nextRawByte(c)) {
+        progress = true;
+        if (c == '\r') continue;
+        if (c != '\n') {
+            if (_lineLength < sizeof(_line) - 1) _line[_lineLength++] = c; // Long lines are truncated.
+            continue;
+        }
+
+        _line[_lineLength] = '\0';
+        if (_lineLength == 0 && !_statusLine) {
+            if (_statusCode >= 100 && _statusCode < 200) {
+                _statusLine = true; // Interim response; the real one follows.
+            } else if (_headOnly || _statusCode == 204 || _statusCode == 304) {
+                _contentLength = 0;
+                _chunked = false;
+                _bodyRemaining = 0;
+                _state = HTTP_BODY;
+            } else {
+                _bodyRemaining = (_contentLength > 0) ? (unsigned long)_contentLength : 0;
+                _chunkState = CHUNK_SIZE;
+                _chunkRemaining = 0;
+                _state = HTTP_BODY;
+            }
+        } else if (!headerLine()) {
+            failed = true;
+            return true;
+        }
+        _lineLength = 0;
+    }
+    return progress;
+}
+
+/**
+ * @brief Interprets the status line and the headers the engine cares about.
+ * @return false if the status line was bad and the request has failed.
+ */
+bool HttpRequest::headerLine() {
+    if (_statusLine) {
+        const char* code = strchr(_line, ' ');
+        if (strncmp(_line, "HTTP/", 5) != 0 || code == nullptr) {
+            fail(HTTP_ERROR_PROTOCOL);
+            return false;
+        }
+        _statusCode = atoi(code + 1);
+        _statusLine = false;
+        _contentLength = -1;
+        _chunked = false;
+        return true;
+    }
+
+    if (headerIs(_line, "Content-Length", 14)) {
+        _contentLength = strtol(_line + 15, nullptr, 10);
+    } else if (headerIs(_line, "Transfer-Encoding", 17)) {
+        _chunked = (strstr(_line + 18, "chunked") != nullptr);
+    }
+    return true;
+}
+
+/**
+ * @brief Runs a callback that may destroy the request.
+ * @return false if it did; the caller must then return without touching members.
+ */
+bool HttpRequest::notify(HttpCallback callback) {
+    bool destroyed = false;
+    _destroyed = &destroyed;
+    callback(*this);
+    if (destroyed) return false;
+    _destroyed = nullptr;
+    return true;
+}
+
+/**
+ * @brief Returns the next raw byte, refilling the stage buffer in one SPI burst.
+ */
+bool HttpRequest::nextRawByte(uint8_t& c) {
+    if (_rxPos >= _rxLength) {
+        _rxLength = _socket.recv(_rx, sizeof(_rx));
+        _rxPos = 0;
+        if (_rxLength == 0) return false;
+    }
+    c = _rx[_rxPos++];
+    return true;
+}
+
+/**
+ * @brief Copies staged bytes first, then reads the rest straight into the caller's buffer.
+ */
+uint16_t HttpRequest::readRaw(uint8_t* buf, uint16_t len) {
+    uint16_t staged = _rxLength - _rxPos;
+    if (staged > len) staged = len;
+    memcpy(buf, _rx + _rxPos, staged);
+    _rxPos += staged;
+
+    if (staged < len) {
+        return staged + _socket.recv(buf + staged, len - staged);
+    }
+    return staged;
+}
+
+/**
+ * @brief Parses chunk framing until chunk data is next.
+ * @return true if chunk data can be read now; false if more bytes are needed or the body ended.
+ */
+bool HttpRequest::chunkReady() {
+    uint8_t c;
+    while (_chunkState != CHUNK_DATA) {
+        if (_chunkState == CHUNK_FINISHED || !nextRawByte(c)) {
+            return false;
+        }
+
+        switch (_chunkState) {
+            case CHUNK_SIZE: {
+                int digit = hexValue(c);
+                if (digit >= 0) {
+                    _chunkRemaining = (_chunkRemaining << 4) | (unsigned long)digit;
+                    break;
+                }
+                if (c != '\n') {
+                    _chunkState = CHUNK_EXTENSION; // ';' extensions or the CR before LF.
+                    break;
+                }
+                // A bare LF ends the size line.
+            }
+            // Fall through.
+            case CHUNK_EXTENSION:
+                if (c == '\n') {
+                    _lineLength = 0;
+                    _chunkState = (_chunkRemaining == 0) ? CHUNK_TRAILER : CHUNK_DATA;
+                }
+                break;
+
+            case CHUNK_DATA_END:
+                if (c == '\n') {
+                    _chunkRemaining = 0;
+                    _chunkState = CHUNK_SIZE;
+                }
+                break;
+
+            case CHUNK_TRAILER:
+                if (c == '\n') {
+                    if (_lineLength == 0) _chunkState = CHUNK_FINISHED;
+                    _lineLength = 0;
+                } else if (c != '\r' && _lineLength < 255) {
+                    _lineLength++;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+bool HttpRequest::bodyComplete() {
+    if (_state != HTTP_BODY) return false;
+    if (_chunked) {
+        chunkReady(); // Consumes a trailing last-chunk the reader has not reached yet.
+        return _chunkState == CHUNK_FINISHED;
+    }
+    return _contentLength >= 0 && _bodyRemaining == 0;
+}
+
+void HttpRequest::finish() {
+    _socket.close();
+    _state = HTTP_DONE;
+    _port = 0;
+    if (_onComplete) _onComplete(*this);
+}
+
+void HttpRequest::fail(HttpError error) {
+    _socket.close();
+    _error = error;
+    _state = HTTP_ERROR;
+    _port = 0;
+    if (_onError) _onError(*this);
+}
+
+} // namespace SimpleNet
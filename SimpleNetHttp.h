@@ -0,0 +1,187 @@
+#ifndef SIMPLE_NET_HTTP_H
+#define SIMPLE_NET_HTTP_H
+
+#include <Arduino.h>
+#include "SimpleNetManager.h"
+#include "SimpleNetSocket.h"
+
+#ifndef SIMPLE_NET_HTTP_HEAD_SIZE
+#define SIMPLE_NET_HTTP_HEAD_SIZE 192 ///< Buffer for the request line and headers.
+#endif
+
+#ifndef SIMPLE_NET_HTTP_RX_SIZE
+#define SIMPLE_NET_HTTP_RX_SIZE 64 ///< Staging buffer for parsing response headers.
+#endif
+
+namespace SimpleNet {
+
+/**
+ * @brief Progress of an HttpRequest.
+ */
+enum HttpState {
+    HTTP_IDLE,       ///< Not started, or finished and reset.
+    HTTP_CONNECTING, ///< TCP handshake in progress.
+    HTTP_SENDING,    ///< Request head and body are being queued to the chip.
+    HTTP_HEADERS,    ///< Waiting for and parsing the response headers.
+    HTTP_BODY,       ///< Response body is being delivered.
+    HTTP_DONE,       ///< Response complete; see statusCode().
+    HTTP_ERROR       ///< The request failed; see error().
+};
+
+/**
+ * @brief Reasons an HttpRequest can fail.
+ */
+enum HttpError {
+    HTTP_ERROR_NONE,         ///< No error.
+    HTTP_ERROR_NOT_CONNECTED,///< The manager was not in NET_CONNECTED.
+    HTTP_ERROR_NO_SOCKET,    ///< No free hardware socket.
+    HTTP_ERROR_CONNECT,      ///< The server refused or did not answer the connection.
+    HTTP_ERROR_TIMEOUT,      ///< No progress within the timeout.
+    HTTP_ERROR_PROTOCOL,     ///< The response could not be parsed.
+    HTTP_ERROR_OVERFLOW,     ///< The request head did not fit SIMPLE_NET_HTTP_HEAD_SIZE.
+    HTTP_ERROR_NETWORK_DOWN  ///< The manager left NET_CONNECTED during the request.
+};
+
+class HttpRequest;
+
+/// Callback type for HttpRequest events.
+typedef void (*HttpCallback)(HttpRequest& request);
+
+/**
+ * @brief An asynchronous HTTP/1.1 request advanced by SimpleNetManager::loop().
+ * @details Each loop() tick moves the request forward by whatever the chip allows
+ * right now and returns: the connect is issued without waiting, the request head
+ * is written from one buffer in as few SPI bursts as possible, and the body is
+ * read in bulk with read(buf, len). Chunked transfer encoding is decoded.
+ *
+ * Typical use: begin(), optional addHeader()/setBody(), then send(). Read the body
+ * from the onData callback; the request finishes with onComplete or onError.
+ */
+class HttpRequest : public NetService {
+public:
+    explicit HttpRequest(SimpleNetManagerBase& manager);
+    ~HttpRequest();
+
+    /**
+     * @brief Prepares a new request. Any request in progress is aborted.
+     * @param ip The server address.
+     * @param port The server port (usually 80).
+     * @param host The value of the Host header.
+     * @param method The HTTP method, e.g. "GET" or "POST".
+     * @param path The request path, e.g. "/".
+     * @return false if the request line did not fit the head buffer.
+     */
+    bool begin(IPAddress ip, uint16_t port, const char* host, const char* method, const char* path);
+
+    /**
+     * @brief Appends a request header. Call between begin() and send().
+     */
+    bool addHeader(const char* name, const char* value);
+
+    /**
+     * @brief Sets a request body. The buffer must stay valid until the request finishes.
+     */
+    void setBody(const uint8_t* body, uint16_t length);
+
+    /**
+     * @brief Starts the request. Returns immediately; loop() does the rest.
+     * @return false if the request could not be started (see error()).
+     */
+    bool send();
+
+    /**
+     * @brief Closes the connection and returns to HTTP_IDLE without callbacks.
+     */
+    void abort();
+
+    /**
+     * @brief Sets the inactivity timeout in milliseconds (default 10,000).
+     */
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+
+    void onData(HttpCallback callback) { _onData = callback; }
+    void onComplete(HttpCallback callback) { _onComplete = callback; }
+    void onError(HttpCallback callback) { _onError = callback; }
+
+    HttpState state() const { return _state; }
+    HttpError error() const { return _error; }
+    bool      isBusy() const { return _state > HTTP_IDLE && _state < HTTP_DONE; }
+    int       statusCode() const { return _statusCode; }
+
+    /**
+     * @brief Returns the Content-Length of the response, or -1 if not given.
+     */
+    long contentLength() const { return _contentLength; }
+
+    /**
+     * @brief Returns the number of received bytes waiting (including chunk framing).
+     */
+    int available();
+
+    /**
+     * @brief Reads up to len body bytes, straight from the chip where possible.
+     * @return The number of body bytes copied into buf.
+     */
+    int read(uint8_t* buf, uint16_t len);
+
+protected:
+    void poll() override;
+    void networkDown() override;
+    unsigned long wakeDelay() override { return isBusy() ? 0 : NET_WAKE_NEVER; }
+
+private:
+    enum ChunkState { CHUNK_SIZE, CHUNK_EXTENSION, CHUNK_DATA, CHUNK_DATA_END, CHUNK_TRAILER, CHUNK_FINISHED };
+
+    SimpleNetManagerBase& _manager;
+    NetSocket      _socket;
+    HttpState      _state;
+    HttpError      _error;
+
+    IPAddress      _ip;
+    uint16_t       _port;
+    char           _head[SIMPLE_NET_HTTP_HEAD_SIZE];
+    uint16_t       _headLength;
+    uint16_t       _headSent;
+    bool           _headOverflow;
+    bool           _headOnly;
+    const uint8_t* _body;
+    uint16_t       _bodyLength;
+    uint16_t       _bodySent;
+
+    uint8_t        _rx[SIMPLE_NET_HTTP_RX_SIZE];
+    uint8_t        _rxPos;
+    uint8_t        _rxLength;
+    char           _line[48];
+    uint8_t        _lineLength;
+    bool           _statusLine;
+
+    int            _statusCode;
+    long           _contentLength;
+    unsigned long  _bodyRemaining;
+    bool           _chunked;
+    ChunkState     _chunkState;
+    unsigned long  _chunkRemaining;
+
+    unsigned long  _timeout;
+    unsigned long  _lastProgress;
+
+    HttpCallback   _onData;
+    HttpCallback   _onComplete;
+    HttpCallback   _onError;
+    bool*          _destroyed; ///< Set by the destructor while notify() runs a callback.
+
+    bool appendHead(const char* text);
+    bool parseHeaders(bool& failed);
+    bool headerLine();
+    bool notify(HttpCallback callback);
+    bool nextRawByte(uint8_t& c);
+    uint16_t readRaw(uint8_t* buf, uint16_t len);
+    bool chunkReady();
+    bool bodyComplete();
+    void finish();
+    void fail(HttpError error);
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_HTTP_H
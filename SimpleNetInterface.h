@@ -0,0 +1,62 @@
+#ifndef SIMPLE_NET_INTERFACE_H
+#define SIMPLE_NET_INTERFACE_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include "SimpleNetManager.h"
+
+namespace SimpleNet {
+
+/**
+ * @brief A network interface as seen by NetFailover: something to drive, a health
+ * flag and a TCP client.
+ * @details Backends other than the W5x00 (an ENC28J60 library, WiFi, a cellular
+ * modem) are added by implementing these three methods. loop() must not block;
+ * isUp() should turn false as soon as the backend knows the link is gone, since
+ * that sets how quickly traffic moves to another interface.
+ */
+class NetInterface {
+public:
+    virtual ~NetInterface() {}
+
+    /**
+     * @brief Advances the interface's own connection handling by one tick.
+     */
+    virtual void loop() = 0;
+
+    /**
+     * @brief Returns true while the interface can carry traffic.
+     */
+    virtual bool isUp() = 0;
+
+    /**
+     * @brief Returns the TCP client that sends through this interface.
+     */
+    virtual Client& client() = 0;
+};
+
+/**
+ * @brief Adapts a SimpleNetManager (any SimpleNetManagerT) to NetInterface.
+ * @details The manager keeps doing all of its own work (DHCP, retries, services,
+ * events); the adapter only forwards to it. The manager's link check interval
+ * (see setHealthCheckIntervals()) bounds how long a cable pull goes unnoticed.
+ * @tparam Manager The manager type, SimpleNetManager by default.
+ */
+template <class Manager = SimpleNetManager>
+class EthernetInterface : public NetInterface {
+public:
+    explicit EthernetInterface(Manager& manager) : _manager(manager) {}
+
+    void    loop() override { _manager.loop(); }
+    bool    isUp() override { return _manager.isConnected(); }
+    Client& client() override { return _manager.getClient(); }
+
+    Manager& manager() { return _manager; }
+
+private:
+    Manager& _manager;
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_INTERFACE_H
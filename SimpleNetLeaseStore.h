@@ -0,0 +1,50 @@
+#ifndef SIMPLE_NET_LEASE_STORE_H
+#define SIMPLE_NET_LEASE_STORE_H
+
+#include <Arduino.h>
+
+namespace SimpleNet {
+
+/**
+ * @brief The part of a DHCP lease worth keeping across a reset.
+ * @details Plain bytes only, so a store can copy the struct as it is. On 32-bit
+ * targets leaseTime is preceded by two bytes of padding; getLease() zeroes them, so
+ * an unchanged lease always has the same bytes. There is no clock that survives a
+ * reset, so leaseTime is the duration granted rather than an expiry; whether the
+ * address is still valid is for the server to decide.
+ */
+struct DhcpLease {
+    uint8_t  mac[6];      ///< Client hardware address the lease was granted to.
+    uint8_t  localIp[4];  ///< The leased address.
+    uint8_t  serverId[4]; ///< The server that granted it.
+    uint32_t leaseTime;   ///< Lease duration in seconds.
+};
+
+/**
+ * @brief Non-volatile storage for the last DHCP lease.
+ * @details Implement this to keep the lease in EEPROM, flash or a file. The manager
+ * calls save() whenever a lease is granted or extended, so implementations should
+ * skip the write when nothing changed. See EepromLeaseStore for a ready-made one.
+ */
+class LeaseStore {
+public:
+    /**
+     * @brief Reads the stored lease.
+     * @return false if nothing valid is stored.
+     */
+    virtual bool load(DhcpLease& lease) = 0;
+
+    /**
+     * @brief Stores the lease, replacing any previous one.
+     */
+    virtual void save(const DhcpLease& lease) = 0;
+
+    /**
+     * @brief Invalidates the stored lease.
+     */
+    virtual void clear() = 0;
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_LEASE_STORE_H
@@ -0,0 +1,175 @@
+#include "SimpleNetLog.h"
+
+namespace SimpleNet {
+
+#if SIMPLE_NET_LOG_TEXT
+// How an entry's argument is printed after the message.
+enum LogArg : uint8_t { ARG_NONE, ARG_NUMBER, ARG_IP, ARG_MODE };
+
+static const char MSG_CS_PIN[] PROGMEM = "Using CS pin: ";
+static const char MSG_INIT_DHCP[] PROGMEM = "Initialized for DHCP.";
+static const char MSG_INIT_STATIC[] PROGMEM = "Initialized for Static IP.";
+static const char MSG_CONNECTING[] PROGMEM = "Attempting connection... Mode: ";
+static const char MSG_LINK_LOST[] PROGMEM = "Physical link lost.";
+static const char MSG_CHIP_REINIT[] PROGMEM = "Re-initializing Ethernet chip.";
+static const char MSG_STATIC_UP[] PROGMEM = "Static IP link up.";
+static const char MSG_STATIC_TIMEOUT[] PROGMEM = "Static IP link timed out.";
+static const char MSG_PREVIOUS_ADDRESS[] PROGMEM = "Requesting previous address: ";
+static const char MSG_DHCP_OK[] PROGMEM = "DHCP connection successful. IP: ";
+static const char MSG_DHCP_FAILED[] PROGMEM = "DHCP connection failed.";
+static const char MSG_LEASE_LOST[] PROGMEM = "DHCP lease lost.";
+static const char MSG_ADDRESS_CONFLICT[] PROGMEM = "Address already in use: ";
+static const char MSG_GATEWAY_UNRESOLVED[] PROGMEM = "Gateway did not answer ARP.";
+static const char MSG_SPI_CLOCK[] PROGMEM = "SPI clock (Hz): ";
+static const char MSG_SPI_FALLBACK[] PROGMEM = "SPI read-back failed, clock lowered to (Hz): ";
+
+// Indexed by the low five bits of a NetLogCode.
+static const char* const MESSAGES[] PROGMEM = {
+    MSG_CS_PIN, MSG_INIT_DHCP, MSG_INIT_STATIC, MSG_CONNECTING, MSG_LINK_LOST, MSG_CHIP_REINIT,
+    MSG_STATIC_UP, MSG_STATIC_TIMEOUT, MSG_PREVIOUS_ADDRESS, MSG_DHCP_OK, MSG_DHCP_FAILED, MSG_LEASE_LOST,
+    MSG_ADDRESS_CONFLICT, MSG_GATEWAY_UNRESOLVED, MSG_SPI_CLOCK, MSG_SPI_FALLBACK
+};
+static const uint8_t ARGS[] PROGMEM = {
+    ARG_NUMBER, ARG_NONE, ARG_NONE, ARG_MODE, ARG_NONE, ARG_NONE,
+    ARG_NONE, ARG_NONE, ARG_IP, ARG_IP, ARG_NONE, ARG_NONE,
+    ARG_IP, ARG_NONE, ARG_NUMBER, ARG_NUMBER
+};
+static const uint8_t MESSAGE_COUNT = sizeof(ARGS);
+#endif
+
+/**
+ * @brief A Print that fills a fixed character buffer and drops what does not fit.
+ */
+class LineWriter : public Print {
+public:
+    LineWriter(char* buffer, uint8_t size) : _buffer(buffer), _size(size), _length(0) {}
+
+    size_t write(uint8_t c) override {
+        if (_length >= _size) return 0;
+        _buffer[_length++] = c;
+        return 1;
+    }
+    using Print::write;
+
+    uint8_t length() const { return _length; }
+
+private:
+    char*   _buffer;
+    uint8_t _size;
+    uint8_t _length;
+};
+
+void netLogPrint(Print& out, uint8_t code, uint32_t arg) {
+#if SIMPLE_NET_LOG_TEXT
+    uint8_t index = code & 0x1F;
+    if (index < MESSAGE_COUNT) {
+        out.print(F("[NetManager] "));
+        out.print((const __FlashStringHelper*)pgm_read_ptr(&MESSAGES[index]));
+        switch (pgm_read_byte(&ARGS[index])) {
+            case ARG_NUMBER: out.print((unsigned long)arg); break;
+            case ARG_IP:     out.print(IPAddress(arg)); break;
+            case ARG_MODE:   out.print(arg ? F("Static") : F("DHCP")); break;
+            default:         break;
+        }
+        out.println();
+        return;
+    }
+#endif
+    out.print(F("NL,"));
+    out.print(code);
+    out.print(',');
+    out.println((unsigned long)arg);
+}
+
+NetDebugLog::NetDebugLog(Stream* stream) {
+    _stream = stream;
+    _level = NET_LOG_DEBUG;
+    _head = 0;
+    _count = 0;
+    _dropped = 0;
+    _lineLength = 0;
+    _linePos = 0;
+}
+
+/**
+ * @brief Queues an entry; when the ring is full the oldest one is overwritten.
+ */
+void NetDebugLog::log(uint8_t code, uint32_t arg) {
+    if (!_stream || netLogLevel(code) > _level) {
+        return;
+    }
+
+    uint8_t slot;
+    if (_count == SIMPLE_NET_LOG_SIZE) {
+        slot = _head;
+        _head = (_head + 1) % SIMPLE_NET_LOG_SIZE;
+        _dropped++;
+    } else {
+        slot = (_head + _count) % SIMPLE_NET_LOG_SIZE;
+        _count++;
+    }
+    _entries[slot].time = millis();
+    _entries[slot].arg = arg;
+    _entries[slot].code = code;
+}
+
+/**
+ * @brief Writes as much of the queued output as the stream takes without blocking.
+ */
+void NetDebugLog::drain() {
+    if (!_stream) {
+        return;
+    }
+
+    for (;;) {
+        if (_linePos >= _lineLength && !nextLine()) {
+            return;
+        }
+        int room = _stream->availableForWrite();
+        if (room <= 0) {
+            return;
+        }
+        uint8_t length = _lineLength - _linePos;
+        if ((int)length > room) length = room;
+        _stream->write((const uint8_t*)_line + _linePos, length);
+        _linePos += length;
+    }
+}
+
+void NetDebugLog::flush() {
+    if (!_stream) {
+        return;
+    }
+
+    do {
+        _stream->write((const uint8_t*)_line + _linePos, _lineLength - _linePos);
+        _linePos = _lineLength;
+    } while (nextLine());
+}
+
+/**
+ * @brief Private method to format the oldest entry into the line buffer, prefixed with its time.
+ */
+bool NetDebugLog::nextLine() {
+    if (_count == 0) {
+        return false;
+    }
+
+    const Entry& entry = _entries[_head];
+    LineWriter line(_line, sizeof(_line));
+    line.print(entry.time);
+    line.print(' ');
+    netLogPrint(line, entry.code, entry.arg);
+    _head = (_head + 1) % SIMPLE_NET_LOG_SIZE;
+    _count--;
+
+    _lineLength = line.length();
+    if (_lineLength == sizeof(_line)) {
+        _line[_lineLength - 2] = '\r'; // Truncated: keep the line ending.
+        _line[_lineLength - 1] = '\n';
+    }
+    _linePos = 0;
+    return true;
+}
+
+} // namespace SimpleNet
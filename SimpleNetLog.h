@@ -0,0 +1,145 @@
+#ifndef SIMPLE_NET_LOG_H
+#define SIMPLE_NET_LOG_H
+
+#include <Arduino.h>
+
+#ifndef SIMPLE_NET_LOG_SIZE
+#define SIMPLE_NET_LOG_SIZE 8 ///< Log entries NetDebugLog buffers before the oldest is dropped.
+#endif
+
+#ifndef SIMPLE_NET_LOG_LEVEL
+#define SIMPLE_NET_LOG_LEVEL NET_LOG_DEBUG ///< Most detailed level compiled in; codes above it cost nothing.
+#endif
+
+#ifndef SIMPLE_NET_LOG_TEXT
+#define SIMPLE_NET_LOG_TEXT 1 ///< Set to 0 to print "NL,<code>,<arg>" lines and drop the message table from flash.
+#endif
+
+namespace SimpleNet {
+
+/**
+ * @brief Severity of a log entry; lower is more severe.
+ */
+enum NetLogLevel {
+    NET_LOG_ERROR,
+    NET_LOG_WARN,
+    NET_LOG_INFO,
+    NET_LOG_DEBUG
+};
+
+/// Builds a log code from its level (top three bits) and its index in the message table.
+#define SIMPLE_NET_LOG_CODE(level, index) (((level) << 5) | (index))
+
+/**
+ * @brief Compact event codes the manager logs instead of formatted strings.
+ */
+enum NetLogCode {
+    NET_LOG_CS_PIN           = SIMPLE_NET_LOG_CODE(NET_LOG_DEBUG, 0), ///< arg: the CS pin.
+    NET_LOG_INIT_DHCP        = SIMPLE_NET_LOG_CODE(NET_LOG_INFO, 1),
+    NET_LOG_INIT_STATIC      = SIMPLE_NET_LOG_CODE(NET_LOG_INFO, 2),
+    NET_LOG_CONNECTING       = SIMPLE_NET_LOG_CODE(NET_LOG_INFO, 3),  ///< arg: 1 static IP, 0 DHCP.
+    NET_LOG_LINK_LOST        = SIMPLE_NET_LOG_CODE(NET_LOG_WARN, 4),
+    NET_LOG_CHIP_REINIT      = SIMPLE_NET_LOG_CODE(NET_LOG_WARN, 5),
+    NET_LOG_STATIC_UP        = SIMPLE_NET_LOG_CODE(NET_LOG_INFO, 6),
+    NET_LOG_STATIC_TIMEOUT   = SIMPLE_NET_LOG_CODE(NET_LOG_WARN, 7),
+    NET_LOG_PREVIOUS_ADDRESS = SIMPLE_NET_LOG_CODE(NET_LOG_DEBUG, 8), ///< arg: the stored IP.
+    NET_LOG_DHCP_OK          = SIMPLE_NET_LOG_CODE(NET_LOG_INFO, 9),  ///< arg: the leased IP.
+    NET_LOG_DHCP_FAILED      = SIMPLE_NET_LOG_CODE(NET_LOG_ERROR, 10),
+    NET_LOG_LEASE_LOST       = SIMPLE_NET_LOG_CODE(NET_LOG_WARN, 11),
+    NET_LOG_ADDRESS_CONFLICT = SIMPLE_NET_LOG_CODE(NET_LOG_ERROR, 12), ///< arg: the static IP.
+    NET_LOG_GATEWAY_UNRESOLVED = SIMPLE_NET_LOG_CODE(NET_LOG_WARN, 13),
+    NET_LOG_SPI_CLOCK        = SIMPLE_NET_LOG_CODE(NET_LOG_INFO, 14),  ///< arg: the clock in Hz.
+    NET_LOG_SPI_FALLBACK     = SIMPLE_NET_LOG_CODE(NET_LOG_WARN, 15)   ///< arg: the new clock in Hz.
+};
+
+/**
+ * @brief Returns the level a log code was defined with.
+ */
+constexpr NetLogLevel netLogLevel(uint8_t code) { return (NetLogLevel)(code >> 5); }
+
+/**
+ * @brief Prints one log entry as a line: the message text, or the numeric form when
+ * SIMPLE_NET_LOG_TEXT is 0.
+ */
+void netLogPrint(Print& out, uint8_t code, uint32_t arg);
+
+/**
+ * @brief Debug policy that prints each message to the stream as it happens.
+ * @details This is the synchronous behaviour: the caller waits while the UART sends
+ * the line. setLevel() filters at run time.
+ */
+class NetDebugStream {
+public:
+    explicit NetDebugStream(Stream* stream) : _stream(stream), _level(NET_LOG_DEBUG) {}
+
+    void setLevel(NetLogLevel level) { _level = level; }
+    void log(uint8_t code, uint32_t arg) {
+        if (_stream && netLogLevel(code) <= _level) netLogPrint(*_stream, code, arg);
+    }
+    void drain() {}
+
+private:
+    Stream* _stream;
+    uint8_t _level;
+};
+
+/**
+ * @brief Debug policy that removes all debug output, its strings and the stream pointer.
+ * @details A stream passed to the constructor is ignored, so switching the policy
+ * needs no other change to the sketch.
+ */
+class NetNoDebug {
+public:
+    explicit NetNoDebug(Stream*) {}
+
+    void setLevel(NetLogLevel) {}
+    void log(uint8_t, uint32_t) {}
+    void drain() {}
+};
+
+/**
+ * @brief Debug policy that queues log codes in a ring and prints them when the manager is idle.
+ * @details log() stores a timestamp, the code and one argument: a few assignments,
+ * with no formatting and no UART access. After a loop() pass that finished within
+ * its budget, drain() formats the next entry and writes only as many bytes as the
+ * stream accepts without blocking (Print::availableForWrite()), so a long line
+ * leaves over several ticks. When the ring is full the oldest entry is dropped and
+ * counted in dropped(). flush() prints everything and waits, for setup() or a fault
+ * handler.
+ */
+class NetDebugLog {
+public:
+    explicit NetDebugLog(Stream* stream);
+
+    void setLevel(NetLogLevel level) { _level = level; }
+    void log(uint8_t code, uint32_t arg);
+    void drain();
+    void flush();
+
+    uint8_t       pending() const { return _count; }
+    unsigned long dropped() const { return _dropped; }
+
+private:
+    struct Entry {
+        unsigned long time;
+        uint32_t      arg;
+        uint8_t       code;
+    };
+
+    Stream*       _stream;
+    uint8_t       _level;
+    Entry         _entries[SIMPLE_NET_LOG_SIZE];
+    uint8_t       _head;         ///< Oldest entry.
+    uint8_t       _count;
+    unsigned long _dropped;
+
+    char          _line[64];     ///< The entry being written out.
+    uint8_t       _lineLength;
+    uint8_t       _linePos;
+
+    bool nextLine();
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_LOG_H
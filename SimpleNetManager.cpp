@@ -1,209 +1,697 @@
 #include "SimpleNetManager.h"
 
+#ifndef NOT_AN_INTERRUPT
+#define NOT_AN_INTERRUPT -1 ///< For cores whose digitalPinToInterrupt() has no failure value of its own.
+#endif
+
 namespace SimpleNet {
 
 /**
- * @brief Constructor (Basic): Delegates to the full constructor with CS pin 10 and no debug stream.
+ * @brief Pin interrupts of all managers: the counter each one bumps and its pin.
+ * @details attachInterrupt() takes a plain function, so every slot has its own
+ * handler, countPinInterrupt<Slot>, which counts into the counter of the manager
+ * that claimed the slot. Four slots cover a link pin and INTn for two managers.
+ */
+static const uint8_t PIN_INTERRUPT_SLOTS = 4;
+
+struct PinInterruptSlot {
+    volatile uint8_t* counter; ///< nullptr while the slot is free.
+    uint8_t           pin;
+};
+
+static PinInterruptSlot pinInterruptSlots[PIN_INTERRUPT_SLOTS];
+
+template <uint8_t Slot>
+static void countPinInterrupt() {
+    (*pinInterruptSlots[Slot].counter)++;
+}
+
+static void (*const pinInterruptHandlers[PIN_INTERRUPT_SLOTS])() = {
+    countPinInterrupt<0>, countPinInterrupt<1>, countPinInterrupt<2>, countPinInterrupt<3>
+};
+
+/**
+ * @brief Releases the slot counting into counter, if any, and detaches its pin.
+ */
+static void detachPinCounter(volatile uint8_t* counter) {
+    for (uint8_t i = 0; i < PIN_INTERRUPT_SLOTS; i++) {
+        if (pinInterruptSlots[i].counter == counter) {
+            detachInterrupt(digitalPinToInterrupt(pinInterruptSlots[i].pin));
+            pinInterruptSlots[i].counter = nullptr;
+        }
+    }
+}
+
+/**
+ * @brief Makes changes on pin count into counter, replacing counter's previous pin.
+ * @return false if the pin has no interrupt, another manager uses it or all slots
+ * are taken. counter then keeps its previous pin.
  */
-SimpleNetManager::SimpleNetManager(byte mac[])
-    : SimpleNetManager(mac, 10, nullptr) { // Default CS pin is 10
+static bool attachPinCounter(uint8_t pin, volatile uint8_t* counter, int mode) {
+    if (digitalPinToInterrupt(pin) == NOT_AN_INTERRUPT) {
+        return false;
+    }
+    for (uint8_t i = 0; i < PIN_INTERRUPT_SLOTS; i++) {
+        if (pinInterruptSlots[i].counter && pinInterruptSlots[i].counter != counter && pinInterruptSlots[i].pin == pin) {
+            return false;
+        }
+    }
+    detachPinCounter(counter);
+    for (uint8_t i = 0; i < PIN_INTERRUPT_SLOTS; i++) {
+        if (!pinInterruptSlots[i].counter) {
+            pinInterruptSlots[i].pin = pin;
+            pinInterruptSlots[i].counter = counter;
+            attachInterrupt(digitalPinToInterrupt(pin), pinInterruptHandlers[i], mode);
+            return true;
+        }
+    }
+    return false;
 }
 
 /**
- * @brief Constructor (MAC + CS Pin): Delegates to the full constructor with no debug stream.
+ * @brief Attaches the service to the manager that will drive it.
  */
-SimpleNetManager::SimpleNetManager(byte mac[], uint8_t csPin)
-    : SimpleNetManager(mac, csPin, nullptr) {
+NetService::NetService(SimpleNetManagerBase& manager) : _owner(manager) {
+    manager.attachService(this);
 }
 
 /**
- * @brief Constructor (MAC + Debug): Delegates to the full constructor with default CS pin 10.
+ * @brief Detaches the service, so the manager no longer polls it.
  */
-SimpleNetManager::SimpleNetManager(byte mac[], Stream* debugStream)
-    : SimpleNetManager(mac, 10, debugStream) { // Default CS pin is 10
+NetService::~NetService() {
+    _owner.detachService(this);
 }
 
 /**
- * @brief Constructor (Full): This is the main constructor that does all the setup work.
+ * @brief Sets up the mode-independent state; the derived template handles the rest.
  */
-SimpleNetManager::SimpleNetManager(byte mac[], uint8_t csPin, Stream* debugStream) {
+SimpleNetManagerBase::SimpleNetManagerBase(const byte mac[]) {
     memcpy(_mac, mac, 6);
-    _csPin = csPin;
-    _debugStream = debugStream;
-    
+
     _currentState = NET_DISCONNECTED;
-    _use_static_ip = false;
     _lastConnectionAttempt = 0;
+    _retryDelay = 0;
+    _retryPolicy.seed(_mac);
+    _lastLinkCheck = 0;
+    _lastLeaseCheck = 0;
+    _services = nullptr;
+    _slice = SLICE_STATE;
+    _resumeService = nullptr;
+    _deferEventDispatch = false;
+    _linkUp = false;
+    _linkChanges = 0;
+    _linkChangesSeen = 0;
+    _chipInterrupts = 0;
+    _chipInterruptsSeen = 0;
+    _interruptPin = NET_CS_RUNTIME;
+    _spiClock = 0;
+    _spiProbe = false;
+    _lowPowerIdle = false;
+    _phyWakeLead = 0;
+    _probeInterval = 0;
+    _probeTimeout = 0;
+    _lastProbe = 0;
+    _probeThreshold = 0;
+    _probeFailures = 0;
+#if SIMPLE_NET_STATS
+    memset(&_stats, 0, sizeof(_stats));
+    _loopMicrosTotal = 0;
+    _connectStart = 0;
+    _uptimeSince = 0;
+#endif
     _onConnectCallback = nullptr;
     _onDisconnectCallback = nullptr;
+
+    _resolver.attach(_chip);
+    _probe.attach(_chip);
+    _phy.attach(_chip);
+    for (uint8_t i = 0; i < SIMPLE_NET_UDP_ENDPOINTS; i++) {
+        _udp[i].attach(_chip);
+    }
 }
 
 /**
- * @brief Initializes for DHCP.
+ * @brief Releases the pin interrupts, so a later manager can claim them.
  */
-void SimpleNetManager::begin() {
-    _use_static_ip = false;
+SimpleNetManagerBase::~SimpleNetManagerBase() {
+    detachPinCounter(&_linkChanges);
+    detachPinCounter(&_chipInterrupts);
+}
 
-    // Always initialize the Ethernet CS pin based on the constructor used.
-    Ethernet.init(_csPin);
-    if (_debugStream) {
-        _debugStream->print(F("[NetManager] Using CS pin: "));
-        _debugStream->println(_csPin);
+/**
+ * @brief Private method for the transition into NET_CONNECTED: events, services, callback.
+ */
+void SimpleNetManagerBase::enterConnected(IPAddress localIp) {
+    _retryPolicy.reset();
+    _lastLinkCheck = millis();
+    _lastLeaseCheck = _lastLinkCheck;
+    _lastProbe = _lastLinkCheck;
+    _probeFailures = 0;
+    if (!_linkUp) {
+        _linkUp = true;
+        _events.publish(NET_EVENT_LINK_UP);
     }
-    
-    _lastConnectionAttempt = millis() - _connectionInterval;
-    if (_debugStream) {
-        _debugStream->println(F("[NetManager] Initialized for DHCP."));
+    _events.publish(NET_EVENT_CONNECTED);
+    checkIpChange(localIp);
+    if (_interruptPin != NET_CS_RUNTIME) {
+        _chip.enableInterrupts(true); // Set up on each connect: a chip reset clears the masks.
+    }
+    for (uint8_t i = 0; i < SIMPLE_NET_UDP_ENDPOINTS; i++) {
+        _udp[i].open();
+    }
+    for (NetService* service = _services; service;) {
+        NetService* next = service->_nextService; // networkUp() may destroy the service.
+        service->networkUp();
+        service = next;
+    }
+    if (_onConnectCallback) {
+        _onConnectCallback();
     }
 }
 
 /**
- * @brief Initializes for Static IP.
+ * @brief Private method for the transition from NET_CONNECTED (or NET_DEGRADED) to NET_DISCONNECTED.
  */
-void SimpleNetManager::begin(IPAddress ip, IPAddress dns, IPAddress gateway, IPAddress subnet) {
-    _use_static_ip = true;
-    _ip = ip;
-    _dns = dns;
-    _gateway = gateway;
-    _subnet = subnet;
-
-    // Always initialize the Ethernet CS pin based on the constructor used.
-    Ethernet.init(_csPin);
-    if (_debugStream) {
-        _debugStream->print(F("[NetManager] Using CS pin: "));
-        _debugStream->println(_csPin);
+void SimpleNetManagerBase::leaveConnected() {
+    _probe.stop();
+    _chip.unpinGateway(); // The next network may route through another gateway.
+    if (_interruptPin != NET_CS_RUNTIME) {
+        _chip.enableInterrupts(false); // Reconnecting may reset the chip; poll until connected.
     }
-    
-    _lastConnectionAttempt = millis() - _connectionInterval;
-    if (_debugStream) {
-        _debugStream->println(F("[NetManager] Initialized for Static IP."));
+    _resolver.flush(); // Cached answers may not hold on the next network.
+    for (uint8_t i = 0; i < SIMPLE_NET_UDP_ENDPOINTS; i++) {
+        _udp[i].close();
     }
+    _events.publish(NET_EVENT_DISCONNECTED);
+    for (NetService* service = _services; service;) {
+        NetService* next = service->_nextService; // networkDown() may destroy the service.
+        service->networkDown();
+        service = next;
+    }
+    if (_onDisconnectCallback) {
+        _onDisconnectCallback();
+    }
+    _lastConnectionAttempt = millis();
 }
 
 /**
- * @brief The main state machine loop to be called repeatedly.
+ * @brief Private method to poll the services, resuming where the last call stopped.
+ * @return true once every service has been polled in this pass; false if the budget
+ * ran out first.
  */
-NetState SimpleNetManager::loop() {
-    NetState previousState = _currentState;
+bool SimpleNetManagerBase::pollServices(unsigned long start, uint16_t budgetMicros) {
+    NetService* service = _resumeService ? _resumeService : _services;
+    while (service) {
+        // Noted before poll(): detachService() moves it on if poll() destroys that service.
+        _resumeService = service->_nextService;
+        service->poll();
+        service = _resumeService;
+        if (service && budgetSpent(start, budgetMicros)) {
+            return false;
+        }
+    }
+    _resumeService = nullptr;
+    return true;
+}
 
-    switch (_currentState) {
-        case NET_DISCONNECTED:
-            if (millis() - _lastConnectionAttempt >= _connectionInterval) {
-                _currentState = NET_CONNECTING;
-                connect();
-            }
-            break;
+/**
+ * @brief Private method for the job slice.
+ */
+void SimpleNetManagerBase::runJobs() {
+    _scheduler.run(millis(), _currentState == NET_CONNECTED);
+}
 
-        case NET_CONNECTING:
-            // This state is transient and handled within the connect() method.
-            break;
+/**
+ * @brief Private method for the event slice.
+ */
+void SimpleNetManagerBase::dispatchEvent() {
+    // One event per pass keeps slow listeners from stacking up inside a single call.
+    if (!_deferEventDispatch) {
+        _events.dispatch(1);
+    }
+}
 
-        case NET_CONNECTED:
-            uint8_t maintain_status = Ethernet.maintain();
-            if (maintain_status == 1 || maintain_status == 3) {
-                if (_debugStream) _debugStream->println(F("[NetManager] DHCP lease lost."));
-                _currentState = NET_DISCONNECTED;
-            }
-
-            if (Ethernet.linkStatus() != LinkON) {
-                if (_debugStream) _debugStream->println(F("[NetManager] Physical link lost."));
-                _currentState = NET_DISCONNECTED;
-            }
-            break;
+/**
+ * @brief Private method for the part of nextWakeMs() that does not depend on the mode.
+ */
+unsigned long SimpleNetManagerBase::serviceWakeDelay() {
+    if (_linkChanges != _linkChangesSeen || (!_deferEventDispatch && _events.pending() > 0)) {
+        return 0;
+    }
+    if (_chip.interruptsEnabled() && (_chipInterrupts != _chipInterruptsSeen || digitalRead(_interruptPin) == LOW)) {
+        return 0;
+    }
+    if ((_currentState == NET_CONNECTED || _currentState == NET_DEGRADED) && _resolver.pending() > 0) {
+        return 0;
     }
 
-    if (_currentState != previousState) {
-        if (_currentState == NET_CONNECTED) {
-            if (_onConnectCallback) {
-                _onConnectCallback();
-            }
-        } else if (_currentState == NET_DISCONNECTED && previousState == NET_CONNECTED) {
-            if (_onDisconnectCallback) {
-                _onDisconnectCallback();
-            }
-            _lastConnectionAttempt = millis();
-        }
+    unsigned long wake = _scheduler.wakeDelay(millis(), _currentState == NET_CONNECTED);
+    for (NetService* service = _services; service; service = service->_nextService) {
+        unsigned long delay = service->wakeDelay();
+        if (delay < wake) wake = delay;
     }
+    return wake;
+}
 
-    return _currentState;
+/**
+ * @brief Private method to power the PHY down while a retry is far off, and back up
+ * wakeLead milliseconds before it so the link has negotiated by the attempt.
+ */
+void SimpleNetManagerBase::idlePhy(unsigned long untilRetry) {
+    if (!_lowPowerIdle) {
+        return;
+    }
+
+    if (untilRetry > _phyWakeLead) {
+        _phy.powerDown();
+    } else {
+        _phy.powerUp();
+    }
 }
 
 /**
- * @brief Private method to handle the actual connection attempt.
+ * @brief Private method turning the time until a retry into the time until loop()
+ * next has to run, which is earlier when the PHY must be powered up first.
  */
-void SimpleNetManager::connect() {
-    _lastConnectionAttempt = millis();
-    if (_debugStream) {
-        _debugStream->print(F("[NetManager] Attempting connection... Mode: "));
-        _debugStream->println(_use_static_ip ? "Static" : "DHCP");
-    }
-
-    bool success = false;
-    if (_use_static_ip) {
-        Ethernet.begin(_mac, _ip, _dns, _gateway, _subnet);
-        // For static, success is assumed until link status check fails in loop().
-        // A short delay might be needed for link to establish, which the non-blocking
-        // loop naturally handles. We tentatively move to CONNECTED.
-        if (Ethernet.linkStatus() == LinkON) {
-             _currentState = NET_CONNECTED;
-        } else {
-            // If link is not on, we go back to disconnected to retry.
-             _currentState = NET_DISCONNECTED;
+unsigned long SimpleNetManagerBase::idleWakeDelay(unsigned long untilRetry) const {
+    if (!_phy.isPoweredDown()) {
+        return untilRetry;
+    }
+    return untilRetry > _phyWakeLead ? untilRetry - _phyWakeLead : 0;
+}
+
+/**
+ * @brief Private method to start a due probe or collect its result, moving between
+ * NET_CONNECTED and NET_DEGRADED.
+ */
+void SimpleNetManagerBase::runProbe(unsigned long now) {
+    if (_probeInterval == 0) {
+        if (_currentState == NET_DEGRADED) { // The probe was switched off while degraded.
+            _currentState = NET_CONNECTED;
+            _events.publish(NET_EVENT_RECOVERED);
         }
-    } else { // DHCP
-        if (Ethernet.begin(_mac) == 1) {
-            success = true;
+        return;
+    }
+
+    if (!_probe.isRunning()) {
+        if (now - _lastProbe >= _probeInterval) {
+            _lastProbe = now;
+            IPAddress target = _probeTarget == IPAddress(0, 0, 0, 0) ? _chip.gateway() : _probeTarget;
+            _probe.start(target, _probeTimeout); // No free socket: try again next interval.
         }
+        return;
     }
-    
-    if (!_use_static_ip) {
-        if (success && Ethernet.localIP() != IPAddress(0,0,0,0)) {
+
+    NetProbeResult result = _probe.poll();
+    if (result == NET_PROBE_OK) {
+        _probeFailures = 0;
+        if (_currentState == NET_DEGRADED) {
             _currentState = NET_CONNECTED;
-            if (_debugStream) {
-                _debugStream->print(F("[NetManager] DHCP connection successful. IP: "));
-                _debugStream->println(Ethernet.localIP());
-            }
-        } else {
-            _currentState = NET_DISCONNECTED;
-            if (_debugStream) _debugStream->println(F("[NetManager] DHCP connection failed."));
+            _events.publish(NET_EVENT_RECOVERED);
+        }
+    } else if (result == NET_PROBE_FAILED) {
+        if (_probeFailures < 255) _probeFailures++;
+        if (_currentState == NET_CONNECTED && _probeFailures >= _probeThreshold) {
+            _currentState = NET_DEGRADED;
+            SIMPLE_NET_STAT(_stats.degradedCount++);
+            _events.publish(NET_EVENT_DEGRADED);
         }
     }
 }
 
+/**
+ * @brief Private method for the probe's part of nextWakeMs().
+ */
+unsigned long SimpleNetManagerBase::probeWakeDelay(unsigned long now) const {
+    if (_probeInterval == 0) {
+        return NET_WAKE_NEVER;
+    }
+    if (_probe.isRunning()) {
+        return 0;
+    }
+    return now - _lastProbe >= _probeInterval ? 0 : _probeInterval - (now - _lastProbe);
+}
+
+/**
+ * @brief Private method to publish NET_EVENT_IP_CHANGED when the address differs from the last one.
+ */
+void SimpleNetManagerBase::checkIpChange(IPAddress localIp) {
+    if (localIp != _lastIp) {
+        _lastIp = localIp;
+        _events.publish(NET_EVENT_IP_CHANGED);
+    }
+}
 
 /**
  * @brief Returns true if the current state is CONNECTED.
  */
-bool SimpleNetManager::isConnected() {
+bool SimpleNetManagerBase::isConnected() {
     return _currentState == NET_CONNECTED;
 }
 
 /**
  * @brief Returns a reference to the internal EthernetClient object.
  */
-EthernetClient& SimpleNetManager::getClient() {
+EthernetClient& SimpleNetManagerBase::getClient() {
     return _client;
 }
 
 /**
- * @brief Sets the connection retry interval.
+ * @brief Returns the manager's UDP endpoint for a local port, assigning a free one if needed.
+ * @details The endpoint's socket is opened now if connected, and otherwise on the next
+ * transition into NET_CONNECTED. It is closed whenever the connection is lost.
+ * @return nullptr if port is 0 or all SIMPLE_NET_UDP_ENDPOINTS endpoints are taken.
+ */
+UdpEndpoint* SimpleNetManagerBase::getUdp(uint16_t port) {
+    if (port == 0) {
+        return nullptr;
+    }
+
+    UdpEndpoint* endpoint = nullptr;
+    for (uint8_t i = 0; i < SIMPLE_NET_UDP_ENDPOINTS; i++) {
+        if (_udp[i]._port == port) {
+            endpoint = &_udp[i];
+            break;
+        }
+        if (!endpoint && _udp[i]._port == 0) {
+            endpoint = &_udp[i];
+        }
+    }
+    if (!endpoint) {
+        return nullptr;
+    }
+
+    endpoint->_port = port;
+    if (_currentState == NET_CONNECTED || _currentState == NET_DEGRADED) {
+        endpoint->open(); // Also retries an endpoint that found no free socket earlier.
+    }
+    return endpoint;
+}
+
+/**
+ * @brief Resolves a hostname without blocking, using the DNS server of the current
+ * configuration. Cached names and dotted-decimal addresses are answered at once.
+ * @return false if not connected, the name is too long, or too many lookups are pending.
+ */
+bool SimpleNetManagerBase::resolve(const char* host, DnsCallback callback, void* context) {
+    if (_currentState != NET_CONNECTED) {
+        return false;
+    }
+    return _resolver.resolve(host, callback, context);
+}
+
+/**
+ * @brief Private method to link a service into the list driven by loop().
+ */
+void SimpleNetManagerBase::attachService(NetService* service) {
+    service->_nextService = _services;
+    _services = service;
+}
+
+/**
+ * @brief Private method to unlink a service that is being destroyed.
+ */
+void SimpleNetManagerBase::detachService(NetService* service) {
+    if (_resumeService == service) {
+        _resumeService = service->_nextService;
+    }
+    for (NetService** link = &_services; *link; link = &(*link)->_nextService) {
+        if (*link == service) {
+            *link = service->_nextService;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Sets a fixed connection retry interval (no backoff, no jitter).
+ */
+void SimpleNetManagerBase::setConnectionRetryInterval(long interval) {
+    _retryPolicy = RetryPolicy(interval, interval, 1, 0);
+    _retryPolicy.seed(_mac);
+}
+
+/**
+ * @brief Sets the backoff policy used to schedule reconnection attempts.
+ */
+void SimpleNetManagerBase::setRetryPolicy(const RetryPolicy& policy) {
+    _retryPolicy = policy;
+    _retryPolicy.seed(_mac);
+}
+
+/**
+ * @brief Sets how often the link and the DHCP lease are checked while connected.
+ * @details An interval of 0 checks on every loop() call.
+ */
+void SimpleNetManagerBase::setHealthCheckIntervals(unsigned long linkInterval, unsigned long leaseInterval) {
+    _linkCheckInterval = linkInterval;
+    _leaseCheckInterval = leaseInterval;
+}
+
+/**
+ * @brief Polls the link as soon as the given pin changes (e.g. a PHY link LED line).
+ * @details The link interval still applies as a fallback poll, so it can be raised
+ * considerably once the pin is wired. Each manager counts changes on its own pin,
+ * so only the manager whose link moved checks it. Calling this again moves the
+ * interrupt to the new pin.
+ * @return false if the pin has no interrupt, another manager uses it, or all four
+ * pin interrupts the managers share (see setInterruptPin()) are taken.
+ */
+bool SimpleNetManagerBase::setLinkInterruptPin(uint8_t pin) {
+    pinMode(pin, INPUT);
+    _linkChangesSeen = _linkChanges;
+    return attachPinCounter(pin, &_linkChanges, CHANGE);
+}
+
+/**
+ * @brief Takes socket events from the chip's INTn line (active low) on the given pin.
+ * @details W5500 only. While connected, the chip raises INTn for events on the
+ * sockets of this library (DHCP, DNS, UDP endpoints and the services); loop() then
+ * reads the interrupt registers once instead of each socket's status and receive
+ * size. Between events, services that poll their sockets cost no SPI transfer.
+ * The chip has no link interrupt, so the link and lease checks stay polled, and
+ * EthernetClient sockets are not covered. On other chips this has no effect. Each
+ * manager counts its own line, so with two chips only the one that raised INTn is read.
+ * @return false if the pin has no interrupt, another manager uses it, or all four
+ * pin interrupts the managers share (see setLinkInterruptPin()) are taken.
+ */
+bool SimpleNetManagerBase::setInterruptPin(uint8_t pin) {
+    pinMode(pin, INPUT_PULLUP);
+    _chipInterruptsSeen = _chipInterrupts;
+    if (!attachPinCounter(pin, &_chipInterrupts, FALLING)) {
+        return false;
+    }
+    _interruptPin = pin;
+    if (_currentState == NET_CONNECTED || _currentState == NET_DEGRADED) {
+        _chip.enableInterrupts(true);
+    }
+    return true;
+}
+
+/**
+ * @brief Powers the PHY down while disconnected and waiting to retry.
+ * @details The PHY is powered up again wakeLead milliseconds before each attempt,
+ * which should cover auto-negotiation; waits shorter than that keep it powered.
+ * A cable plugged in while the PHY is down is only seen at the next attempt.
+ * Only the W5500 supports this; on other chips the setting has no effect.
  */
-void SimpleNetManager::setConnectionRetryInterval(long interval) {
-    _connectionInterval = interval;
+void SimpleNetManagerBase::setLowPowerIdle(bool enabled, unsigned long wakeLead) {
+    _lowPowerIdle = enabled;
+    _phyWakeLead = wakeLead;
+    if (!enabled) {
+        _phy.powerUp();
+    }
+}
+
+/**
+ * @brief Checks that the network beyond the cable still answers, every interval ms.
+ * @details While online, an ICMP echo is sent to the gateway (or the target set with
+ * setProbeTarget()). After the given number of unanswered probes in a row the manager
+ * moves to NET_DEGRADED and publishes NET_EVENT_DEGRADED; the first answer brings it
+ * back to NET_CONNECTED with NET_EVENT_RECOVERED. Sockets, services and the lease are
+ * kept throughout, so recovery is immediate. An interval of 0 (the default) disables it.
+ */
+void SimpleNetManagerBase::setReachabilityProbe(unsigned long interval, uint8_t failures, unsigned long timeout) {
+    _probeInterval = interval;
+    _probeThreshold = failures > 0 ? failures : 1;
+    _probeTimeout = timeout;
+    _probeFailures = 0;
+    _probe.stop();
+}
+
+/**
+ * @brief Probes target instead of the gateway, e.g. a host beyond the router to
+ * detect a lost uplink. 0.0.0.0 returns to the gateway.
+ */
+void SimpleNetManagerBase::setProbeTarget(IPAddress target) {
+    _probeTarget = target;
+}
+
+/**
+ * @brief Raises the SPI clock of the library's own chip transfers (see NetSpi); call before begin().
+ * @details begin() then uses maxClock if the chip reads back correctly at it, or with
+ * autoProbe steps up from the Ethernet library's clock to the fastest one up to
+ * maxClock that does. While connected, each link check also verifies one read-back
+ * and lowers the clock a step if it fails.
+ */
+void SimpleNetManagerBase::setSpiClock(uint32_t maxClock, bool autoProbe) {
+    _spiClock = maxClock;
+    _spiProbe = autoProbe;
 }
 
+/**
+ * @brief Returns true while the link is up but the probe target does not answer.
+ */
+bool SimpleNetManagerBase::isDegraded() {
+    return _currentState == NET_DEGRADED;
+}
+
+/**
+ * @brief Private method to latch the chip's socket events once INTn has fired.
+ * @details Only this manager's counter and line are looked at, so another chip's
+ * events cost no transfer here. INTn stays low until the flags are cleared, so a
+ * low line is serviced too; that covers events raised again before the last ones
+ * were cleared, which bring no new falling edge.
+ */
+void SimpleNetManagerBase::serviceChip() {
+    if (!_chip.interruptsEnabled()) {
+        return;
+    }
+    if (_chipInterrupts != _chipInterruptsSeen || digitalRead(_interruptPin) == LOW) {
+        _chipInterruptsSeen = _chipInterrupts;
+        _chip.serviceInterrupts();
+    }
+}
+
+#if SIMPLE_NET_STATS
+/**
+ * @brief Returns the collected counters, with averages and uptimes brought up to date.
+ */
+const NetStats& SimpleNetManagerBase::getStats() {
+    if (_stats.loopCount > 0) {
+        _stats.loopAvgMicros = (unsigned long)(_loopMicrosTotal / _stats.loopCount);
+    }
+    accountUptime(_currentState == NET_CONNECTED);
+    return _stats;
+}
+
+/**
+ * @brief Private method to record the duration of the attempt started by connect().
+ */
+void SimpleNetManagerBase::endConnectAttempt() {
+    _stats.lastConnectMillis = millis() - _connectStart;
+    if (_stats.lastConnectMillis > _stats.maxConnectMillis) {
+        _stats.maxConnectMillis = _stats.lastConnectMillis;
+    }
+}
+
+/**
+ * @brief Private method to add the time since the last call to the matching uptime total.
+ */
+void SimpleNetManagerBase::accountUptime(bool wasConnected) {
+    unsigned long now = millis();
+    if (wasConnected) {
+        _stats.connectedMillis += now - _uptimeSince;
+    } else {
+        _stats.disconnectedMillis += now - _uptimeSince;
+    }
+    _uptimeSince = now;
+}
+
+/**
+ * @brief Private method to fold the duration of one loop() call into the counters.
+ */
+void SimpleNetManagerBase::recordLoop(unsigned long loopStart) {
+    unsigned long loopTime = micros() - loopStart;
+    _stats.loopCount++;
+    _loopMicrosTotal += loopTime;
+    if (loopTime > _stats.loopMaxMicros) _stats.loopMaxMicros = loopTime;
+}
+
+/**
+ * @brief Private method to count a loop(budgetMicros) call that ran past its budget.
+ */
+void SimpleNetManagerBase::recordOverrun(unsigned long start, uint16_t budgetMicros) {
+    unsigned long elapsed = micros() - start;
+    if (budgetMicros == 0 || elapsed <= budgetMicros) {
+        return;
+    }
+
+    _stats.budgetOverrunCount++;
+    if (elapsed - budgetMicros > _stats.budgetMaxOverrunMicros) _stats.budgetMaxOverrunMicros = elapsed - budgetMicros;
+}
+#endif
+
 /**
  * @brief Registers the onConnect callback function.
  */
-void SimpleNetManager::onConnect(void (*callback)()) {
+void SimpleNetManagerBase::onConnect(void (*callback)()) {
     _onConnectCallback = callback;
 }
 
 /**
  * @brief Registers the onDisconnect callback function.
  */
-void SimpleNetManager::onDisconnect(void (*callback)()) {
+void SimpleNetManagerBase::onDisconnect(void (*callback)()) {
     _onDisconnectCallback = callback;
 }
 
+/**
+ * @brief Adds a listener for queued network events.
+ */
+bool SimpleNetManagerBase::addEventListener(NetEventListener listener, void* context) {
+    return _events.subscribe(listener, context);
+}
+
+/**
+ * @brief Removes a listener added with the same function and context.
+ */
+void SimpleNetManagerBase::removeEventListener(NetEventListener listener, void* context) {
+    _events.unsubscribe(listener, context);
+}
+
+/**
+ * @brief When deferred, loop() only queues events and the sketch calls dispatchEvents().
+ */
+void SimpleNetManagerBase::setDeferredEventDispatch(bool deferred) {
+    _deferEventDispatch = deferred;
+}
+
+/**
+ * @brief Delivers up to maxEvents queued events to all listeners.
+ */
+uint8_t SimpleNetManagerBase::dispatchEvents(uint8_t maxEvents) {
+    return _events.dispatch(maxEvents);
+}
+
+/**
+ * @brief Runs job(context) every interval milliseconds from loop(), the first time
+ * one interval from now.
+ * @details With requiresConnection set (the default) the job only runs in
+ * NET_CONNECTED: if it falls due while disconnected it runs once right after the
+ * next connect, then resumes its interval.
+ * @return A handle for cancelJob(), or NET_NO_JOB if all SIMPLE_NET_MAX_JOBS are in use.
+ */
+int8_t SimpleNetManagerBase::every(unsigned long interval, NetJob job, void* context, bool requiresConnection) {
+    if (interval == 0) {
+        return NET_NO_JOB;
+    }
+    return _scheduler.schedule(interval, interval, job, context, requiresConnection);
+}
+
+/**
+ * @brief Runs job(context) once from loop(), delay milliseconds from now.
+ * @details The handle is released when the job runs and may then be reused.
+ */
+int8_t SimpleNetManagerBase::after(unsigned long delay, NetJob job, void* context, bool requiresConnection) {
+    return _scheduler.schedule(delay, 0, job, context, requiresConnection);
+}
+
+/**
+ * @brief Removes a job added with every() or after().
+ */
+void SimpleNetManagerBase::cancelJob(int8_t job) {
+    _scheduler.cancel(job);
+}
+
 } // namespace SimpleNet
\ No newline at end of file
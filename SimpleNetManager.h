@@ -4,16 +4,316 @@
 #include <Arduino.h>
 #include <SPI.h>
 #include <Ethernet.h>
+#include "SimpleNetDhcp.h"
+#include "SimpleNetRetry.h"
+#include "SimpleNetEvents.h"
+#include "SimpleNetDns.h"
+#include "SimpleNetUdp.h"
+#include "SimpleNetScheduler.h"
+#include "SimpleNetPhy.h"
+#include "SimpleNetProbe.h"
+#include "SimpleNetArp.h"
+#include "SimpleNetBus.h"
+#include "SimpleNetLog.h"
+#include "SimpleNetBackend.h"
+
+#ifndef SIMPLE_NET_STATS
+#define SIMPLE_NET_STATS 0 ///< Set to 1 for the whole build (e.g. -DSIMPLE_NET_STATS=1) to enable getStats().
+#endif
+
+#if SIMPLE_NET_STATS
+#define SIMPLE_NET_STAT(statement) statement
+#else
+#define SIMPLE_NET_STAT(statement)
+#endif
 
 namespace SimpleNet {
 
+class SimpleNetManagerBase;
+
+/**
+ * @brief Base class for modules driven by a SimpleNetManager.
+ * @details A service attaches itself to its manager on construction and detaches
+ * on destruction, so a short-lived one (an HttpRequest on the stack or the heap) can
+ * go away at any time, even from inside its own callbacks. The manager
+ * calls poll() on every loop() and networkUp()/networkDown() on the transitions
+ * into and out of NET_CONNECTED, so services never need their own timers or checks.
+ * A service that only needs poll() at certain times overrides wakeDelay(), so that
+ * SimpleNetManagerT::nextWakeMs() can let the sketch sleep.
+ */
+class NetService {
+protected:
+    explicit NetService(SimpleNetManagerBase& manager);
+    virtual ~NetService();
+
+    virtual void poll() {}
+    virtual void networkUp() {}
+    virtual void networkDown() {}
+
+    /**
+     * @brief Returns the milliseconds until poll() next has work, or NET_WAKE_NEVER.
+     */
+    virtual unsigned long wakeDelay() { return NET_WAKE_NEVER; }
+
+private:
+    friend class SimpleNetManagerBase;
+    SimpleNetManagerBase& _owner;       ///< Manager the service is attached to.
+    NetService*           _nextService; ///< Intrusive list of services attached to the manager.
+};
+
 /**
  * @brief Defines the possible network connection states.
  */
 enum NetState {
     NET_DISCONNECTED, ///< The device is not connected to the network.
-    NET_CONNECTING,   ///< A connection attempt is currently in progress.
-    NET_CONNECTED     ///< The device has a stable network connection.
+    NET_CONNECTING,   ///< A connection attempt is currently in progress (see DhcpState for its sub-states).
+    NET_CONNECTED,    ///< The device has a stable network connection.
+    NET_DEGRADED,     ///< Link and address are up, but the reachability probe target stopped answering.
+    NET_ADDRESS_CONFLICT ///< Another host answered ARP for the static address; retried like NET_DISCONNECTED.
+};
+
+/**
+ * @brief Addressing modes a SimpleNetManagerT is compiled for.
+ */
+enum NetMode {
+    NET_MODE_ANY,   ///< Both; the begin() overload called picks one at run time.
+    NET_MODE_DHCP,  ///< DHCP only; the static IP code is not compiled in.
+    NET_MODE_STATIC ///< Static IP only; the DHCP client is not compiled in.
+};
+
+/// CsPin template argument meaning "given to the constructor" (default 10).
+static const uint8_t NET_CS_RUNTIME = 0xFF;
+
+/**
+ * @brief Timing and event counters collected when SIMPLE_NET_STATS is enabled.
+ */
+struct NetStats {
+    unsigned long loopCount;           ///< Number of loop() calls.
+    unsigned long loopMaxMicros;       ///< Longest loop() call.
+    unsigned long loopAvgMicros;       ///< Mean loop() call duration.
+    unsigned long lastConnectMillis;   ///< Duration of the most recent connection attempt.
+    unsigned long maxConnectMillis;    ///< Longest connection attempt.
+    unsigned long dhcpSuccessCount;    ///< DHCP acquisitions that reached BOUND.
+    unsigned long dhcpFailureCount;    ///< DHCP acquisitions that failed or timed out.
+    unsigned long linkLostCount;       ///< Physical link losses while connected.
+    unsigned long leaseLostCount;      ///< DHCP lease losses while connected.
+    unsigned long connectedMillis;     ///< Total time spent in NET_CONNECTED.
+    unsigned long disconnectedMillis;  ///< Total time spent outside NET_CONNECTED (NET_DEGRADED included).
+    unsigned long degradedCount;       ///< Transitions from NET_CONNECTED into NET_DEGRADED.
+    unsigned long busDeferredCount;    ///< loop() calls skipped because another owner held the SPI bus.
+    unsigned long budgetOverrunCount;  ///< loop(budgetMicros) calls that ran past their budget.
+    unsigned long budgetMaxOverrunMicros; ///< Largest amount by which a call ran past its budget.
+    unsigned long addressConflictCount; ///< Static IP attempts that found the address in use.
+};
+
+/**
+ * @brief Holds the chip select pin: a compile-time constant, or a byte for NET_CS_RUNTIME.
+ */
+template <uint8_t CsPin>
+class NetCsPin {
+public:
+    explicit NetCsPin(uint8_t) {}
+    uint8_t csPin() const { return CsPin; }
+};
+
+template <>
+class NetCsPin<NET_CS_RUNTIME> {
+public:
+    explicit NetCsPin(uint8_t csPin) : _csPin(csPin) {}
+    uint8_t csPin() const { return _csPin; }
+
+private:
+    uint8_t _csPin;
+};
+
+/** @brief Configuration and client of the DHCP mode. */
+template <class Dhcp>
+struct NetDhcpConfig {
+    Dhcp          dhcp;
+    LeaseStore*   leaseStore;
+    unsigned long dhcpTimeout;
+
+    NetDhcpConfig() : leaseStore(nullptr), dhcpTimeout(60000) {}
+};
+
+/** @brief Configuration of the static IP mode. */
+struct NetStaticConfig {
+    IPAddress     ip;
+    IPAddress     dns;
+    IPAddress     gateway;
+    IPAddress     subnet;
+    unsigned long linkTimeout;
+    uint8_t       reinitThreshold;
+    uint8_t       failures;
+    bool          arpCheck;      ///< Check the address and resolve the gateway before NET_CONNECTED.
+    NetArpCheck   arp;
+
+    NetStaticConfig() : linkTimeout(10000), reinitThreshold(3), failures(0), arpCheck(false) {}
+};
+
+/**
+ * @brief The mode-specific members of a SimpleNetManagerT; only the chosen mode's are present.
+ */
+template <NetMode Mode, class Dhcp> struct NetModeConfig;
+
+template <class Dhcp>
+struct NetModeConfig<NET_MODE_DHCP, Dhcp> : NetDhcpConfig<Dhcp> {
+    bool staticIp() const { return false; }
+    void setStaticIp(bool) {}
+};
+
+template <class Dhcp>
+struct NetModeConfig<NET_MODE_STATIC, Dhcp> : NetStaticConfig {
+    bool staticIp() const { return true; }
+    void setStaticIp(bool) {}
+};
+
+template <class Dhcp>
+struct NetModeConfig<NET_MODE_ANY, Dhcp> : NetDhcpConfig<Dhcp>, NetStaticConfig {
+    bool useStaticIp;
+
+    NetModeConfig() : useStaticIp(false) {}
+    bool staticIp() const { return useStaticIp; }
+    void setStaticIp(bool value) { useStaticIp = value; }
+};
+
+/// Overload tag selecting a mode-specific helper or its empty counterpart.
+template <bool Enabled> struct NetModeTag {};
+
+/**
+ * @brief The mode-independent part of the manager; all of it is compiled once.
+ * @details Services, events, DNS, retry scheduling and statistics live here.
+ * The connection state machine itself is in SimpleNetManagerT so that code for an
+ * unused mode, and debug output, can be left out at compile time.
+ */
+class SimpleNetManagerBase {
+public:
+    bool isConnected();
+    EthernetClient& getClient();
+    UdpEndpoint* getUdp(uint16_t port);
+    bool resolve(const char* host, DnsCallback callback, void* context = nullptr);
+    void setConnectionRetryInterval(long interval);
+    void setRetryPolicy(const RetryPolicy& policy);
+    void setHealthCheckIntervals(unsigned long linkInterval, unsigned long leaseInterval);
+    bool setLinkInterruptPin(uint8_t pin);
+    bool setInterruptPin(uint8_t pin);
+    void setLowPowerIdle(bool enabled, unsigned long wakeLead = 3000);
+    void setReachabilityProbe(unsigned long interval, uint8_t failures = 2, unsigned long timeout = 1000);
+    void setProbeTarget(IPAddress target);
+    void setSpiClock(uint32_t maxClock, bool autoProbe = false);
+    bool isDegraded();
+    void onConnect(void (*callback)());
+    void onDisconnect(void (*callback)());
+    bool addEventListener(NetEventListener listener, void* context = nullptr);
+    void removeEventListener(NetEventListener listener, void* context = nullptr);
+    void setDeferredEventDispatch(bool deferred);
+    uint8_t dispatchEvents(uint8_t maxEvents = SIMPLE_NET_EVENT_QUEUE_SIZE);
+    int8_t every(unsigned long interval, NetJob job, void* context = nullptr, bool requiresConnection = true);
+    int8_t after(unsigned long delay, NetJob job, void* context = nullptr, bool requiresConnection = true);
+    void cancelJob(int8_t job);
+#if SIMPLE_NET_STATS
+    const NetStats& getStats();
+#endif
+
+    /**
+     * @brief Returns the chip this manager drives; services attach their sockets to it.
+     */
+    NetChip& chip() { return _chip; }
+
+protected:
+    explicit SimpleNetManagerBase(const byte mac[]);
+    ~SimpleNetManagerBase();
+
+    byte          _mac[6];
+    NetState      _currentState;
+    unsigned long _lastConnectionAttempt;
+    RetryPolicy   _retryPolicy;
+    unsigned long _retryDelay;
+
+    // Health checks while connected; each one is an SPI transaction to the chip.
+    unsigned long _linkCheckInterval = 100;
+    unsigned long _leaseCheckInterval = 1000;
+    unsigned long _lastLinkCheck;
+    unsigned long _lastLeaseCheck;
+
+    volatile uint8_t _linkChanges; ///< Counted by this manager's link pin interrupt.
+    uint8_t       _linkChangesSeen;
+
+    volatile uint8_t _chipInterrupts; ///< Counted by this manager's INTn pin interrupt.
+    uint8_t       _chipInterruptsSeen;
+    uint8_t       _interruptPin;   ///< NET_CS_RUNTIME (0xFF) while INTn is not wired.
+
+    DnsResolver   _resolver;
+    EventQueue    _events;
+    bool          _linkUp;
+    NetChip       _chip;       ///< The chip this instance drives; its sockets all use it.
+
+    uint32_t      _spiClock;   ///< Requested NetSpi clock; 0 leaves the default.
+    bool          _spiProbe;
+
+#if SIMPLE_NET_STATS
+    NetStats           _stats;
+    unsigned long long _loopMicrosTotal;
+    unsigned long      _connectStart;
+    unsigned long      _uptimeSince;
+
+    void endConnectAttempt();
+    void accountUptime(bool wasConnected);
+    void recordLoop(unsigned long loopStart);
+#endif
+
+    void enterConnected(IPAddress localIp);
+    void leaveConnected();
+    void checkIpChange(IPAddress localIp);
+    /// The parts of one loop() pass. loop(budgetMicros) can stop between any two and resume there.
+    enum LoopSlice { SLICE_STATE, SLICE_LEASE, SLICE_PROBE, SLICE_DNS, SLICE_JOBS, SLICE_SERVICES, SLICE_EVENTS, SLICE_COUNT };
+
+    uint8_t       _slice;          ///< Next LoopSlice to run.
+    NetService*   _resumeService;  ///< Next service to poll within SLICE_SERVICES.
+
+    bool pollServices(unsigned long start, uint16_t budgetMicros);
+    void runJobs();
+    void dispatchEvent();
+    static bool budgetSpent(unsigned long start, uint16_t budgetMicros) {
+        return budgetMicros != 0 && micros() - start >= budgetMicros;
+    }
+#if SIMPLE_NET_STATS
+    void recordOverrun(unsigned long start, uint16_t budgetMicros);
+#endif
+    void serviceChip();
+    unsigned long serviceWakeDelay();
+    void idlePhy(unsigned long untilRetry);
+    void runProbe(unsigned long now);
+    unsigned long probeWakeDelay(unsigned long now) const;
+    unsigned long idleWakeDelay(unsigned long untilRetry) const;
+
+private:
+    friend class NetService;
+
+    EthernetClient _client;
+    UdpEndpoint    _udp[SIMPLE_NET_UDP_ENDPOINTS];
+    NetService*    _services;   ///< Services driven by loop(), see NetService.
+    bool           _deferEventDispatch;
+    IPAddress      _lastIp;
+    NetScheduler   _scheduler;
+    NetPhy         _phy;
+    bool           _lowPowerIdle;
+    unsigned long  _phyWakeLead;  ///< How long before a retry attempt the PHY is powered up.
+
+    // Reachability probe while online; an interval of 0 disables it.
+    NetProbe       _probe;
+    IPAddress      _probeTarget;  ///< 0.0.0.0 probes the current gateway.
+    unsigned long  _probeInterval;
+    unsigned long  _probeTimeout;
+    unsigned long  _lastProbe;
+    uint8_t        _probeThreshold;
+    uint8_t        _probeFailures;
+
+    void (*_onConnectCallback)();
+    void (*_onDisconnectCallback)();
+
+    void attachService(NetService* service);
+    void detachService(NetService* service);
 };
 
 /**
@@ -21,28 +321,52 @@ enum NetState {
  * @details This class handles the state machine for connecting, maintaining,
  * and reconnecting an Ethernet shield using either DHCP or a static IP.
  * It is designed to be called repeatedly in the main sketch loop.
+ *
+ * The template arguments decide at compile time what is built in. A product that
+ * only uses one mode, or ships without a debug port, can drop the other mode's
+ * code, every debug string and the stream pointer:
+ * @code
+ * SimpleNetManagerT<NET_MODE_STATIC, NetNoDebug, 10> netManager(mac);
+ * @endcode
+ * @tparam Mode NET_MODE_DHCP, NET_MODE_STATIC or NET_MODE_ANY.
+ * @tparam DebugPolicy NetDebugStream or NetNoDebug.
+ * @tparam CsPin The chip select pin, or NET_CS_RUNTIME to take it from the constructor.
+ * @tparam Backend The chip calls and DHCP client the state machine uses: NetEthernetBackend,
+ * NetW5500Backend for a further chip on its own CS pin, or NetSimBackend for
+ * host-side simulation.
  */
-class SimpleNetManager {
+template <NetMode Mode = NET_MODE_ANY, class DebugPolicy = NetDebugStream, uint8_t CsPin = NET_CS_RUNTIME, class Backend = NetEthernetBackend>
+class SimpleNetManagerT : public SimpleNetManagerBase, private DebugPolicy, private NetCsPin<CsPin>, private Backend {
+    static const bool HasDhcp = (Mode != NET_MODE_STATIC);
+    static const bool HasStatic = (Mode != NET_MODE_DHCP);
+
 public:
     /**
      * @brief Constructor (Basic): Initializes with only the MAC address. CS pin defaults to 10.
      * @param mac A byte array of length 6 for the MAC address.
      */
-    SimpleNetManager(byte mac[]);
+    SimpleNetManagerT(byte mac[])
+        : SimpleNetManagerBase(mac), DebugPolicy(nullptr), NetCsPin<CsPin>(10) {
+    }
 
     /**
      * @brief Constructor (MAC + CS Pin): Initializes with MAC address and a custom Chip Select pin.
      * @param mac A byte array of length 6 for the MAC address.
      * @param csPin The chip select (CS) pin for the Ethernet module.
      */
-    SimpleNetManager(byte mac[], uint8_t csPin);
+    SimpleNetManagerT(byte mac[], uint8_t csPin)
+        : SimpleNetManagerBase(mac), DebugPolicy(nullptr), NetCsPin<CsPin>(csPin) {
+        static_assert(CsPin == NET_CS_RUNTIME, "The CS pin is already fixed by the CsPin template argument");
+    }
 
     /**
      * @brief Constructor (MAC + Debug): Initializes with MAC address and a debug stream. CS pin defaults to 10.
      * @param mac A byte array of length 6 for the MAC address.
      * @param debugStream A pointer to a Stream object (like &Serial) for debug output.
      */
-    SimpleNetManager(byte mac[], Stream* debugStream);
+    SimpleNetManagerT(byte mac[], Stream* debugStream)
+        : SimpleNetManagerBase(mac), DebugPolicy(debugStream), NetCsPin<CsPin>(10) {
+    }
 
     /**
      * @brief Constructor (MAC + CS Pin + Debug): Initializes with MAC, CS pin, and a debug stream.
@@ -50,41 +374,568 @@ public:
      * @param csPin The chip select (CS) pin for the Ethernet module.
      * @param debugStream A pointer to a Stream object (like &Serial) for debug output.
      */
-    SimpleNetManager(byte mac[], uint8_t csPin, Stream* debugStream);
+    SimpleNetManagerT(byte mac[], uint8_t csPin, Stream* debugStream)
+        : SimpleNetManagerBase(mac), DebugPolicy(debugStream), NetCsPin<CsPin>(csPin) {
+        static_assert(CsPin == NET_CS_RUNTIME, "The CS pin is already fixed by the CsPin template argument");
+    }
 
     // --- Public Methods ---
     void begin();
     void begin(IPAddress ip, IPAddress dns, IPAddress gateway, IPAddress subnet);
     NetState loop();
-    bool isConnected();
-    EthernetClient& getClient();
-    void setConnectionRetryInterval(long interval);
-    void onConnect(void (*callback)());
-    void onDisconnect(void (*callback)());
+    NetState loop(uint16_t budgetMicros);
+    void setDhcpTimeout(unsigned long timeout);
+    void setLeaseStore(LeaseStore* store);
+    void setStaticLinkPolicy(unsigned long linkTimeout, uint8_t reinitAfterFailures);
+    void setStaticArpCheck(bool enabled);
+    DhcpState getDhcpState();
+    unsigned long nextWakeMs();
+
+    /**
+     * @brief Returns the debug policy, e.g. to call setLevel(), or flush() on a NetDebugLog.
+     */
+    DebugPolicy& logger() { return *this; }
 
 private:
-    // --- Private Members ---
-    byte          _mac[6];
-    IPAddress     _ip;
-    IPAddress     _dns;
-    IPAddress     _gateway;
-    IPAddress     _subnet;
-    bool          _use_static_ip;
-    uint8_t       _csPin;
-    Stream* _debugStream;
+    NetModeConfig<Mode, typename Backend::Dhcp> _mode;
 
-    NetState      _currentState;
-    unsigned long _lastConnectionAttempt;
-    long          _connectionInterval = 10000;
+    void connect();
+    void applyDhcpLease();
+    void stepState();
+    void maintainLease();
+    void transition(NetState previousState);
+    void tuneSpi();
+    void attachChip() { attachDhcp(NetModeTag<HasDhcp>()); attachArp(NetModeTag<HasStatic>()); }
 
-    EthernetClient _client;
-    
-    void (*_onConnectCallback)();
-    void (*_onDisconnectCallback)();
+    // Mode-specific steps. Each comes with an empty overload for builds without that
+    // mode, so a fixed-mode build never instantiates the other mode's code.
+    void connectStatic(NetModeTag<true>);
+    void connectStatic(NetModeTag<false>) {}
+    void stepStatic(NetModeTag<true>);
+    void stepStatic(NetModeTag<false>) {}
+    void staticUp(NetModeTag<true>);
+    bool arpRunning(NetModeTag<true>) { return _mode.arp.isRunning(); }
+    bool arpRunning(NetModeTag<false>) { return false; }
+    unsigned long linkWaitDelay(NetModeTag<true>, unsigned long now) {
+        return now - _lastConnectionAttempt >= _mode.linkTimeout ? 0 : _mode.linkTimeout - (now - _lastConnectionAttempt);
+    }
+    unsigned long linkWaitDelay(NetModeTag<false>, unsigned long) { return NET_WAKE_NEVER; }
+    void connectDhcp(NetModeTag<true>);
+    void connectDhcp(NetModeTag<false>) {}
+    void stepDhcp(NetModeTag<true>);
+    void stepDhcp(NetModeTag<false>) {}
+    void maintainDhcp(NetModeTag<true>);
+    void maintainDhcp(NetModeTag<false>) {}
+    void stopDhcp(NetModeTag<true>) { _mode.dhcp.stop(); }
+    void stopDhcp(NetModeTag<false>) {}
+    void attachDhcp(NetModeTag<true>) { _mode.dhcp.attach(_chip); }
+    void attachDhcp(NetModeTag<false>) {}
+    void attachArp(NetModeTag<true>) { _mode.arp.attach(_chip); }
+    void attachArp(NetModeTag<false>) {}
+    IPAddress staticIp(NetModeTag<true>) { return _mode.ip; }
+    IPAddress staticIp(NetModeTag<false>) { return IPAddress(0, 0, 0, 0); }
+    IPAddress dhcpIp(NetModeTag<true>) { return _mode.dhcp.localIP(); }
+    IPAddress dhcpIp(NetModeTag<false>) { return IPAddress(0, 0, 0, 0); }
 
-    void connect();
+    IPAddress localIp() { return _mode.staticIp() ? staticIp(NetModeTag<HasStatic>()) : dhcpIp(NetModeTag<HasDhcp>()); }
+    void trace(uint8_t code, uint32_t arg = 0) {
+        if (netLogLevel(code) <= SIMPLE_NET_LOG_LEVEL) DebugPolicy::log(code, arg);
+    }
+    uint8_t csPin() const { return NetCsPin<CsPin>::csPin(); }
 };
 
+/// The run-time configured manager: both modes, optional debug stream, CS pin from the constructor.
+typedef SimpleNetManagerT<> SimpleNetManager;
+
+// --- SimpleNetManagerT implementation -------------------------------------
+
+/**
+ * @brief Initializes for DHCP.
+ */
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+void SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::begin() {
+    static_assert(HasDhcp, "begin() without addresses needs NET_MODE_DHCP or NET_MODE_ANY");
+    _mode.setStaticIp(false);
+
+    // Always initialize the Ethernet CS pin based on the constructor used.
+    Backend::init(_chip, csPin());
+    attachChip();
+    trace(NET_LOG_CS_PIN, csPin());
+
+    // Bring the chip up once with no address. The one-time reset wait inside the
+    // Ethernet library happens here in setup() instead of inside loop().
+    IPAddress none(0, 0, 0, 0);
+    Backend::configure(_chip, _mac, none, none, none, none);
+    tuneSpi();
+
+    // The first attempt happens on the first loop() call.
+    _retryPolicy.reset();
+    _retryDelay = 0;
+    _lastConnectionAttempt = millis();
+    trace(NET_LOG_INIT_DHCP);
+}
+
+/**
+ * @brief Initializes for Static IP.
+ */
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+void SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::begin(IPAddress ip, IPAddress dns, IPAddress gateway, IPAddress subnet) {
+    static_assert(HasStatic, "begin(ip, dns, gateway, subnet) needs NET_MODE_STATIC or NET_MODE_ANY");
+    _mode.setStaticIp(true);
+    _mode.ip = ip;
+    _mode.dns = dns;
+    _mode.gateway = gateway;
+    _mode.subnet = subnet;
+
+    // Always initialize the Ethernet CS pin based on the constructor used.
+    Backend::init(_chip, csPin());
+    attachChip();
+    trace(NET_LOG_CS_PIN, csPin());
+
+    // Configure the chip once; connection attempts only wait for the PHY link.
+    Backend::configure(_chip, _mac, _mode.ip, _mode.dns, _mode.gateway, _mode.subnet);
+    tuneSpi();
+    _mode.failures = 0;
+    _resolver.setServer(_mode.dns);
+
+    _retryPolicy.reset();
+    _retryDelay = 0;
+    _lastConnectionAttempt = millis();
+    trace(NET_LOG_INIT_STATIC);
+}
+
+/**
+ * @brief The main state machine loop to be called repeatedly.
+ * @details Runs one whole pass: the connection state machine, health checks,
+ * services, due jobs and one event.
+ */
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+NetState SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::loop() {
+    return loop((uint16_t)0);
+}
+
+/**
+ * @brief Runs the pass in slices and returns once budgetMicros have been used.
+ * @details The pass is split into slices (the state machine step, DHCP lease
+ * maintenance, the reachability probe, DNS, due jobs, each service in turn, event
+ * dispatch). After each one the elapsed time is checked; when the budget is spent
+ * the call returns and the next call resumes with the following slice. One slice
+ * always runs, so a too-small budget still makes progress; a slice that overruns
+ * the budget is counted in NetStats. A budget of 0 means no limit.
+ */
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+NetState SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::loop(uint16_t budgetMicros) {
+    // Yield to a higher-priority bus user; everything below simply runs next tick.
+    if (!NetBusLock::tryAcquire(NET_BUS_NETWORK)) {
+        SIMPLE_NET_STAT(_stats.busDeferredCount++);
+        return _currentState;
+    }
+    unsigned long start = micros();
+
+    do {
+        NetState previousState = _currentState;
+        bool done = true;
+
+        switch (_slice) {
+            case SLICE_STATE:
+                serviceChip();
+                stepState();
+                break;
+
+            case SLICE_LEASE:
+                maintainLease();
+                break;
+
+            case SLICE_PROBE:
+                if (_currentState == NET_CONNECTED || _currentState == NET_DEGRADED) runProbe(millis());
+                break;
+
+            case SLICE_DNS:
+                if (_currentState == NET_CONNECTED || _currentState == NET_DEGRADED) _resolver.poll();
+                break;
+
+            case SLICE_JOBS:
+                runJobs();
+                break;
+
+            case SLICE_SERVICES:
+                done = pollServices(start, budgetMicros);
+                break;
+
+            case SLICE_EVENTS:
+                dispatchEvent();
+                break;
+        }
+
+        if (_currentState != previousState) {
+            transition(previousState);
+        }
+        if (done && ++_slice == SLICE_COUNT) {
+            _slice = SLICE_STATE;
+            break; // One pass per call, however much budget is left.
+        }
+    } while (!budgetSpent(start, budgetMicros));
+
+    // Drain-on-idle: log output only uses time a finished pass left over.
+    if (_slice == SLICE_STATE && !budgetSpent(start, budgetMicros)) {
+        DebugPolicy::drain();
+    }
+
+    SIMPLE_NET_STAT(recordOverrun(start, budgetMicros));
+    SIMPLE_NET_STAT(recordLoop(start));
+    NetBusLock::release(NET_BUS_NETWORK);
+    return _currentState;
+}
+
+/**
+ * @brief Private method for the state machine slice: a retry, a connection step or the link check.
+ */
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+void SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::stepState() {
+    switch (_currentState) {
+        case NET_DISCONNECTED:
+        case NET_ADDRESS_CONFLICT: {
+            unsigned long waited = millis() - _lastConnectionAttempt;
+            unsigned long untilRetry = waited >= _retryDelay ? 0 : _retryDelay - waited;
+            idlePhy(untilRetry);
+            if (untilRetry == 0) {
+                _currentState = NET_CONNECTING;
+                connect();
+            }
+            break;
+        }
+
+        case NET_CONNECTING:
+            // Static IP attempts wait for the PHY link; DHCP attempts advance one
+            // DISCOVER/OFFER/REQUEST/ACK step per call.
+            if (_mode.staticIp()) {
+                stepStatic(NetModeTag<HasStatic>());
+            } else {
+                stepDhcp(NetModeTag<HasDhcp>());
+            }
+            break;
+
+        case NET_CONNECTED:
+        case NET_DEGRADED: {
+            // Fast path: only millis() compares. The chip is touched when a check is due.
+            unsigned long now = millis();
+            if (_linkChanges != _linkChangesSeen || now - _lastLinkCheck >= _linkCheckInterval) {
+                _linkChangesSeen = _linkChanges;
+                _lastLinkCheck = now;
+                if (!Backend::linkUp(_chip)) {
+                    trace(NET_LOG_LINK_LOST);
+                    SIMPLE_NET_STAT(_stats.linkLostCount++);
+                    _linkUp = false;
+                    _events.publish(NET_EVENT_LINK_DOWN);
+                    _currentState = NET_DISCONNECTED;
+                } else if (!Backend::checkSpi()) {
+                    trace(NET_LOG_SPI_FALLBACK, NetSpi::clock());
+                }
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Private method for the DHCP lease slice, run while online when the check is due.
+ */
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+void SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::maintainLease() {
+    if ((_currentState != NET_CONNECTED && _currentState != NET_DEGRADED) || _mode.staticIp()) {
+        return;
+    }
+
+    unsigned long now = millis();
+    if (now - _lastLeaseCheck >= _leaseCheckInterval) {
+        _lastLeaseCheck = now;
+        maintainDhcp(NetModeTag<HasDhcp>());
+    }
+}
+
+/**
+ * @brief Private method for the work that follows a state change: statistics,
+ * services and callbacks on connecting, cleanup and backoff on disconnecting.
+ */
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+void SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::transition(NetState previousState) {
+    SIMPLE_NET_STAT(if ((_currentState == NET_CONNECTED) != (previousState == NET_CONNECTED)) accountUptime(previousState == NET_CONNECTED));
+    if (_currentState == NET_CONNECTED && previousState != NET_DEGRADED) {
+        enterConnected(localIp());
+    } else if (_currentState == NET_DISCONNECTED && (previousState == NET_CONNECTED || previousState == NET_DEGRADED)) {
+        stopDhcp(NetModeTag<HasDhcp>());
+        leaveConnected();
+        // A static node only has to wait for its own PHY, so it starts doing that
+        // right away; backoff applies once a wait has timed out.
+        _retryDelay = _mode.staticIp() ? 0 : _retryPolicy.next();
+    }
+}
+
+/**
+ * @brief Private method to apply setSpiClock() once the chip is configured.
+ */
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+void SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::tuneSpi() {
+    if (_spiClock != 0) {
+        trace(NET_LOG_SPI_CLOCK, Backend::tuneSpi(_spiClock, _spiProbe, _mac));
+    }
+}
+
+/**
+ * @brief Returns how many milliseconds loop() can go uncalled without missing
+ * anything: a retry, a health check, a scheduled job or a service with work.
+ * @details 0 means loop() has work now (for example a DHCP exchange or a DNS lookup
+ * in flight). Data arriving on a socket is not foreseen; a node that sleeps for the
+ * full delay only notices it on waking.
+ */
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+unsigned long SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::nextWakeMs() {
+    if (_slice != SLICE_STATE) {
+        return 0; // loop(budgetMicros) stopped part-way through a pass.
+    }
+
+    unsigned long now = millis();
+    unsigned long wake = NET_WAKE_NEVER;
+
+    switch (_currentState) {
+        case NET_DISCONNECTED:
+        case NET_ADDRESS_CONFLICT:
+            wake = idleWakeDelay(now - _lastConnectionAttempt >= _retryDelay ? 0 : _retryDelay - (now - _lastConnectionAttempt));
+            break;
+
+        case NET_CONNECTING:
+            if (!_mode.staticIp() || arpRunning(NetModeTag<HasStatic>())) {
+                return 0; // The DHCP exchange or ARP check is advanced, and timed out, by every call.
+            }
+            wake = linkWaitDelay(NetModeTag<HasStatic>(), now);
+            // Fall through.
+
+        case NET_CONNECTED:
+        case NET_DEGRADED: {
+            unsigned long link = now - _lastLinkCheck >= _linkCheckInterval ? 0 : _linkCheckInterval - (now - _lastLinkCheck);
+            if (link < wake) wake = link;
+            if (_currentState != NET_CONNECTING && !_mode.staticIp()) {
+                unsigned long lease = now - _lastLeaseCheck >= _leaseCheckInterval ? 0 : _leaseCheckInterval - (now - _lastLeaseCheck);
+                if (lease < wake) wake = lease;
+            }
+            if (_currentState != NET_CONNECTING) {
+                unsigned long probe = probeWakeDelay(now);
+                if (probe < wake) wake = probe;
+            }
+            break;
+        }
+    }
+
+    unsigned long services = serviceWakeDelay();
+    return services < wake ? services : wake;
+}
+
+/**
+ * @brief Private method to handle the actual connection attempt.
+ */
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+void SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::connect() {
+    _lastConnectionAttempt = millis();
+    SIMPLE_NET_STAT(_connectStart = _lastConnectionAttempt);
+    trace(NET_LOG_CONNECTING, _mode.staticIp());
+
+    if (_mode.staticIp()) {
+        connectStatic(NetModeTag<HasStatic>());
+    } else {
+        connectDhcp(NetModeTag<HasDhcp>());
+    }
+}
+
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+void SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::connectStatic(NetModeTag<true>) {
+    // The chip was configured in begin(). Rewriting it every attempt would only
+    // disturb the PHY, so that is reserved for repeated failures.
+    if (_mode.reinitThreshold > 0 && _mode.failures >= _mode.reinitThreshold) {
+        trace(NET_LOG_CHIP_REINIT);
+        Backend::configure(_chip, _mac, _mode.ip, _mode.dns, _mode.gateway, _mode.subnet);
+        _mode.failures = 0;
+    }
+    // loop() moves to NET_CONNECTED as soon as the PHY reports link.
+    _lastLinkCheck = _lastConnectionAttempt - _linkCheckInterval;
+}
+
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+void SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::stepStatic(NetModeTag<true>) {
+    if (_mode.arp.isRunning()) {
+        NetArpResult result = _mode.arp.poll();
+        if (result == NET_ARP_CONFLICT) {
+            SIMPLE_NET_STAT(_stats.addressConflictCount++);
+            SIMPLE_NET_STAT(endConnectAttempt());
+            _currentState = NET_ADDRESS_CONFLICT;
+            _lastConnectionAttempt = millis();
+            _retryDelay = _retryPolicy.next();
+            _events.publish(NET_EVENT_ADDRESS_CONFLICT);
+            trace(NET_LOG_ADDRESS_CONFLICT, (uint32_t)_mode.ip);
+        } else if (result == NET_ARP_CLEAR) {
+            if (_mode.arp.gatewayResolved()) {
+                _chip.pinGateway(_mode.ip, _mode.subnet, _mode.gateway, _mode.arp.gatewayMac());
+            } else {
+                trace(NET_LOG_GATEWAY_UNRESOLVED);
+            }
+            staticUp(NetModeTag<true>());
+        }
+        return;
+    }
+
+    unsigned long now = millis();
+    if (now - _lastLinkCheck >= _linkCheckInterval) {
+        _lastLinkCheck = now;
+        if (Backend::linkUp(_chip)) {
+            // With the check enabled, NET_CONNECTED waits for its verdict (a free socket permitting).
+            if (!_mode.arpCheck || !_mode.arp.start(_mode.ip, _mode.gateway)) {
+                staticUp(NetModeTag<true>());
+            }
+            return;
+        }
+    }
+    if (now - _lastConnectionAttempt >= _mode.linkTimeout) {
+        if (_mode.failures < 255) _mode.failures++;
+        SIMPLE_NET_STAT(endConnectAttempt());
+        _currentState = NET_DISCONNECTED;
+        _lastConnectionAttempt = now;
+        _retryDelay = _retryPolicy.next();
+        trace(NET_LOG_STATIC_TIMEOUT);
+    }
+}
+
+/**
+ * @brief Private method to finish a static IP attempt: the link is up (and the address checked).
+ */
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+void SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::staticUp(NetModeTag<true>) {
+    _mode.failures = 0;
+    SIMPLE_NET_STAT(endConnectAttempt());
+    _currentState = NET_CONNECTED;
+    trace(NET_LOG_STATIC_UP);
+}
+
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+void SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::connectDhcp(NetModeTag<true>) {
+    // Only starts the exchange; loop() drives it to completion while NET_CONNECTING.
+    DhcpLease lease;
+    bool remembered = _mode.leaseStore && _mode.leaseStore->load(lease) && memcmp(lease.mac, _mac, 6) == 0;
+    if (remembered) {
+        trace(NET_LOG_PREVIOUS_ADDRESS, (uint32_t)IPAddress(lease.localIp));
+    }
+    if (!_mode.dhcp.start(_mac, _mode.dhcpTimeout, remembered ? &lease : nullptr)) {
+        _currentState = NET_DISCONNECTED;
+        _retryDelay = _retryPolicy.next();
+        SIMPLE_NET_STAT(_stats.dhcpFailureCount++);
+        SIMPLE_NET_STAT(endConnectAttempt());
+        trace(NET_LOG_DHCP_FAILED);
+    }
+}
+
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+void SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::stepDhcp(NetModeTag<true>) {
+    DhcpState dhcpState = _mode.dhcp.step();
+    if (dhcpState == DHCP_BOUND) {
+        SIMPLE_NET_STAT(_stats.dhcpSuccessCount++);
+        SIMPLE_NET_STAT(endConnectAttempt());
+        applyDhcpLease();
+        _currentState = NET_CONNECTED;
+        trace(NET_LOG_DHCP_OK, (uint32_t)_mode.dhcp.localIP());
+    } else if (dhcpState == DHCP_FAILED) {
+        SIMPLE_NET_STAT(_stats.dhcpFailureCount++);
+        SIMPLE_NET_STAT(endConnectAttempt());
+        _currentState = NET_DISCONNECTED;
+        _lastConnectionAttempt = millis();
+        _retryDelay = _retryPolicy.next();
+        trace(NET_LOG_DHCP_FAILED);
+    }
+}
+
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+void SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::maintainDhcp(NetModeTag<true>) {
+    DhcpLeaseEvent leaseEvent = _mode.dhcp.maintain();
+    if (leaseEvent == DHCP_LEASE_LOST) {
+        trace(NET_LOG_LEASE_LOST);
+        if (_mode.leaseStore) _mode.leaseStore->clear();
+        SIMPLE_NET_STAT(_stats.leaseLostCount++);
+        _currentState = NET_DISCONNECTED;
+    } else if (leaseEvent != DHCP_LEASE_NONE) {
+        applyDhcpLease();
+        _events.publish(NET_EVENT_LEASE_RENEWED);
+        checkIpChange(_mode.dhcp.localIP());
+    }
+}
+
+/**
+ * @brief Private method to program the address configuration of the current lease
+ * and record it in the lease store, if one is set.
+ */
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+void SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::applyDhcpLease() {
+    Backend::setAddresses(_chip, _mode.dhcp.localIP(), _mode.dhcp.subnetMask(), _mode.dhcp.gatewayIP(), _mode.dhcp.dnsServerIP());
+    _resolver.setServer(_mode.dhcp.dnsServerIP());
+
+    if (_mode.leaseStore) {
+        DhcpLease lease;
+        _mode.dhcp.getLease(lease);
+        _mode.leaseStore->save(lease);
+    }
+}
+
+/**
+ * @brief Sets how long a single DHCP acquisition may take before it is abandoned.
+ */
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+void SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::setDhcpTimeout(unsigned long timeout) {
+    static_assert(HasDhcp, "setDhcpTimeout() needs NET_MODE_DHCP or NET_MODE_ANY");
+    _mode.dhcpTimeout = timeout;
+}
+
+/**
+ * @brief Remembers the DHCP lease across resets; nullptr (the default) disables it.
+ * @details Each DHCP attempt then starts by requesting the stored address (INIT-REBOOT)
+ * and only runs the full DISCOVER exchange if the server refuses it. The store must
+ * outlive the manager.
+ */
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+void SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::setLeaseStore(LeaseStore* store) {
+    static_assert(HasDhcp, "setLeaseStore() needs NET_MODE_DHCP or NET_MODE_ANY");
+    _mode.leaseStore = store;
+}
+
+/**
+ * @brief Sets how long a static IP attempt waits for link, and after how many such
+ * timeouts in a row the chip configuration is rewritten (0 = never).
+ */
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+void SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::setStaticLinkPolicy(unsigned long linkTimeout, uint8_t reinitAfterFailures) {
+    static_assert(HasStatic, "setStaticLinkPolicy() needs NET_MODE_STATIC or NET_MODE_ANY");
+    _mode.linkTimeout = linkTimeout;
+    _mode.reinitThreshold = reinitAfterFailures;
+}
+
+/**
+ * @brief Makes each static IP attempt check for a duplicate address and resolve the gateway before connecting.
+ * @details Once the link is up, the chip ARPs for the node's own address (which
+ * also announces it) and then for the gateway; see NetArpCheck. An answer for our
+ * address ends the attempt in NET_ADDRESS_CONFLICT, with NET_EVENT_ADDRESS_CONFLICT,
+ * and the retry policy applies. Otherwise the gateway's MAC is pinned with
+ * NetSocket::pinGateway() for as long as the connection lasts. Off by default.
+ */
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+void SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::setStaticArpCheck(bool enabled) {
+    static_assert(HasStatic, "setStaticArpCheck() needs NET_MODE_STATIC or NET_MODE_ANY");
+    _mode.arpCheck = enabled;
+}
+
+/**
+ * @brief Returns the DHCP sub-state (meaningful while NET_CONNECTING in DHCP mode).
+ */
+template <NetMode Mode, class DebugPolicy, uint8_t CsPin, class Backend>
+DhcpState SimpleNetManagerT<Mode, DebugPolicy, CsPin, Backend>::getDhcpState() {
+    static_assert(HasDhcp, "getDhcpState() needs NET_MODE_DHCP or NET_MODE_ANY");
+    return _mode.dhcp.state();
+}
+
 } // namespace SimpleNet
 
-#endif // SIMPLE_NET_MANAGER_H
\ No newline at end of file
+#endif // SIMPLE_NET_MANAGER_H
@@ -18,7 +18,7 @@ byte mac[] = { 0xDE, 0xAD, 0xBE, 0xEF, 0xFE, 0xED };
 const char server[] = "example.com";
 
 // --- Instantiation Options ---
-// Choose ONE of the following three ways to create the network manager object.
+// Choose ONE of the following four ways to create the network manager object.
 
 // OPTION 1: Basic (MAC address only, CS pin defaults to 10)
 // SimpleNetManager netManager(mac);
@@ -29,16 +29,20 @@ const char server[] = "example.com";
 // OPTION 3: MAC, custom CS pin, and debug output (Recommended for development)
 SimpleNetManager netManager(mac, ETHERNET_CS_PIN, &Serial);
 
+// OPTION 4: Fixed at compile time; unused modes and debug output are left out of the build.
+// SimpleNetManagerT<NET_MODE_DHCP, NetNoDebug, ETHERNET_CS_PIN> netManager(mac);
+
 //-----------------------------------------------------
 // Timing for periodic HTTP request
 //-----------------------------------------------------
-unsigned long previousRequestMillis = 0;
-const long requestInterval = 15000; // Make a request every 15 seconds
+const unsigned long requestInterval = 15000; // Make a request every 15 seconds
 
 //-----------------------------------------------------
 // Function Prototypes
 //-----------------------------------------------------
 void makeHttpRequest();
+void onRequestTimer(void* context);
+void onServerResolved(IPAddress ip, void* context);
 void onNetworkConnect();
 void onNetworkDisconnect();
 
@@ -63,6 +67,11 @@ void setup() {
   netManager.onConnect(onNetworkConnect);
   netManager.onDisconnect(onNetworkDisconnect);
 
+  // DEMO 4: Schedule a periodic job (OPTIONAL).
+  // The manager runs it from loop(), and only while connected, so no millis()
+  // bookkeeping or isConnected() check is needed in the sketch.
+  netManager.every(requestInterval, onRequestTimer);
+
   // Initialize the Ethernet manager using DHCP.
   // To use a static IP, comment the line below and uncomment the static block.
   netManager.begin();
@@ -88,18 +97,10 @@ void loop() {
   netManager.loop();
 
   // The main application logic can run independently. Our onNetworkConnect() and
-  // onNetworkDisconnect() callbacks now handle connection status changes automatically.
+  // onNetworkDisconnect() callbacks now handle connection status changes automatically,
+  // and the periodic request is a job run by the manager itself.
 
-  // We can still use isConnected() for tasks that should only run while connected,
-  // like making periodic requests.
-  if (netManager.isConnected()) {
-
-    // Check if it's time to make another HTTP request
-    if (millis() - previousRequestMillis >= requestInterval) {
-      previousRequestMillis = millis(); // Save the last time we made a request
-      makeHttpRequest();
-    }
-  }
+  // A battery node could sleep here for netManager.nextWakeMs() milliseconds.
 }
 
 //-----------------------------------------------------
@@ -108,18 +109,42 @@ void loop() {
 
 /**
  * @brief Makes a simple HTTP GET request.
- * This is called by the onNetworkConnect callback and then periodically by the main loop.
+ * This is called by the onNetworkConnect callback and then periodically by onRequestTimer().
+ * The hostname is resolved first without blocking; the manager caches the answer
+ * for its TTL, so repeated requests skip DNS entirely.
  */
 void makeHttpRequest() {
-  // To make a connection, get the underlying EthernetClient from the manager.
-  // This demonstrates the getClient() function.
-  EthernetClient& client = netManager.getClient();
-
   Serial.println("\n---------------------------------");
   Serial.print("Making HTTP request to: ");
   Serial.println(server);
 
-  if (client.connect(server, 80)) {
+  if (!netManager.resolve(server, onServerResolved)) {
+    Serial.println("=> Could not start the DNS lookup.");
+  }
+}
+
+/**
+ * @brief Job scheduled in setup(); the manager calls it every requestInterval while connected.
+ */
+void onRequestTimer(void*) {
+  makeHttpRequest();
+}
+
+/**
+ * @brief Called by the manager once the server's hostname has been resolved.
+ */
+void onServerResolved(IPAddress ip, void*) {
+  if (ip == IPAddress(0, 0, 0, 0)) {
+    Serial.println("=> DNS lookup failed.");
+    Serial.println("---------------------------------");
+    return;
+  }
+
+  // To make a connection, get the underlying EthernetClient from the manager.
+  // This demonstrates the getClient() function.
+  EthernetClient& client = netManager.getClient();
+
+  if (client.connect(ip, 80)) {
     Serial.println("=> Connected to server. Sending GET request.");
     client.println("GET / HTTP/1.1");
     client.println("Host: example.com");
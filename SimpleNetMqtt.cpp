@@ -0,0 +1,433 @@
+#include "SimpleNetMqtt.h"
+
+namespace SimpleNet {
+
+// Control packet types, already shifted into the high nibble of the first byte.
+static const uint8_t MQTT_CONNECT = 0x10;
+static const uint8_t MQTT_CONNACK_PACKET = 0x20;
+static const uint8_t MQTT_PUBLISH = 0x30;
+static const uint8_t MQTT_PUBACK = 0x40;
+static const uint8_t MQTT_PINGREQ = 0xC0;
+static const uint8_t MQTT_PINGRESP = 0xD0;
+static const uint8_t MQTT_DISCONNECT = 0xE0;
+
+static const uint8_t MQTT_FLAG_USER = 0x80;
+static const uint8_t MQTT_FLAG_PASSWORD = 0x40;
+static const uint8_t MQTT_FLAG_CLEAN = 0x02;
+
+static const uint8_t MQTT_MAX_HEADER = 5; ///< Type byte plus up to four length bytes.
+
+/**
+ * @brief Encodes the MQTT variable-length "remaining length" field.
+ * @return The number of bytes written to out (1-4).
+ */
+static uint8_t encodeLength(uint8_t* out, uint32_t length) {
+    uint8_t count = 0;
+    do {
+        uint8_t digit = length & 0x7F;
+        length >>= 7;
+        if (length > 0) digit |= 0x80;
+        out[count++] = digit;
+    } while (length > 0 && count < 4);
+    return count;
+}
+
+MqttClient::MqttClient(SimpleNetManagerBase& manager)
+    : NetService(manager), _manager(manager), _retry(2000, 60000, 2, 10) {
+    _socket.attach(manager.chip());
+    _state = MQTT_DISCONNECTED;
+    _enabled = true;
+    _port = 0;
+    _clientId = nullptr;
+    _user = nullptr;
+    _password = nullptr;
+    _keepAlive = 60;
+    _timeout = 10000;
+    _retryDelay = 0;
+    _stateSince = 0;
+    _staged = 0;
+    _lastTx = 0;
+    _lastRx = 0;
+    _pingPending = false;
+    _skip = 0;
+    _inFlight = 0;
+    _nextPacketId = 0;
+    _lastPacketId = 0;
+    _connackCode = 0;
+    _onConnect = nullptr;
+    _onDisconnect = nullptr;
+    _onAck = nullptr;
+}
+
+void MqttClient::setServer(IPAddress ip, uint16_t port) {
+    _ip = ip;
+    _port = port;
+}
+
+/**
+ * @brief Encodes a PUBLISH into the TX buffer behind anything already staged.
+ */
+bool MqttClient::publish(const char* topic, const uint8_t* payload, uint16_t length, uint8_t qos, bool retain) {
+    if (_state != MQTT_CONNECTED || qos > 1) {
+        return false;
+    }
+    if (qos == 1 && _inFlight >= SIMPLE_NET_MQTT_WINDOW) {
+        return false;
+    }
+
+    uint16_t topicLength = strlen(topic);
+    uint32_t remaining = 2 + topicLength + (qos ? 2 : 0) + length;
+    uint8_t type = MQTT_PUBLISH | (qos << 1) | (retain ? 1 : 0);
+    if (topicLength == 0 || !stageHeader(type, remaining)) {
+        return false;
+    }
+
+    stageString(topic);
+    if (qos == 1) {
+        if (++_nextPacketId == 0) _nextPacketId = 1;
+        uint8_t id[2] = { (uint8_t)(_nextPacketId >> 8), (uint8_t)_nextPacketId };
+        stage(id, sizeof(id));
+        _window[_inFlight].packetId = _nextPacketId;
+        _window[_inFlight].sentAt = millis();
+        _inFlight++;
+        _lastPacketId = _nextPacketId;
+    }
+    stage(payload, length);
+    return true;
+}
+
+void MqttClient::disconnect() {
+    _enabled = false;
+    unsigned long now = millis();
+    if (_state != MQTT_CONNECTED || !_socket.sendComplete()) {
+        drop(now, true);
+        return;
+    }
+
+    // DISCONNECT goes out behind anything staged, then FIN; poll() releases the socket.
+    if (stageHeader(MQTT_DISCONNECT, 0)) {
+        _socket.commit(_staged);
+    }
+    _socket.disconnect();
+    drop(now, false);
+}
+
+/**
+ * @brief Connects to the broker on the next tick.
+ */
+void MqttClient::networkUp() {
+    _retry.reset();
+    _retryDelay = 0;
+    _stateSince = millis();
+    _enabled = true;
+}
+
+void MqttClient::networkDown() {
+    drop(millis());
+}
+
+/**
+ * @brief Advances the session by one tick. Called by SimpleNetManager::loop().
+ */
+void MqttClient::poll() {
+    if (!_manager.isConnected()) {
+        return;
+    }
+
+    unsigned long now = millis();
+    switch (_state) {
+        case MQTT_DISCONNECTED:
+            if (_socket.isOpen()) {
+                // Closing after disconnect(): wait for the FIN exchange, within the timeout.
+                if (_socket.status() == SnSR::CLOSED || now - _stateSince >= _timeout) {
+                    _socket.close();
+                }
+                return;
+            }
+            if (_enabled && _port != 0 && _clientId && now - _stateSince >= _retryDelay) {
+                startConnect(now);
+            }
+            return;
+
+        case MQTT_CONNECTING: {
+            uint8_t status = _socket.status();
+            if (status == SnSR::ESTABLISHED) {
+                sendConnect();
+                _state = MQTT_CONNACK;
+                _stateSince = now;
+                _lastRx = now;
+            } else if (status == SnSR::CLOSED || now - _stateSince >= _timeout) {
+                drop(now);
+                return;
+            }
+            break;
+        }
+
+        case MQTT_CONNACK:
+        case MQTT_CONNECTED:
+            if (_socket.status() != SnSR::ESTABLISHED) {
+                drop(now);
+                return;
+            }
+            receive(now);
+            if (_state == MQTT_CONNACK && now - _stateSince >= _timeout) {
+                drop(now);
+                return;
+            }
+            if (_state != MQTT_CONNECTED) break;
+
+            if (_inFlight > 0 && now - _window[0].sentAt >= _timeout) {
+                drop(now); // The broker stopped acknowledging.
+                return;
+            }
+            if (_keepAlive > 0) {
+                unsigned long interval = _keepAlive * 1000UL;
+                if (now - _lastRx >= interval + interval / 2) {
+                    drop(now); // 1.5 keepalive periods without a packet: the broker is gone.
+                    return;
+                }
+                if (!_pingPending && now - _lastTx >= interval && stageHeader(MQTT_PINGREQ, 0)) {
+                    _pingPending = true;
+                }
+            }
+            break;
+    }
+
+    flush(now);
+}
+
+unsigned long MqttClient::wakeDelay() {
+    if (!_manager.isConnected()) {
+        return NET_WAKE_NEVER;
+    }
+
+    unsigned long now = millis();
+    if (_state == MQTT_DISCONNECTED) {
+        if (_socket.isOpen()) {
+            return 0;
+        }
+        if (!_enabled || _port == 0 || !_clientId) {
+            return NET_WAKE_NEVER;
+        }
+        return now - _stateSince >= _retryDelay ? 0 : _retryDelay - (now - _stateSince);
+    }
+    if (_state != MQTT_CONNECTED || _staged > 0 || _inFlight > 0 || _pingPending) {
+        return 0; // Waiting for the broker; an answer can arrive at any time.
+    }
+    if (_keepAlive == 0) {
+        return NET_WAKE_NEVER;
+    }
+    unsigned long interval = _keepAlive * 1000UL;
+    return now - _lastTx >= interval ? 0 : interval - (now - _lastTx);
+}
+
+/**
+ * @brief Private method to open the socket and issue a non-blocking TCP connect.
+ */
+void MqttClient::startConnect(unsigned long now) {
+    _stateSince = now;
+    if (!_socket.openTcp() || !_socket.connect(_ip, _port)) {
+        _socket.close();
+        _retryDelay = _retry.next(); // No free socket.
+        return;
+    }
+    _state = MQTT_CONNECTING;
+}
+
+/**
+ * @brief Private method to stage the CONNECT packet: clean session, optional credentials.
+ */
+void MqttClient::sendConnect() {
+    uint8_t flags = MQTT_FLAG_CLEAN;
+    uint32_t remaining = 10 + 2 + strlen(_clientId);
+    if (_user) {
+        flags |= MQTT_FLAG_USER;
+        remaining += 2 + strlen(_user);
+    }
+    if (_password) {
+        flags |= MQTT_FLAG_PASSWORD;
+        remaining += 2 + strlen(_password);
+    }
+
+    _staged = 0;
+    _inFlight = 0;
+    _pingPending = false;
+    _skip = 0;
+    if (!stageHeader(MQTT_CONNECT, remaining)) {
+        return; // A fresh socket always has room; the CONNACK timeout covers the rest.
+    }
+    uint8_t header[10] = { 0, 4, 'M', 'Q', 'T', 'T', 4, flags, (uint8_t)(_keepAlive >> 8), (uint8_t)_keepAlive };
+    stage(header, sizeof(header));
+    stageString(_clientId);
+    if (_user) stageString(_user);
+    if (_password) stageString(_password);
+}
+
+/**
+ * @brief Private method to handle every complete packet waiting in the RX buffer.
+ * @details Packets are parsed in place with peekAt(). Anything other than CONNACK,
+ * PUBACK and PINGRESP (this client never subscribes) is skipped, even if it only
+ * arrives in pieces.
+ */
+void MqttClient::receive(unsigned long now) {
+    uint16_t available = _socket.rxAvailable();
+    while (available > 0) {
+        if (_skip > 0) {
+            uint16_t count = _skip < available ? _skip : available;
+            _socket.consume(count);
+            _skip -= count;
+            available -= count;
+            continue;
+        }
+
+        uint8_t header[MQTT_MAX_HEADER];
+        uint8_t headerLength = available < MQTT_MAX_HEADER ? available : MQTT_MAX_HEADER;
+        _socket.peekAt(0, header, headerLength);
+
+        uint32_t remaining = 0;
+        uint8_t used = 1;
+        bool complete = false;
+        for (uint8_t shift = 0; used < headerLength; shift += 7) {
+            uint8_t digit = header[used++];
+            remaining |= (uint32_t)(digit & 0x7F) << shift;
+            if (!(digit & 0x80)) {
+                complete = true;
+                break;
+            }
+        }
+        if (!complete) {
+            if (headerLength == MQTT_MAX_HEADER) {
+                drop(now); // Malformed length field.
+            }
+            return;
+        }
+
+        _lastRx = now;
+        uint8_t type = header[0] & 0xF0;
+        if (remaining > 4 || (type != MQTT_CONNACK_PACKET && type != MQTT_PUBACK && type != MQTT_PINGRESP)) {
+            _skip = used + remaining;
+            continue;
+        }
+        if (available < used + remaining) {
+            return; // The rest of a small packet is still on its way.
+        }
+
+        uint8_t body[4];
+        _socket.peekAt(used, body, remaining);
+        _socket.consume(used + remaining);
+        available -= used + remaining;
+        handlePacket(type, body, remaining, now);
+        if (_state == MQTT_DISCONNECTED) {
+            return;
+        }
+    }
+}
+
+void MqttClient::handlePacket(uint8_t type, const uint8_t* body, uint8_t length, unsigned long now) {
+    if (type == MQTT_CONNACK_PACKET && length == 2 && _state == MQTT_CONNACK) {
+        _connackCode = body[1];
+        if (_connackCode != 0) {
+            drop(now); // Refused: bad protocol level, identifier, credentials, or broker unavailable.
+            return;
+        }
+        _state = MQTT_CONNECTED;
+        _stateSince = now;
+        _retry.reset();
+        if (_onConnect) {
+            _onConnect(*this);
+        }
+    } else if (type == MQTT_PUBACK && length == 2) {
+        acknowledge(((uint16_t)body[0] << 8) | body[1]);
+    } else if (type == MQTT_PINGRESP) {
+        _pingPending = false;
+    }
+}
+
+/**
+ * @brief Private method to remove a PUBACKed packet from the window, in any order.
+ */
+void MqttClient::acknowledge(uint16_t packetId) {
+    for (uint8_t i = 0; i < _inFlight; i++) {
+        if (_window[i].packetId != packetId) {
+            continue;
+        }
+        for (uint8_t j = i + 1; j < _inFlight; j++) {
+            _window[j - 1] = _window[j];
+        }
+        _inFlight--;
+        if (_onAck) {
+            _onAck(packetId, true);
+        }
+        return;
+    }
+}
+
+/**
+ * @brief Private method to send everything staged since the last SEND, as one SEND.
+ */
+void MqttClient::flush(unsigned long now) {
+    if (_staged > 0 && _socket.sendComplete()) {
+        _socket.commit(_staged);
+        _staged = 0;
+        _lastTx = now;
+    }
+}
+
+/**
+ * @brief Private method to end the session: close the socket (unless a graceful close
+ * is under way), fail the window and schedule a retry.
+ */
+void MqttClient::drop(unsigned long now, bool closeSocket) {
+    bool wasConnected = (_state == MQTT_CONNECTED);
+    if (closeSocket) {
+        _socket.close();
+    }
+    _state = MQTT_DISCONNECTED;
+    _stateSince = now;
+    _retryDelay = _retry.next();
+    _staged = 0;
+    _pingPending = false;
+    _skip = 0;
+
+    uint8_t lost = _inFlight;
+    _inFlight = 0;
+    for (uint8_t i = 0; i < lost; i++) {
+        if (_onAck) {
+            _onAck(_window[i].packetId, false);
+        }
+    }
+    if (wasConnected && _onDisconnect) {
+        _onDisconnect(*this);
+    }
+}
+
+/**
+ * @brief Private method to write a fixed header if the whole packet fits the TX buffer.
+ */
+bool MqttClient::stageHeader(uint8_t type, uint32_t remaining) {
+    uint8_t header[MQTT_MAX_HEADER];
+    header[0] = type;
+    uint8_t length = 1 + encodeLength(header + 1, remaining);
+    if ((uint32_t)_staged + length + remaining > _socket.txFree()) {
+        return false;
+    }
+    stage(header, length);
+    return true;
+}
+
+void MqttClient::stage(const uint8_t* data, uint16_t length) {
+    _socket.writeAt(_staged, data, length);
+    _staged += length;
+}
+
+/**
+ * @brief Private method to stage a length-prefixed UTF-8 string.
+ */
+void MqttClient::stageString(const char* text) {
+    uint16_t length = strlen(text);
+    uint8_t prefix[2] = { (uint8_t)(length >> 8), (uint8_t)length };
+    stage(prefix, sizeof(prefix));
+    stage((const uint8_t*)text, length);
+}
+
+} // namespace SimpleNet
@@ -0,0 +1,176 @@
+#ifndef SIMPLE_NET_MQTT_H
+#define SIMPLE_NET_MQTT_H
+
+#include <Arduino.h>
+#include "SimpleNetManager.h"
+#include "SimpleNetSocket.h"
+#include "SimpleNetRetry.h"
+
+#ifndef SIMPLE_NET_MQTT_WINDOW
+#define SIMPLE_NET_MQTT_WINDOW 4 ///< QoS 1 publishes that can await their PUBACK at once.
+#endif
+
+namespace SimpleNet {
+
+/**
+ * @brief Session state of an MqttClient.
+ */
+enum MqttState {
+    MQTT_DISCONNECTED, ///< No session; a connect is attempted when the retry delay is up.
+    MQTT_CONNECTING,   ///< TCP handshake in progress.
+    MQTT_CONNACK,      ///< CONNECT sent, waiting for the broker's CONNACK.
+    MQTT_CONNECTED     ///< Session established; publish() is accepted.
+};
+
+class MqttClient;
+
+/// Callback type for session changes.
+typedef void (*MqttCallback)(MqttClient& client);
+
+/// QoS 1 outcome callback: delivered is false if the session ended before the PUBACK.
+typedef void (*MqttAckCallback)(uint16_t packetId, bool delivered);
+
+/**
+ * @brief An allocation-free MQTT 3.1.1 publisher whose session is run by SimpleNetManager::loop().
+ * @details The session is opened when the manager connects and whenever it drops
+ * while connected, with backoff from a RetryPolicy, and torn down on networkDown();
+ * nothing blocks. publish() encodes the packet straight into the socket's TX
+ * buffer. Packets published between two loop() ticks go out together in one SEND.
+ *
+ * QoS 1 publishes are pipelined: up to SIMPLE_NET_MQTT_WINDOW wait for their
+ * PUBACK at the same time, and onAck reports each one as it arrives. Payloads are
+ * not kept in SRAM, so a publish still unacknowledged when the session ends is not
+ * resent; onAck reports it with delivered = false, and the application decides
+ * whether to publish it again. Sessions are always clean.
+ */
+class MqttClient : public NetService {
+public:
+    explicit MqttClient(SimpleNetManagerBase& manager);
+
+    /**
+     * @brief Sets the broker address.
+     */
+    void setServer(IPAddress ip, uint16_t port = 1883);
+
+    /**
+     * @brief Sets the client identifier. The string must stay valid.
+     */
+    void setClientId(const char* clientId) { _clientId = clientId; }
+
+    /**
+     * @brief Sets the user name and password (nullptr for none). The strings must stay valid.
+     */
+    void setCredentials(const char* user, const char* password) { _user = user; _password = password; }
+
+    /**
+     * @brief Sets the keepalive interval in seconds (default 60; 0 disables it).
+     */
+    void setKeepAlive(uint16_t seconds) { _keepAlive = seconds; }
+
+    /**
+     * @brief Sets how long the TCP connect, the CONNACK and each PUBACK may take
+     * before the session is dropped (default 10,000 ms).
+     */
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+
+    /**
+     * @brief Sets the backoff between connection attempts to the broker.
+     */
+    void setRetryPolicy(const RetryPolicy& policy) { _retry = policy; }
+
+    /**
+     * @brief Queues a PUBLISH in the chip's TX buffer; it is sent on the next loop() tick.
+     * @param qos 0 or 1.
+     * @return false if not connected, the TX buffer is full, or (QoS 1) the window is full.
+     * For QoS 1, lastPacketId() then identifies the message in onAck.
+     */
+    bool publish(const char* topic, const uint8_t* payload, uint16_t length, uint8_t qos = 0, bool retain = false);
+    bool publish(const char* topic, const char* text, uint8_t qos = 0, bool retain = false) {
+        return publish(topic, (const uint8_t*)text, strlen(text), qos, retain);
+    }
+
+    /**
+     * @brief Sends DISCONNECT and closes the session until the next networkUp or reconnect().
+     */
+    void disconnect();
+
+    /**
+     * @brief Allows connecting again after disconnect().
+     */
+    void reconnect() { _enabled = true; }
+
+    void onConnect(MqttCallback callback) { _onConnect = callback; }
+    void onDisconnect(MqttCallback callback) { _onDisconnect = callback; }
+    void onAck(MqttAckCallback callback) { _onAck = callback; }
+
+    MqttState state() const { return _state; }
+    bool      isConnected() const { return _state == MQTT_CONNECTED; }
+    uint16_t  lastPacketId() const { return _lastPacketId; }
+    uint8_t   inFlight() const { return _inFlight; }
+
+    /**
+     * @brief Returns the return code of the last CONNACK (0 = accepted).
+     */
+    uint8_t connackCode() const { return _connackCode; }
+
+protected:
+    void poll() override;
+    void networkUp() override;
+    void networkDown() override;
+    unsigned long wakeDelay() override;
+
+private:
+    struct Pending {
+        uint16_t      packetId;
+        unsigned long sentAt;
+    };
+
+    SimpleNetManagerBase& _manager;
+    NetSocket      _socket;
+    MqttState      _state;
+    bool           _enabled;
+
+    IPAddress      _ip;
+    uint16_t       _port;
+    const char*    _clientId;
+    const char*    _user;
+    const char*    _password;
+    uint16_t       _keepAlive;
+    unsigned long  _timeout;
+
+    RetryPolicy    _retry;
+    unsigned long  _retryDelay;
+    unsigned long  _stateSince;
+
+    uint16_t       _staged;       ///< Bytes written past the TX write pointer, not yet sent.
+    unsigned long  _lastTx;
+    unsigned long  _lastRx;
+    bool           _pingPending;
+    uint32_t       _skip;         ///< Bytes of an unwanted incoming packet still to discard.
+
+    Pending        _window[SIMPLE_NET_MQTT_WINDOW];
+    uint8_t        _inFlight;
+    uint16_t       _nextPacketId;
+    uint16_t       _lastPacketId;
+    uint8_t        _connackCode;
+
+    MqttCallback    _onConnect;
+    MqttCallback    _onDisconnect;
+    MqttAckCallback _onAck;
+
+    void startConnect(unsigned long now);
+    void sendConnect();
+    void receive(unsigned long now);
+    void handlePacket(uint8_t type, const uint8_t* body, uint8_t length, unsigned long now);
+    void acknowledge(uint16_t packetId);
+    void flush(unsigned long now);
+    void drop(unsigned long now, bool closeSocket = true);
+
+    bool stageHeader(uint8_t type, uint32_t remaining);
+    void stage(const uint8_t* data, uint16_t length);
+    void stageString(const char* text);
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_MQTT_H
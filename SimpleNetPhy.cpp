@@ -0,0 +1,47 @@
+#include "SimpleNetPhy.h"
+
+namespace SimpleNet {
+
+// W5500 PHYCFGR fields.
+static const uint8_t PHYCFGR_RST = 0x80;       ///< Written as 0 to reset the PHY, then 1 to run.
+static const uint8_t PHYCFGR_OPMD = 0x40;      ///< Take the operation mode from OPMDC instead of the pins.
+static const uint8_t PHYCFGR_OPMDC = 0x38;     ///< Operation mode bits.
+static const uint8_t PHYCFGR_POWER_DOWN = 0x30;
+
+bool NetPhy::powerDown() {
+    if (_poweredDown) {
+        return true;
+    }
+    if (_chip->type() != 55) {
+        return false;
+    }
+
+    SPI.beginTransaction(NetSpi::settings());
+    _config = _chip->readCommon(NET_PHYCFGR) & (PHYCFGR_OPMD | PHYCFGR_OPMDC);
+    SPI.endTransaction();
+
+    writeConfig(PHYCFGR_OPMD | PHYCFGR_POWER_DOWN);
+    _poweredDown = true;
+    return true;
+}
+
+void NetPhy::powerUp() {
+    if (!_poweredDown) {
+        return;
+    }
+
+    writeConfig(_config);
+    _poweredDown = false;
+}
+
+/**
+ * @brief Private method to apply an operation mode; the PHY only takes it on a reset.
+ */
+void NetPhy::writeConfig(uint8_t config) {
+    SPI.beginTransaction(NetSpi::settings());
+    _chip->writeCommon(NET_PHYCFGR, config);
+    _chip->writeCommon(NET_PHYCFGR, (uint8_t)(config | PHYCFGR_RST));
+    SPI.endTransaction();
+}
+
+} // namespace SimpleNet
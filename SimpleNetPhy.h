@@ -0,0 +1,53 @@
+#ifndef SIMPLE_NET_PHY_H
+#define SIMPLE_NET_PHY_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <Ethernet.h>
+#include <utility/w5100.h>
+#include "SimpleNetSpi.h"
+#include "SimpleNetChip.h"
+
+namespace SimpleNet {
+
+/**
+ * @brief Powers the Ethernet PHY down and back up through the chip's registers.
+ * @details Only the W5500 can do this in software (PHYCFGR operation mode "power
+ * down"); on the W5100 and W5200 powerDown() does nothing and returns false. While
+ * powered down the link reads as LinkOFF and nothing can be sent or received, but
+ * the chip keeps its address configuration. After powerUp() the PHY needs
+ * auto-negotiation time, typically one to three seconds, before the link is back.
+ */
+class NetPhy {
+public:
+    NetPhy() : _chip(&NetChip::library()), _poweredDown(false), _config(0) {}
+
+    /**
+     * @brief Controls the PHY of chip instead of the library chip.
+     */
+    void attach(NetChip& chip) { _chip = &chip; }
+
+    /**
+     * @brief Powers the PHY down, remembering its configuration for powerUp().
+     * @return false if the chip has no software power-down.
+     */
+    bool powerDown();
+
+    /**
+     * @brief Restores the configuration saved by powerDown() and restarts the PHY.
+     */
+    void powerUp();
+
+    bool isPoweredDown() const { return _poweredDown; }
+
+private:
+    NetChip* _chip;
+    bool    _poweredDown;
+    uint8_t _config;      ///< PHYCFGR operation mode bits in use before powerDown().
+
+    void writeConfig(uint8_t config);
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_PHY_H
@@ -0,0 +1,92 @@
+#include "SimpleNetProbe.h"
+
+namespace SimpleNet {
+
+static const uint8_t  ICMP_ECHO_REPLY = 0;
+static const uint8_t  ICMP_ECHO_REQUEST = 8;
+static const uint16_t PROBE_ID = 0x534E;       ///< Echo identifier, "SN".
+static const uint8_t  RAW_HEADER_SIZE = 6;     ///< Source IP and length before each received packet.
+static const uint8_t  ECHO_SIZE = 8;           ///< ICMP header; no payload is needed.
+
+NetProbe::NetProbe() {
+    _sequence = 0;
+    _sentAt = 0;
+    _timeout = 0;
+}
+
+bool NetProbe::start(IPAddress target, unsigned long timeout) {
+    if (!_socket.openRaw(IPPROTO::ICMP)) {
+        return false;
+    }
+
+    _target = target;
+    _timeout = timeout;
+    _sequence++;
+
+    uint8_t echo[ECHO_SIZE] = {
+        ICMP_ECHO_REQUEST, 0, 0, 0,
+        (uint8_t)(PROBE_ID >> 8), (uint8_t)PROBE_ID,
+        (uint8_t)(_sequence >> 8), (uint8_t)_sequence
+    };
+    // Internet checksum: one's complement of the one's complement sum of 16-bit words.
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < ECHO_SIZE; i += 2) {
+        sum += ((uint16_t)echo[i] << 8) | echo[i + 1];
+    }
+    while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+    uint16_t checksum = ~sum;
+    echo[2] = checksum >> 8;
+    echo[3] = checksum;
+
+    _socket.setDestination(target, 0);
+    _socket.send(echo, sizeof(echo));
+    _sentAt = millis();
+    return true;
+}
+
+NetProbeResult NetProbe::poll() {
+    if (!isRunning()) {
+        return NET_PROBE_FAILED;
+    }
+
+    if (_socket.sendComplete()) {
+        if (_socket.sendFailed()) {
+            return finish(NET_PROBE_FAILED); // ARP timed out: nothing answers at that address.
+        }
+
+        // Skip anything that is not our reply (other ICMP traffic reaches the socket too).
+        while (_socket.rxAvailable() >= RAW_HEADER_SIZE) {
+            uint8_t header[RAW_HEADER_SIZE];
+            _socket.peekAt(0, header, RAW_HEADER_SIZE);
+            uint16_t length = ((uint16_t)header[4] << 8) | header[5];
+
+            uint8_t echo[ECHO_SIZE];
+            bool match = false;
+            if (length >= ECHO_SIZE) {
+                _socket.peekAt(RAW_HEADER_SIZE, echo, ECHO_SIZE);
+                match = IPAddress(header) == _target && echo[0] == ICMP_ECHO_REPLY
+                        && (((uint16_t)echo[4] << 8) | echo[5]) == PROBE_ID
+                        && (((uint16_t)echo[6] << 8) | echo[7]) == _sequence;
+            }
+            _socket.consume(RAW_HEADER_SIZE + length);
+            if (match) {
+                return finish(NET_PROBE_OK);
+            }
+        }
+    }
+
+    if (millis() - _sentAt >= _timeout) {
+        return finish(NET_PROBE_FAILED);
+    }
+    return NET_PROBE_PENDING;
+}
+
+/**
+ * @brief Private method to release the socket and pass the result through.
+ */
+NetProbeResult NetProbe::finish(NetProbeResult result) {
+    _socket.close();
+    return result;
+}
+
+} // namespace SimpleNet
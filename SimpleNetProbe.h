@@ -0,0 +1,65 @@
+#ifndef SIMPLE_NET_PROBE_H
+#define SIMPLE_NET_PROBE_H
+
+#include <Arduino.h>
+#include "SimpleNetSocket.h"
+
+namespace SimpleNet {
+
+/**
+ * @brief Outcome of a NetProbe.
+ */
+enum NetProbeResult {
+    NET_PROBE_PENDING, ///< Waiting for the echo reply.
+    NET_PROBE_OK,      ///< The target answered.
+    NET_PROBE_FAILED   ///< No ARP reply, no echo reply in time, or no free socket.
+};
+
+/**
+ * @brief A single non-blocking ICMP echo ("ping") sent from an IP raw socket.
+ * @details The chip resolves the target's MAC with ARP before sending, so an
+ * unreachable neighbour fails as soon as the chip gives up on ARP, and a target
+ * that is reachable at layer 2 but not answering fails at the timeout. The socket
+ * is held only from start() until the result is known.
+ */
+class NetProbe {
+public:
+    NetProbe();
+
+    /**
+     * @brief Sends an echo request to target.
+     * @return false if no hardware socket is free.
+     */
+    bool start(IPAddress target, unsigned long timeout);
+
+    /**
+     * @brief Checks for the reply without waiting; the socket is released once the
+     * result is NET_PROBE_OK or NET_PROBE_FAILED.
+     */
+    NetProbeResult poll();
+
+    /**
+     * @brief Abandons a probe in progress.
+     */
+    void stop() { _socket.close(); }
+
+    bool isRunning() const { return _socket.isOpen(); }
+
+    /**
+     * @brief Sends probes from chip instead of the library chip.
+     */
+    void attach(NetChip& chip) { _socket.attach(chip); }
+
+private:
+    NetSocket     _socket;
+    IPAddress     _target;
+    uint16_t      _sequence;
+    unsigned long _sentAt;
+    unsigned long _timeout;
+
+    NetProbeResult finish(NetProbeResult result);
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_PROBE_H
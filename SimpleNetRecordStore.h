@@ -0,0 +1,54 @@
+#ifndef SIMPLE_NET_RECORD_STORE_H
+#define SIMPLE_NET_RECORD_STORE_H
+
+#include <Arduino.h>
+
+namespace SimpleNet {
+
+/**
+ * @brief Byte-addressed storage behind a StoreAndForward queue.
+ * @details The queue uses the store as a ring: it writes at increasing addresses,
+ * wraps to 0 at size(), and never writes over bytes it has not yet read back or
+ * dropped. Implement this to queue more than fits in SRAM, for example on an SPI
+ * flash (erasing a sector when the ring first writes into it) or in a file on SD.
+ * The queue's read and write positions are kept in SRAM, so a store adds capacity,
+ * not persistence across a reset. See RamRecordStore for the SRAM version.
+ */
+class RecordStore {
+public:
+    virtual ~RecordStore() {}
+
+    /**
+     * @brief Returns the capacity in bytes.
+     */
+    virtual uint32_t size() const = 0;
+
+    /**
+     * @brief Copies len bytes starting at address into buf. Never crosses size().
+     */
+    virtual void read(uint32_t address, uint8_t* buf, uint16_t len) = 0;
+
+    /**
+     * @brief Stores len bytes from buf starting at address. Never crosses size().
+     */
+    virtual void write(uint32_t address, const uint8_t* buf, uint16_t len) = 0;
+};
+
+/**
+ * @brief A RecordStore in a statically allocated SRAM buffer.
+ * @tparam N Capacity in bytes. Every record takes two bytes more than its length.
+ */
+template <uint16_t N>
+class RamRecordStore : public RecordStore {
+public:
+    uint32_t size() const override { return N; }
+    void read(uint32_t address, uint8_t* buf, uint16_t len) override { memcpy(buf, _buffer + address, len); }
+    void write(uint32_t address, const uint8_t* buf, uint16_t len) override { memcpy(_buffer + address, buf, len); }
+
+private:
+    uint8_t _buffer[N];
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_RECORD_STORE_H
@@ -0,0 +1,46 @@
+#include "SimpleNetRetry.h"
+
+namespace SimpleNet {
+
+RetryPolicy::RetryPolicy(unsigned long minInterval, unsigned long maxInterval, uint8_t multiplier, uint8_t jitterPercent) {
+    _minInterval = minInterval;
+    _maxInterval = (maxInterval < minInterval) ? minInterval : maxInterval;
+    _current = _minInterval;
+    _multiplier = (multiplier == 0) ? 1 : multiplier;
+    _jitterPercent = (jitterPercent > 100) ? 100 : jitterPercent;
+    _state = 0x9E3779B9UL;
+}
+
+/**
+ * @brief Folds the MAC into the generator state; the low bytes differ across a fleet.
+ */
+void RetryPolicy::seed(const byte mac[]) {
+    uint32_t state = 0x9E3779B9UL;
+    for (uint8_t i = 0; i < 6; i++) {
+        state = (state ^ mac[i]) * 16777619UL; // FNV-1a
+    }
+    _state = state ? state : 0x9E3779B9UL;
+}
+
+unsigned long RetryPolicy::next() {
+    unsigned long delay = _current;
+
+    if (_current < _maxInterval) {
+        _current = (_current > _maxInterval / _multiplier) ? _maxInterval : _current * _multiplier;
+    }
+
+    if (_jitterPercent > 0 && delay > 0) {
+        _state ^= _state << 13;
+        _state ^= _state >> 17;
+        _state ^= _state << 5;
+
+        unsigned long spread = (delay / 100UL) * _jitterPercent;
+        if (spread > 0) {
+            // Uniform in [delay - spread, delay + spread].
+            delay = delay - spread + (_state % (2UL * spread + 1UL));
+        }
+    }
+    return delay;
+}
+
+} // namespace SimpleNet
@@ -0,0 +1,55 @@
+#ifndef SIMPLE_NET_RETRY_H
+#define SIMPLE_NET_RETRY_H
+
+#include <Arduino.h>
+
+namespace SimpleNet {
+
+/**
+ * @brief Computes reconnect delays: exponential backoff with per-device jitter.
+ * @details The delay starts at the minimum interval and is multiplied after each
+ * failed attempt, up to the maximum. Each delay is then spread by up to +/- the
+ * jitter percentage using a generator seeded from the MAC address, so a fleet that
+ * lost the network at the same moment does not retry in lockstep.
+ */
+class RetryPolicy {
+public:
+    /**
+     * @param minInterval First delay in milliseconds.
+     * @param maxInterval Upper bound of the delay in milliseconds.
+     * @param multiplier Factor applied after each failed attempt (1 = fixed interval).
+     * @param jitterPercent Random spread of each delay, 0-100.
+     */
+    RetryPolicy(unsigned long minInterval = 10000, unsigned long maxInterval = 10000,
+                uint8_t multiplier = 2, uint8_t jitterPercent = 0);
+
+    /**
+     * @brief Seeds the jitter generator. Devices should pass their MAC address.
+     */
+    void seed(const byte mac[]);
+
+    /**
+     * @brief Returns the delay before the next attempt and advances the backoff.
+     */
+    unsigned long next();
+
+    /**
+     * @brief Restarts the backoff at the minimum interval (after a successful connect).
+     */
+    void reset() { _current = _minInterval; }
+
+    unsigned long minInterval() const { return _minInterval; }
+    unsigned long maxInterval() const { return _maxInterval; }
+
+private:
+    unsigned long _minInterval;
+    unsigned long _maxInterval;
+    unsigned long _current;
+    uint8_t       _multiplier;
+    uint8_t       _jitterPercent;
+    uint32_t      _state; ///< xorshift32 state, independent of the sketch's random().
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_RETRY_H
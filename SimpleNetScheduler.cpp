@@ -0,0 +1,90 @@
+#include "SimpleNetScheduler.h"
+
+namespace SimpleNet {
+
+NetScheduler::NetScheduler() {
+    memset(_jobs, 0, sizeof(_jobs));
+    _lastScan = 0;
+    _untilNext = NET_WAKE_NEVER;
+    _rescan = false;
+    _connected = false;
+}
+
+int8_t NetScheduler::schedule(unsigned long delay, unsigned long interval, NetJob job, void* context, bool requiresConnection) {
+    if (!job) {
+        return NET_NO_JOB;
+    }
+
+    for (uint8_t i = 0; i < SIMPLE_NET_MAX_JOBS; i++) {
+        if (!_jobs[i].callback) {
+            _jobs[i].callback = job;
+            _jobs[i].context = context;
+            _jobs[i].due = millis() + delay;
+            _jobs[i].interval = interval;
+            _jobs[i].requiresConnection = requiresConnection;
+            _rescan = true;
+            return i;
+        }
+    }
+    return NET_NO_JOB;
+}
+
+void NetScheduler::cancel(int8_t id) {
+    if (id < 0 || id >= SIMPLE_NET_MAX_JOBS) {
+        return;
+    }
+
+    _jobs[id].callback = nullptr;
+    _rescan = true;
+}
+
+/**
+ * @brief Runs due jobs, then works out the time to the next deadline for the fast path.
+ */
+void NetScheduler::run(unsigned long now, bool connected) {
+    if (connected != _connected) {
+        _connected = connected;
+        _rescan = true;
+    }
+    if (!_rescan && now - _lastScan < _untilNext) {
+        return;
+    }
+
+    _rescan = false;
+    for (uint8_t i = 0; i < SIMPLE_NET_MAX_JOBS; i++) {
+        Job& job = _jobs[i];
+        if (!job.callback || !isDue(job, now) || (job.requiresConnection && !connected)) {
+            continue;
+        }
+
+        NetJob callback = job.callback;
+        if (job.interval == 0) {
+            job.callback = nullptr;
+        } else {
+            job.due += job.interval;
+            // Late by a whole period (held back, or a long blocking call): restart the phase.
+            if (isDue(job, now)) job.due = now + job.interval;
+        }
+        callback(job.context);
+    }
+
+    // A job may have scheduled or cancelled others; their deadlines count from now.
+    _lastScan = now;
+    _untilNext = _rescan ? 0 : wakeDelay(now, connected);
+}
+
+unsigned long NetScheduler::wakeDelay(unsigned long now, bool connected) const {
+    unsigned long soonest = NET_WAKE_NEVER;
+    for (uint8_t i = 0; i < SIMPLE_NET_MAX_JOBS; i++) {
+        const Job& job = _jobs[i];
+        if (!job.callback || (job.requiresConnection && !connected)) {
+            continue;
+        }
+
+        unsigned long remaining = isDue(job, now) ? 0 : job.due - now;
+        if (remaining < soonest) soonest = remaining;
+    }
+    return soonest;
+}
+
+} // namespace SimpleNet
@@ -0,0 +1,80 @@
+#ifndef SIMPLE_NET_SCHEDULER_H
+#define SIMPLE_NET_SCHEDULER_H
+
+#include <Arduino.h>
+
+#ifndef SIMPLE_NET_MAX_JOBS
+#define SIMPLE_NET_MAX_JOBS 4 ///< Periodic or one-shot jobs that can be scheduled at once.
+#endif
+
+namespace SimpleNet {
+
+/// Job type; context is the pointer given when the job was scheduled.
+typedef void (*NetJob)(void* context);
+
+/// Job handle meaning "no job" (the table was full, or the job has finished).
+static const int8_t NET_NO_JOB = -1;
+
+/// Wake-up delay meaning "nothing is scheduled".
+static const unsigned long NET_WAKE_NEVER = 0xFFFFFFFFUL;
+
+/**
+ * @brief A fixed table of timed jobs run from SimpleNetManager::loop().
+ * @details run() scans the table only when the earliest deadline is reached; in
+ * between a tick costs one subtraction and compare. The deadline is worked out
+ * once per scan and again only when a job is added or cancelled, or the
+ * connection state changes.
+ *
+ * A job that needs the network and falls due while disconnected is held back and
+ * runs once on the first tick after reconnecting; missed periods are not made up.
+ * Periodic jobs keep their phase as long as they are not late by a whole interval.
+ */
+class NetScheduler {
+public:
+    NetScheduler();
+
+    /**
+     * @brief Adds a job that first runs delay milliseconds from now.
+     * @param interval Period of a repeating job, or 0 to run it only once.
+     * @param requiresConnection Hold the job back while not in NET_CONNECTED.
+     * @return A handle for cancel(), or NET_NO_JOB if all SIMPLE_NET_MAX_JOBS are in use.
+     * The handle of a one-shot job is released when the job runs.
+     */
+    int8_t schedule(unsigned long delay, unsigned long interval, NetJob job, void* context, bool requiresConnection);
+
+    /**
+     * @brief Removes a job. A job may cancel itself (or others) while it runs.
+     */
+    void cancel(int8_t id);
+
+    /**
+     * @brief Runs every job that is due.
+     */
+    void run(unsigned long now, bool connected);
+
+    /**
+     * @brief Returns the milliseconds until the next job may run, or NET_WAKE_NEVER.
+     */
+    unsigned long wakeDelay(unsigned long now, bool connected) const;
+
+private:
+    struct Job {
+        NetJob        callback;   ///< nullptr while the slot is free.
+        void*         context;
+        unsigned long due;        ///< millis() value the job is next due at.
+        unsigned long interval;   ///< 0 for a one-shot job.
+        bool          requiresConnection;
+    };
+
+    Job           _jobs[SIMPLE_NET_MAX_JOBS];
+    unsigned long _lastScan;
+    unsigned long _untilNext;     ///< Time from _lastScan to the earliest eligible deadline.
+    bool          _rescan;        ///< The table or the connection state changed since the last scan.
+    bool          _connected;     ///< Connection state at the last scan.
+
+    static bool isDue(const Job& job, unsigned long now) { return (long)(now - job.due) >= 0; }
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_SCHEDULER_H
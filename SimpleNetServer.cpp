@@ -0,0 +1,482 @@
+#include "SimpleNetServer.h"
+
+namespace SimpleNet {
+
+static const unsigned long HTTP_SERVER_DEFAULT_TIMEOUT = 5000;
+
+// Precompiled error responses, sent from flash like any static route.
+static const char RESPONSE_400[] PROGMEM = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+static const char RESPONSE_404[] PROGMEM = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+static const char RESPONSE_405[] PROGMEM = "HTTP/1.1 405 Method Not Allowed\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+static const char RESPONSE_413[] PROGMEM = "HTTP/1.1 413 Payload Too Large\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+static const char RESPONSE_414[] PROGMEM = "HTTP/1.1 414 URI Too Long\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+
+static const char CONTENT_LENGTH[] = "content-length:";
+static const uint8_t CONTENT_LENGTH_SIZE = sizeof(CONTENT_LENGTH) - 1;
+
+static HttpMethod methodFromName(const char* name) {
+    if (strcmp(name, "GET") == 0) return HTTP_GET;
+    if (strcmp(name, "HEAD") == 0) return HTTP_HEAD;
+    if (strcmp(name, "POST") == 0) return HTTP_POST;
+    if (strcmp(name, "PUT") == 0) return HTTP_PUT;
+    if (strcmp(name, "DELETE") == 0) return HTTP_DELETE;
+    return HTTP_OTHER;
+}
+
+static const __FlashStringHelper* reasonPhrase(uint16_t code) {
+    switch (code) {
+        case 200: return F("OK");
+        case 201: return F("Created");
+        case 202: return F("Accepted");
+        case 204: return F("No Content");
+        case 301: return F("Moved Permanently");
+        case 302: return F("Found");
+        case 304: return F("Not Modified");
+        case 400: return F("Bad Request");
+        case 401: return F("Unauthorized");
+        case 403: return F("Forbidden");
+        case 404: return F("Not Found");
+        case 405: return F("Method Not Allowed");
+        case 409: return F("Conflict");
+        case 500: return F("Internal Server Error");
+        case 503: return F("Service Unavailable");
+        default:  return F("Status");
+    }
+}
+
+HttpExchange::HttpExchange(NetSocket& socket, HttpMethod method, const char* path, const char* query, uint16_t contentLength)
+    : _socket(socket) {
+    _method = method;
+    _path = path;
+    _query = query;
+    _contentLength = contentLength;
+    _bodyRemaining = contentLength;
+    _stageLength = 0;
+    _offset = 0;
+    _limit = socket.txFree();
+    _begun = false;
+    _overflow = false;
+}
+
+bool HttpExchange::queryValue(const char* name, char* value, uint8_t size) const {
+    size_t nameLength = strlen(name);
+    const char* p = _query;
+    while (*p) {
+        char end = p[nameLength];
+        if (strncmp(p, name, nameLength) == 0 && (end == '=' || end == '&' || end == '\0')) {
+            const char* v = p + nameLength;
+            if (*v == '=') v++;
+            uint8_t n = 0;
+            while (*v && *v != '&' && n + 1 < size) value[n++] = *v++;
+            if (size > 0) value[n] = '\0';
+            return true;
+        }
+        p = strchr(p, '&');
+        if (!p) break;
+        p++;
+    }
+    return false;
+}
+
+int HttpExchange::read(uint8_t* buf, uint16_t len) {
+    if (len > _bodyRemaining) len = _bodyRemaining;
+    uint16_t got = _socket.recv(buf, len);
+    _bodyRemaining -= got;
+    return got;
+}
+
+void HttpExchange::begin(uint16_t code, const char* contentType) {
+    if (_begun) return;
+    _begun = true;
+
+    print(F("HTTP/1.1 "));
+    print((unsigned int)code);
+    print(' ');
+    print(reasonPhrase(code));
+    if (contentType) {
+        print(F("\r\nContent-Type: "));
+        print(contentType);
+    }
+    print(F("\r\nConnection: close\r\n\r\n"));
+}
+
+size_t HttpExchange::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+/**
+ * @brief Stages bytes in RAM and moves them into the TX buffer 32 bytes at a time.
+ */
+size_t HttpExchange::write(const uint8_t* buf, size_t size) {
+    if (!_begun) begin(200);
+
+    size_t written = 0;
+    while (written < size) {
+        if (_offset + _stageLength >= _limit) {
+            _overflow = true;
+            break;
+        }
+        if (_stageLength == sizeof(_stage)) flushStage();
+        _stage[_stageLength++] = buf[written++];
+    }
+    return written;
+}
+
+void HttpExchange::flushStage() {
+    _socket.writeAt(_offset, _stage, _stageLength);
+    _offset += _stageLength;
+    _stageLength = 0;
+}
+
+/**
+ * @brief Sends everything the handler wrote with one SEND; an empty response becomes 204.
+ * @return The response length.
+ */
+uint16_t HttpExchange::finish() {
+    if (!_begun) begin(204, nullptr);
+    flushStage();
+    if (_offset > 0) {
+        _socket.commit(_offset);
+    }
+    return _offset;
+}
+
+HttpServer::HttpServer(SimpleNetManagerBase& manager)
+    : NetService(manager), _manager(manager) {
+    for (uint8_t i = 0; i < SIMPLE_NET_HTTP_SERVER_CLIENTS; i++) {
+        _connections[i].socket.attach(manager.chip());
+        _connections[i].state = CONN_IDLE;
+        _connections[i].lastProgress = 0;
+    }
+    _routes = nullptr;
+    _routeCount = 0;
+    _port = 0;
+    _running = false;
+    _next = 0;
+    _timeout = HTTP_SERVER_DEFAULT_TIMEOUT;
+}
+
+/**
+ * @brief Stores the route table; listening starts now if connected, else on networkUp().
+ */
+void HttpServer::begin(uint16_t port, const HttpRoute* routes, uint8_t count) {
+    end();
+    _port = port;
+    _routes = routes;
+    _routeCount = count;
+    if (_manager.isConnected()) {
+        start();
+    }
+}
+
+void HttpServer::end() {
+    networkDown();
+    _port = 0;
+}
+
+uint8_t HttpServer::activeClients() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < SIMPLE_NET_HTTP_SERVER_CLIENTS; i++) {
+        if (_connections[i].state >= CONN_METHOD) count++;
+    }
+    return count;
+}
+
+void HttpServer::networkUp() {
+    if (_port != 0) {
+        start();
+    }
+}
+
+void HttpServer::networkDown() {
+    for (uint8_t i = 0; i < SIMPLE_NET_HTTP_SERVER_CLIENTS; i++) {
+        _connections[i].socket.close();
+        _connections[i].state = CONN_IDLE;
+    }
+    _running = false;
+}
+
+/**
+ * @brief Serves every connection once, rotating which one goes first.
+ */
+void HttpServer::poll() {
+    if (!_running) return;
+
+    unsigned long now = millis();
+    for (uint8_t i = 0; i < SIMPLE_NET_HTTP_SERVER_CLIENTS; i++) {
+        service(_connections[(_next + i) % SIMPLE_NET_HTTP_SERVER_CLIENTS], now);
+    }
+    _next = (_next + 1) % SIMPLE_NET_HTTP_SERVER_CLIENTS;
+}
+
+unsigned long HttpServer::wakeDelay() {
+    if (!_running) {
+        return NET_WAKE_NEVER;
+    }
+
+    // The chip accepts connections on its own; a sleeping sketch only delays the answer.
+    return activeClients() > 0 ? 0 : SIMPLE_NET_HTTP_SERVER_ACCEPT_MS;
+}
+
+void HttpServer::start() {
+    _running = true;
+    unsigned long now = millis();
+    for (uint8_t i = 0; i < SIMPLE_NET_HTTP_SERVER_CLIENTS; i++) {
+        listen(_connections[i], now);
+    }
+}
+
+/**
+ * @brief Private method to (re)open a connection's socket in LISTEN.
+ * @details Without a free hardware socket the connection stays idle and is retried
+ * after SIMPLE_NET_HTTP_SERVER_ACCEPT_MS.
+ */
+void HttpServer::listen(Connection& c, unsigned long now) {
+    c.lastProgress = now;
+    if (c.socket.openTcp(_port) && c.socket.listen()) {
+        c.state = CONN_LISTEN;
+    } else {
+        c.socket.close();
+        c.state = CONN_IDLE;
+    }
+}
+
+/**
+ * @brief Private method to advance one connection by at most one chunk of work.
+ */
+void HttpServer::service(Connection& c, unsigned long now) {
+    if (c.state == CONN_IDLE) {
+        if (now - c.lastProgress >= SIMPLE_NET_HTTP_SERVER_ACCEPT_MS) listen(c, now);
+        return;
+    }
+
+    if (c.state == CONN_LISTEN) {
+        uint8_t status = c.socket.status();
+        if (status == SnSR::CLOSED) {
+            listen(c, now);
+            return;
+        }
+        if (status != SnSR::ESTABLISHED && status != SnSR::CLOSE_WAIT) {
+            return; // Still listening, or mid-handshake.
+        }
+        c.state = CONN_METHOD;
+        c.targetLength = 0;
+        c.tooLong = false;
+        c.lengthSeen = false;
+        c.contentLength = 0;
+        c.lastProgress = now;
+    }
+
+    if (c.state < CONN_BODY) {
+        if (parse(c)) {
+            c.lastProgress = now;
+        } else if (c.socket.status() != SnSR::ESTABLISHED) {
+            listen(c, now); // The client went away before finishing its request.
+            return;
+        }
+    }
+    if (c.state == CONN_BODY && c.socket.rxAvailable() >= c.contentLength) {
+        dispatch(c);
+    }
+    if (c.state == CONN_SENDING && sendContent(c)) {
+        c.lastProgress = now;
+    }
+    if (c.state == CONN_CLOSING && c.socket.status() == SnSR::CLOSED) {
+        listen(c, now);
+        return;
+    }
+
+    if (now - c.lastProgress >= _timeout) {
+        listen(c, now); // Stalled or too slow: drop it and free the slot.
+    }
+}
+
+/**
+ * @brief Private method to parse up to SIMPLE_NET_HTTP_SERVER_CHUNK request bytes in place.
+ * @details Bytes are peeked from the RX buffer in small bursts and consumed only as
+ * far as they were parsed, so the request body stays in the chip for the handler.
+ * @return true if any bytes were consumed.
+ */
+bool HttpServer::parse(Connection& c) {
+    uint8_t stage[32];
+    uint16_t budget = SIMPLE_NET_HTTP_SERVER_CHUNK;
+    bool progress = false;
+
+    while (budget > 0 && c.state < CONN_BODY) {
+        uint16_t length = c.socket.rxAvailable();
+        if (length == 0) break;
+        if (length > sizeof(stage)) length = sizeof(stage);
+        if (length > budget) length = budget;
+
+        c.socket.peekAt(0, stage, length);
+        uint16_t used = 0;
+        while (used < length && c.state < CONN_BODY) {
+            parseByte(c, stage[used++]);
+        }
+        c.socket.consume(used);
+        budget -= used;
+        progress = true;
+    }
+    return progress;
+}
+
+void HttpServer::parseByte(Connection& c, uint8_t b) {
+    switch (c.state) {
+        case CONN_METHOD:
+            if (b == ' ') {
+                c.target[c.targetLength] = '\0';
+                c.method = methodFromName(c.target);
+                c.targetLength = 0;
+                c.state = CONN_TARGET;
+            } else if (b == '\r' || b == '\n') {
+                if (c.targetLength > 0) respond(c, RESPONSE_400); // Empty lines before the request are allowed.
+            } else if (c.targetLength < sizeof(c.target) - 1) {
+                c.target[c.targetLength++] = b;
+            }
+            break;
+
+        case CONN_TARGET:
+            if (b == ' ') {
+                c.target[c.targetLength] = '\0';
+                c.state = CONN_VERSION;
+            } else if (b == '\r' || b == '\n') {
+                respond(c, RESPONSE_400); // No HTTP version: HTTP/0.9 is not served.
+            } else if (c.targetLength < sizeof(c.target) - 1) {
+                c.target[c.targetLength++] = b;
+            } else {
+                c.tooLong = true;
+            }
+            break;
+
+        case CONN_VERSION:
+            if (b == '\n') {
+                c.column = 0;
+                c.state = CONN_HEADERS;
+            }
+            break;
+
+        case CONN_HEADERS:
+            if (b == '\r') break;
+            if (b == '\n') {
+                if (c.column == 0) headersDone(c);
+                c.column = 0;
+                break;
+            }
+            if (c.column < CONTENT_LENGTH_SIZE) {
+                // OR-ing 0x20 lower-cases letters and leaves '-' and ':' as they are.
+                c.matching = (c.column == 0 || c.matching) && (b | 0x20) == CONTENT_LENGTH[c.column];
+                if (c.matching && c.column == CONTENT_LENGTH_SIZE - 1) {
+                    if (c.lengthSeen) {
+                        respond(c, RESPONSE_400); // A second Content-Length leaves the body's end ambiguous.
+                        break;
+                    }
+                    c.lengthSeen = true;
+                }
+            } else if (c.matching && b >= '0' && b <= '9') {
+                c.contentLength = c.contentLength * 10 + (b - '0');
+                if (c.contentLength > 0xFFFF) c.contentLength = 0x10000; // Saturate; rejected below.
+            } else if (c.matching && b != ' ' && b != '\t') {
+                respond(c, RESPONSE_400); // Not a single decimal length, e.g. "5, 5".
+                break;
+            }
+            if (c.column < 0xFF) c.column++;
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Private method called at the blank line: the body is awaited next, or the request refused.
+ */
+void HttpServer::headersDone(Connection& c) {
+    if (c.tooLong) {
+        respond(c, RESPONSE_414);
+    } else if (c.target[0] != '/') {
+        respond(c, RESPONSE_400);
+    } else if (c.contentLength > c.socket.chip().rxBufferSize()) {
+        respond(c, RESPONSE_413); // The whole body must fit the socket's RX buffer.
+    } else {
+        c.state = CONN_BODY;
+    }
+}
+
+/**
+ * @brief Private method to look the request up in the PROGMEM route table and answer it.
+ */
+void HttpServer::dispatch(Connection& c) {
+    const char* query = "";
+    char* mark = strchr(c.target, '?');
+    if (mark) {
+        *mark = '\0';
+        query = mark + 1;
+    }
+
+    bool pathFound = false;
+    for (uint8_t i = 0; i < _routeCount; i++) {
+        HttpRoute route;
+        memcpy_P(&route, &_routes[i], sizeof(route));
+        if (strcmp_P(c.target, route.path) != 0) continue;
+
+        pathFound = true;
+        if (route.method != HTTP_ANY && route.method != c.method) continue;
+
+        if (route.content) {
+            respond(c, route.content);
+        } else {
+            HttpExchange exchange(c.socket, c.method, c.target, query, c.contentLength);
+            route.handler(exchange);
+            exchange.finish();
+            c.contentRemaining = 0; // sendContent() closes once the SEND completes.
+            c.state = CONN_SENDING;
+        }
+        return;
+    }
+    respond(c, pathFound ? RESPONSE_405 : RESPONSE_404);
+}
+
+void HttpServer::respond(Connection& c, const char* content) {
+    c.content = content;
+    c.contentRemaining = strlen_P(content);
+    c.state = CONN_SENDING;
+}
+
+/**
+ * @brief Private method to copy the next part of a PROGMEM response into the TX buffer.
+ * @details Each call fills as much of the free TX space as the chunk allows and
+ * issues a single SEND, so the precompiled headers and the start of the body leave
+ * together. Once the last SEND completes, the connection is closed with FIN.
+ * @return true if anything was queued or the connection moved on.
+ */
+bool HttpServer::sendContent(Connection& c) {
+    if (!c.socket.sendComplete()) return false;
+    if (c.socket.sendFailed()) {
+        c.state = CONN_CLOSING; // The chip timed out and closed the socket.
+        return true;
+    }
+    if (c.contentRemaining == 0) {
+        c.socket.disconnect();
+        c.state = CONN_CLOSING;
+        return true;
+    }
+
+    uint16_t length = c.socket.txFree();
+    if (length > c.contentRemaining) length = c.contentRemaining;
+    if (length > SIMPLE_NET_HTTP_SERVER_CHUNK) length = SIMPLE_NET_HTTP_SERVER_CHUNK;
+    if (length == 0) return false;
+
+    uint8_t block[32];
+    for (uint16_t offset = 0; offset < length; offset += sizeof(block)) {
+        uint16_t part = length - offset;
+        if (part > sizeof(block)) part = sizeof(block);
+        memcpy_P(block, c.content + offset, part);
+        c.socket.writeAt(offset, block, part);
+    }
+    c.socket.commit(length);
+    c.content += length;
+    c.contentRemaining -= length;
+    return true;
+}
+
+} // namespace SimpleNet
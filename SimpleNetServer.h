@@ -0,0 +1,216 @@
+#ifndef SIMPLE_NET_SERVER_H
+#define SIMPLE_NET_SERVER_H
+
+#include <Arduino.h>
+#include "SimpleNetManager.h"
+#include "SimpleNetSocket.h"
+
+#ifndef SIMPLE_NET_HTTP_SERVER_CLIENTS
+#define SIMPLE_NET_HTTP_SERVER_CLIENTS 2 ///< Connections served at once; each holds one hardware socket.
+#endif
+
+#ifndef SIMPLE_NET_HTTP_SERVER_TARGET
+#define SIMPLE_NET_HTTP_SERVER_TARGET 48 ///< Buffer per connection for the request path and query.
+#endif
+
+#ifndef SIMPLE_NET_HTTP_SERVER_CHUNK
+#define SIMPLE_NET_HTTP_SERVER_CHUNK 512 ///< Bytes parsed or sent per connection per loop() tick.
+#endif
+
+#ifndef SIMPLE_NET_HTTP_SERVER_ACCEPT_MS
+#define SIMPLE_NET_HTTP_SERVER_ACCEPT_MS 100 ///< Longest nextWakeMs() while only listening.
+#endif
+
+namespace SimpleNet {
+
+/**
+ * @brief Request methods an HttpRoute can match.
+ */
+enum HttpMethod {
+    HTTP_ANY,    ///< Matches every method.
+    HTTP_GET,
+    HTTP_HEAD,
+    HTTP_POST,
+    HTTP_PUT,
+    HTTP_DELETE,
+    HTTP_OTHER   ///< A method not listed here; only HTTP_ANY routes match it.
+};
+
+class HttpExchange;
+
+/// Handler type for dynamic routes.
+typedef void (*HttpHandler)(HttpExchange& exchange);
+
+/**
+ * @brief One entry of the route table. The table and its strings live in PROGMEM.
+ * @details A route either serves content, a complete precompiled response (status
+ * line, headers and body) streamed straight from flash, or calls handler, which
+ * writes a response through the HttpExchange.
+ */
+struct HttpRoute {
+    uint8_t     method;   ///< HttpMethod to match.
+    const char* path;     ///< Exact path to match, without the query (PROGMEM).
+    const char* content;  ///< Precompiled response (PROGMEM), or nullptr to call handler.
+    HttpHandler handler;  ///< Called when content is nullptr.
+};
+
+/**
+ * @brief A request being answered by a dynamic route handler.
+ * @details The request body (up to Content-Length) is read straight from the chip
+ * with read(). The response is written with the Print methods after begin(); the
+ * bytes are staged in the socket's TX buffer and leave in one SEND once the
+ * handler returns, so a dynamic response must fit the free TX space (2 KB on an
+ * idle socket). Bytes beyond that are dropped and overflowed() turns true.
+ */
+class HttpExchange : public Print {
+public:
+    HttpMethod method() const { return _method; }
+
+    /**
+     * @brief Returns the request path without the query, e.g. "/config".
+     */
+    const char* path() const { return _path; }
+
+    /**
+     * @brief Returns the query after '?', or "" if there is none.
+     */
+    const char* query() const { return _query; }
+
+    /**
+     * @brief Copies the (undecoded) value of a query parameter into value.
+     * @return false if the parameter is not present.
+     */
+    bool queryValue(const char* name, char* value, uint8_t size) const;
+
+    /**
+     * @brief Returns the request's Content-Length (0 if none was sent).
+     */
+    uint16_t contentLength() const { return _contentLength; }
+
+    /**
+     * @brief Reads up to len bytes of the request body from the chip.
+     */
+    int read(uint8_t* buf, uint16_t len);
+
+    /**
+     * @brief Writes the status line and headers. Writing without begin() sends 200 text/plain.
+     * @param contentType The Content-Type value, or nullptr to leave the header out.
+     */
+    void begin(uint16_t code, const char* contentType = "text/plain");
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buf, size_t size) override;
+    using Print::write;
+
+    bool overflowed() const { return _overflow; }
+
+private:
+    friend class HttpServer;
+
+    HttpExchange(NetSocket& socket, HttpMethod method, const char* path, const char* query, uint16_t contentLength);
+
+    NetSocket&  _socket;
+    HttpMethod  _method;
+    const char* _path;
+    const char* _query;
+    uint16_t    _contentLength;
+    uint16_t    _bodyRemaining;
+
+    uint8_t     _stage[32];    ///< Collects small writes into one writeAt() burst.
+    uint8_t     _stageLength;
+    uint16_t    _offset;       ///< Bytes written past the TX write pointer so far.
+    uint16_t    _limit;        ///< Free TX space when the handler started.
+    bool        _begun;
+    bool        _overflow;
+
+    void flushStage();
+    uint16_t finish();
+};
+
+/**
+ * @brief A non-blocking HTTP/1.1 server run by SimpleNetManager::loop().
+ * @details Up to SIMPLE_NET_HTTP_SERVER_CLIENTS hardware sockets listen on the port
+ * while the manager is connected; they are opened on networkUp() and closed on
+ * networkDown(). Each tick the connections are served in turn, starting with a
+ * different one each time, and each gets at most SIMPLE_NET_HTTP_SERVER_CHUNK bytes
+ * of parsing or sending, so a slow or stalled client never holds up loop().
+ * Requests are parsed in place from the chip's RX buffer, a byte stream at a time
+ * across ticks; only the path and query are kept in SRAM. Every response is sent
+ * with "Connection: close".
+ */
+class HttpServer : public NetService {
+public:
+    explicit HttpServer(SimpleNetManagerBase& manager);
+
+    /**
+     * @brief Starts serving routes (a PROGMEM table) on port.
+     */
+    void begin(uint16_t port, const HttpRoute* routes, uint8_t count);
+    template <uint8_t N>
+    void begin(uint16_t port, const HttpRoute (&routes)[N]) { begin(port, routes, N); }
+
+    /**
+     * @brief Closes every connection and stops listening.
+     */
+    void end();
+
+    /**
+     * @brief Sets how long a client may take without progress before it is dropped (default 5,000 ms).
+     */
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+
+    bool isRunning() const { return _running; }
+
+    /**
+     * @brief Returns the number of connections with a request in progress.
+     */
+    uint8_t activeClients() const;
+
+protected:
+    void poll() override;
+    void networkUp() override;
+    void networkDown() override;
+    unsigned long wakeDelay() override;
+
+private:
+    enum ConnState { CONN_IDLE, CONN_LISTEN, CONN_METHOD, CONN_TARGET, CONN_VERSION, CONN_HEADERS, CONN_BODY, CONN_SENDING, CONN_CLOSING };
+
+    struct Connection {
+        NetSocket     socket;
+        ConnState     state;
+        HttpMethod    method;
+        char          target[SIMPLE_NET_HTTP_SERVER_TARGET];
+        uint8_t       targetLength;
+        uint8_t       column;         ///< Position in the current header line (saturates).
+        bool          matching;       ///< The current header line is Content-Length so far.
+        bool          tooLong;        ///< The target did not fit the buffer.
+        bool          lengthSeen;     ///< A Content-Length header has been read.
+        uint32_t      contentLength;
+        const char*   content;        ///< PROGMEM response being sent.
+        uint16_t      contentRemaining;
+        unsigned long lastProgress;
+    };
+
+    SimpleNetManagerBase& _manager;
+    Connection       _connections[SIMPLE_NET_HTTP_SERVER_CLIENTS];
+    const HttpRoute* _routes;
+    uint8_t          _routeCount;
+    uint16_t         _port;
+    bool             _running;
+    uint8_t          _next;           ///< Connection served first on the next tick.
+    unsigned long    _timeout;
+
+    void start();
+    void service(Connection& c, unsigned long now);
+    void listen(Connection& c, unsigned long now);
+    bool parse(Connection& c);
+    void parseByte(Connection& c, uint8_t b);
+    void headersDone(Connection& c);
+    void dispatch(Connection& c);
+    void respond(Connection& c, const char* content);
+    bool sendContent(Connection& c);
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_SERVER_H
@@ -0,0 +1,194 @@
+#include "SimpleNetSim.h"
+
+#if SIMPLE_NET_SIM
+
+// The simulation is the host build's Arduino clock.
+unsigned long millis() { return SimpleNet::NetSim::current()->millis(); }
+unsigned long micros() { return SimpleNet::NetSim::current()->micros(); }
+
+namespace SimpleNet {
+
+NetSim* NetSim::_current = nullptr;
+
+NetSim::NetSim()
+    : _leaseIp(192, 168, 1, 100), _leaseSubnet(255, 255, 255, 0),
+      _leaseGateway(192, 168, 1, 1), _leaseDns(192, 168, 1, 1) {
+    _micros = 0;
+    _lastRunMillis = 0;
+    _link = true;
+    _linkReturns = false;
+    _linkReturnsAt = 0;
+    _dhcpAnswering = true;
+    _dhcpResponseMs = 5;
+    _revoked = false;
+    _leaseSeconds = 3600;
+    _configureCount = 0;
+    _current = this;
+}
+
+NetSim::~NetSim() {
+    if (_current == this) _current = nullptr;
+}
+
+void NetSim::setLink(bool up) {
+    _link = up;
+    _linkReturns = false;
+}
+
+void NetSim::flapLink(unsigned long downMs) {
+    _link = false;
+    _linkReturns = true;
+    _linkReturnsAt = millis() + downMs;
+}
+
+bool NetSim::linkUp() const {
+    return _link || (_linkReturns && (long)(millis() - _linkReturnsAt) >= 0);
+}
+
+void NetSim::setDhcpServer(bool answering, unsigned long responseMs) {
+    _dhcpAnswering = answering;
+    _dhcpResponseMs = responseMs;
+}
+
+void NetSim::setLease(IPAddress ip, IPAddress subnet, IPAddress gateway, IPAddress dns, unsigned long leaseSeconds) {
+    _leaseIp = ip;
+    _leaseSubnet = subnet;
+    _leaseGateway = gateway;
+    _leaseDns = dns;
+    _leaseSeconds = leaseSeconds;
+}
+
+bool NetSim::takeRevocation() {
+    bool revoked = _revoked;
+    _revoked = false;
+    return revoked;
+}
+
+void NetSim::configure(IPAddress ip) {
+    _configureCount++;
+    _chipIp = ip;
+}
+
+NetSimDhcp::NetSimDhcp() {
+    memset(_mac, 0, sizeof(_mac));
+    _state = DHCP_IDLE;
+    _timeout = 0;
+    _attemptStart = 0;
+    _lastSend = 0;
+    _leaseStart = 0;
+    _leaseTime = 0;
+}
+
+bool NetSimDhcp::start(const byte mac[], unsigned long timeout, const DhcpLease* remembered) {
+    memcpy(_mac, mac, 6);
+    _timeout = timeout;
+    _attemptStart = millis();
+    _lastSend = _attemptStart;
+    if (remembered) {
+        _remembered = IPAddress(remembered->localIp);
+        _state = DHCP_REBOOTING;
+    } else {
+        _state = DHCP_SELECTING;
+    }
+    return true;
+}
+
+DhcpState NetSimDhcp::step() {
+    unsigned long now = millis();
+    switch (_state) {
+        case DHCP_SELECTING:
+            if (answered(now)) {
+                _state = DHCP_REQUESTING;
+                _lastSend = now;
+            }
+            break;
+
+        case DHCP_REQUESTING:
+            if (answered(now)) bind(now);
+            break;
+
+        case DHCP_REBOOTING:
+            if (answered(now)) {
+                // ACK for the remembered address, or NAK and a full DISCOVER.
+                if (_remembered == NetSim::current()->leaseIp()) {
+                    bind(now);
+                } else {
+                    _state = DHCP_SELECTING;
+                    _lastSend = now;
+                }
+            }
+            break;
+
+        default:
+            return _state;
+    }
+
+    if (_state != DHCP_BOUND && now - _attemptStart >= _timeout) {
+        _state = DHCP_FAILED;
+    }
+    return _state;
+}
+
+DhcpLeaseEvent NetSimDhcp::maintain() {
+    if (_state != DHCP_BOUND && _state != DHCP_RENEWING) {
+        return DHCP_LEASE_NONE;
+    }
+
+    NetSim* sim = NetSim::current();
+    unsigned long elapsed = millis() - _leaseStart;
+    unsigned long t1 = _leaseTime * 500;
+    if (elapsed >= _leaseTime * 1000) {
+        _state = DHCP_IDLE;
+        return DHCP_LEASE_LOST;
+    }
+    if (elapsed < t1) {
+        return DHCP_LEASE_NONE;
+    }
+
+    _state = DHCP_RENEWING;
+    if (sim->linkUp() && sim->dhcpAnswering() && elapsed - t1 >= sim->dhcpResponseMs()) {
+        if (sim->takeRevocation()) {
+            _state = DHCP_IDLE;
+            return DHCP_LEASE_LOST;
+        }
+        bind(millis());
+        return DHCP_LEASE_RENEWED;
+    }
+    return DHCP_LEASE_NONE;
+}
+
+void NetSimDhcp::getLease(DhcpLease& lease) const {
+    memset(&lease, 0, sizeof(lease));
+    memcpy(lease.mac, _mac, 6);
+    for (uint8_t i = 0; i < 4; i++) {
+        lease.localIp[i] = _localIp[i];
+        lease.serverId[i] = _gatewayIp[i]; // The simulated server is the gateway.
+    }
+    lease.leaseTime = _leaseTime;
+}
+
+/**
+ * @brief Private method: true once the server's answer to the last request has arrived.
+ */
+bool NetSimDhcp::answered(unsigned long now) const {
+    NetSim* sim = NetSim::current();
+    return sim->linkUp() && sim->dhcpAnswering() && now - _lastSend >= sim->dhcpResponseMs();
+}
+
+/**
+ * @brief Private method to take the server's lease.
+ */
+void NetSimDhcp::bind(unsigned long now) {
+    NetSim* sim = NetSim::current();
+    _localIp = sim->leaseIp();
+    _subnetMask = sim->leaseSubnet();
+    _gatewayIp = sim->leaseGateway();
+    _dnsServerIp = sim->leaseDns();
+    _leaseTime = sim->leaseSeconds();
+    _leaseStart = now;
+    _state = DHCP_BOUND;
+}
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_SIM
@@ -0,0 +1,210 @@
+#ifndef SIMPLE_NET_SIM_H
+#define SIMPLE_NET_SIM_H
+
+#include <Arduino.h>
+#include "SimpleNetManager.h"
+
+#ifndef SIMPLE_NET_SIM
+#define SIMPLE_NET_SIM 0 ///< Set to 1 in a desktop build to compile the simulation and let it supply millis() and micros().
+#endif
+
+namespace SimpleNet {
+
+/**
+ * @brief A scripted network for running SimpleNetManagerT on a desktop.
+ * @details Holds a simulated clock, the PHY link and a DHCP server. Time only moves
+ * when the test calls advance(), so a run is deterministic: the same script gives the
+ * same sequence of states, callbacks and loop() counts every time. With
+ * SIMPLE_NET_SIM=1 the simulation defines the Arduino millis() and micros() from this
+ * clock, so the host's Arduino.h must declare them without defining them. One NetSim
+ * exists at a time; NetSimBackend and NetSimDhcp find it through current().
+ *
+ * The simulation covers the connection state machine: link, chip configuration and
+ * the DHCP exchange. Services that open sockets (DNS, probes, HTTP, ...) still talk
+ * to the W5100 registers; the host build in extras/test supplies a register model
+ * for them.
+ * @code
+ * NetSim sim;
+ * SimpleNetManagerT<NET_MODE_DHCP, NetNoDebug, 10, NetSimBackend> manager(mac);
+ * manager.begin();
+ * sim.runUntil(manager, NET_CONNECTED, 10000);
+ * sim.flapLink(500);
+ * unsigned long loops = sim.runUntil(manager, NET_CONNECTED, 10000); // Time to recovery.
+ * @endcode
+ */
+class NetSim {
+public:
+    NetSim();
+    ~NetSim();
+
+    static NetSim* current() { return _current; }
+
+    // --- Clock ---
+    unsigned long millis() const { return (unsigned long)(_micros / 1000); }
+    unsigned long micros() const { return (unsigned long)_micros; }
+    void advance(unsigned long ms) { _micros += (unsigned long long)ms * 1000; }
+    void advanceMicros(unsigned long us) { _micros += us; }
+
+    /**
+     * @brief Calls manager.loop() and advances the clock by stepMs until the manager
+     * reaches state or timeoutMs have passed.
+     * @return The number of loop() calls made; lastRunMillis() holds the time they took.
+     */
+    template <class Manager>
+    unsigned long runUntil(Manager& manager, NetState state, unsigned long timeoutMs, unsigned long stepMs = 1) {
+        unsigned long start = millis();
+        unsigned long loops = 0;
+        while (millis() - start < timeoutMs) {
+            loops++;
+            if (manager.loop() == state) break;
+            advance(stepMs);
+        }
+        _lastRunMillis = millis() - start;
+        return loops;
+    }
+
+    unsigned long lastRunMillis() const { return _lastRunMillis; }
+
+    // --- Link ---
+    /**
+     * @brief Plugs (true) or pulls (false) the cable now.
+     */
+    void setLink(bool up);
+
+    /**
+     * @brief Pulls the cable now and plugs it back in downMs later.
+     */
+    void flapLink(unsigned long downMs);
+
+    bool linkUp() const;
+
+    // --- DHCP server ---
+    /**
+     * @brief Sets whether the server answers, and how long each of its answers takes.
+     */
+    void setDhcpServer(bool answering, unsigned long responseMs = 5);
+
+    /**
+     * @brief Sets the lease the server hands out (default 192.168.1.100/24, one hour).
+     */
+    void setLease(IPAddress ip, IPAddress subnet, IPAddress gateway, IPAddress dns, unsigned long leaseSeconds);
+
+    /**
+     * @brief Makes the server refuse the next renewal (NAK), so the client loses its lease.
+     */
+    void revokeLease() { _revoked = true; }
+
+    bool          dhcpAnswering() const { return _dhcpAnswering; }
+    unsigned long dhcpResponseMs() const { return _dhcpResponseMs; }
+
+    /**
+     * @brief Takes the refusal set by revokeLease(), if any.
+     */
+    bool takeRevocation();
+
+    IPAddress     leaseIp() const { return _leaseIp; }
+    IPAddress     leaseSubnet() const { return _leaseSubnet; }
+    IPAddress     leaseGateway() const { return _leaseGateway; }
+    IPAddress     leaseDns() const { return _leaseDns; }
+    unsigned long leaseSeconds() const { return _leaseSeconds; }
+
+    // --- Chip ---
+    /**
+     * @brief Records a chip (re)configuration by the backend.
+     */
+    void configure(IPAddress ip);
+
+    void setAddress(IPAddress ip) { _chipIp = ip; }
+
+    /**
+     * @brief Returns how often the chip was configured (begin() and re-initializations).
+     */
+    unsigned long configureCount() const { return _configureCount; }
+
+    IPAddress chipIp() const { return _chipIp; }
+
+private:
+    static NetSim* _current;
+
+    unsigned long long _micros;
+    unsigned long      _lastRunMillis;
+
+    bool          _link;
+    bool          _linkReturns;   ///< A flapLink() is in progress.
+    unsigned long _linkReturnsAt;
+
+    bool          _dhcpAnswering;
+    unsigned long _dhcpResponseMs;
+    bool          _revoked;
+    IPAddress     _leaseIp;
+    IPAddress     _leaseSubnet;
+    IPAddress     _leaseGateway;
+    IPAddress     _leaseDns;
+    unsigned long _leaseSeconds;
+
+    unsigned long _configureCount;
+    IPAddress     _chipIp;
+};
+
+/**
+ * @brief DHCP client with the interface of DhcpClient, answered by the NetSim server.
+ * @details Each exchange takes dhcpResponseMs() per round trip: two for
+ * DISCOVER/OFFER and REQUEST/ACK, one for a matching INIT-REBOOT request. Renewal
+ * starts at half the lease time and succeeds while the server answers; a lease that
+ * is revoked, or not renewed before it expires, is reported lost.
+ */
+class NetSimDhcp {
+public:
+    NetSimDhcp();
+
+    bool start(const byte mac[], unsigned long timeout, const DhcpLease* remembered = nullptr);
+    DhcpState step();
+    DhcpLeaseEvent maintain();
+    void stop() { _state = DHCP_IDLE; }
+    void attach(NetChip&) {}
+
+    DhcpState state() const { return _state; }
+    IPAddress localIP() const { return _localIp; }
+    IPAddress subnetMask() const { return _subnetMask; }
+    IPAddress gatewayIP() const { return _gatewayIp; }
+    IPAddress dnsServerIP() const { return _dnsServerIp; }
+    unsigned long leaseTime() const { return _leaseTime; }
+    void getLease(DhcpLease& lease) const;
+
+private:
+    byte          _mac[6];
+    DhcpState     _state;
+    unsigned long _timeout;
+    unsigned long _attemptStart;
+    unsigned long _lastSend;
+    IPAddress     _remembered;
+
+    IPAddress     _localIp;
+    IPAddress     _subnetMask;
+    IPAddress     _gatewayIp;
+    IPAddress     _dnsServerIp;
+    unsigned long _leaseStart;
+    unsigned long _leaseTime;
+
+    bool answered(unsigned long now) const;
+    void bind(unsigned long now);
+};
+
+/**
+ * @brief Backend for SimpleNetManagerT that drives the current NetSim instead of a W5x00.
+ */
+class NetSimBackend {
+public:
+    typedef NetSimDhcp Dhcp;
+
+    void init(NetChip&, uint8_t) {}
+    void configure(NetChip&, byte[], IPAddress ip, IPAddress, IPAddress, IPAddress) { NetSim::current()->configure(ip); }
+    void setAddresses(NetChip&, IPAddress ip, IPAddress, IPAddress, IPAddress) { NetSim::current()->setAddress(ip); }
+    bool linkUp(NetChip&) { return NetSim::current()->linkUp(); }
+    uint32_t tuneSpi(uint32_t clock, bool, byte[]) { return clock; }
+    bool checkSpi() { return true; }
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_SIM_H
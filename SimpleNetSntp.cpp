@@ -0,0 +1,295 @@
+#include "SimpleNetSntp.h"
+
+namespace SimpleNet {
+
+static const uint16_t NTP_PORT = 123;
+static const uint8_t NTP_PACKET_SIZE = 48;
+static const uint8_t UDP_HEADER_SIZE = 8;          ///< Source IP, source port and length the chip prepends.
+static const uint8_t NTP_CLIENT_V4 = 0x23;         ///< LI 0, version 4, mode 3 (client).
+static const uint64_t NTP_UNIX_OFFSET = 2208988800ULL;
+static const long   MAX_SLEW = 1000;               ///< Largest backward correction that is held rather than stepped.
+static const long   MAX_DRIFT_PPM = 50000;
+static const unsigned long MIN_DRIFT_WINDOW = 60000; ///< Shortest interval the drift is measured over.
+
+/**
+ * @brief Converts an NTP timestamp (seconds and fraction since 1900) to Unix milliseconds.
+ * @details Seconds with the top bit clear are taken to be after the 2036 era rollover.
+ */
+static uint64_t ntpToUnixMillis(const uint8_t* timestamp) {
+    uint32_t seconds = ((uint32_t)timestamp[0] << 24) | ((uint32_t)timestamp[1] << 16) | ((uint32_t)timestamp[2] << 8) | timestamp[3];
+    uint32_t fraction = ((uint32_t)timestamp[4] << 24) | ((uint32_t)timestamp[5] << 16) | ((uint32_t)timestamp[6] << 8) | timestamp[7];
+    uint64_t total = seconds;
+    if ((seconds & 0x80000000UL) == 0) total += 0x100000000ULL;
+    return (total - NTP_UNIX_OFFSET) * 1000 + (((uint64_t)fraction * 1000) >> 32);
+}
+
+SntpClient::SntpClient(SimpleNetManagerBase& manager)
+    : NetService(manager), _manager(manager), _retry(15000, 600000, 2, 10) {
+    _socket.attach(manager.chip());
+    _state = SNTP_IDLE;
+    _host = nullptr;
+    _minInterval = 64000UL;
+    _maxInterval = 36UL * 3600000UL;
+    _interval = _minInterval;
+    _accuracy = 100;
+    _timeout = 2000;
+    _lastAttempt = 0;
+    _nextDelay = 0;
+    _sentAt = 0;
+    _cookie = 0;
+    _synced = false;
+    _refMillis = 0;
+    _refTime = 0;
+    _floor = 0;
+    _driftPpm = 0;
+    _lastError = 0;
+    _onSync = nullptr;
+}
+
+void SntpClient::setServer(IPAddress server) {
+    _server = server;
+    _host = nullptr;
+}
+
+void SntpClient::setServer(const char* host) {
+    _host = host;
+}
+
+void SntpClient::setPollInterval(unsigned long minInterval, unsigned long maxInterval) {
+    _minInterval = minInterval;
+    _maxInterval = maxInterval < minInterval ? minInterval : maxInterval;
+    _interval = _minInterval;
+}
+
+void SntpClient::syncNow() {
+    _lastAttempt = millis();
+    _nextDelay = 0;
+}
+
+/**
+ * @brief Interpolates the clock from millis(); no I/O.
+ */
+uint64_t SntpClient::nowMillis() const {
+    if (!_synced) {
+        return 0;
+    }
+
+    uint64_t time = clockAt(millis());
+    return time < _floor ? _floor : time;
+}
+
+/**
+ * @brief Private method for the drift-corrected clock value at a millis() reading.
+ */
+uint64_t SntpClient::clockAt(unsigned long ms) const {
+    unsigned long elapsed = ms - _refMillis;
+    int64_t correction = (int64_t)elapsed * _driftPpm / 1000000;
+    return _refTime + elapsed - correction;
+}
+
+/**
+ * @brief Queries on connect; a clock that is already set keeps running meanwhile.
+ */
+void SntpClient::networkUp() {
+    _retry.reset();
+    syncNow();
+}
+
+void SntpClient::networkDown() {
+    _socket.close();
+    _state = SNTP_IDLE;
+}
+
+/**
+ * @brief Starts a sync when one is due and picks up the answer. Called by SimpleNetManager::loop().
+ */
+void SntpClient::poll() {
+    if (!_manager.isConnected()) {
+        return;
+    }
+
+    unsigned long now = millis();
+    switch (_state) {
+        case SNTP_IDLE:
+            if (now - _lastAttempt >= _nextDelay) {
+                startSync(now);
+            }
+            break;
+
+        case SNTP_RESOLVING:
+            break; // onResolved() moves on.
+
+        case SNTP_WAITING:
+            receive(now);
+            if (_state == SNTP_WAITING && now - _sentAt >= _timeout) {
+                fail();
+            }
+            break;
+    }
+}
+
+unsigned long SntpClient::wakeDelay() {
+    if (!_manager.isConnected() || _state == SNTP_RESOLVING) {
+        return NET_WAKE_NEVER; // The resolver keeps the manager awake while it works.
+    }
+    if (_state == SNTP_WAITING) {
+        return 0;
+    }
+
+    unsigned long waited = millis() - _lastAttempt;
+    return waited >= _nextDelay ? 0 : _nextDelay - waited;
+}
+
+/**
+ * @brief Private method to begin a sync: resolve the server name, or send straight away.
+ */
+void SntpClient::startSync(unsigned long now) {
+    _lastAttempt = now;
+    if (!_host) {
+        sendQuery(_server);
+        return;
+    }
+
+    // A cached name is answered from inside resolve(), so the state is set first.
+    _state = SNTP_RESOLVING;
+    if (!_manager.resolve(_host, onResolved, this)) {
+        fail();
+    }
+}
+
+void SntpClient::onResolved(IPAddress ip, void* context) {
+    SntpClient* client = static_cast<SntpClient*>(context);
+    if (client->_state == SNTP_RESOLVING) {
+        client->sendQuery(ip);
+    }
+}
+
+/**
+ * @brief Private method to send one client request with a random cookie as its transmit time.
+ */
+void SntpClient::sendQuery(IPAddress server) {
+    if (server == IPAddress(0, 0, 0, 0) || !_socket.openUdp(NetSocket::ephemeralPort())) {
+        fail();
+        return;
+    }
+
+    uint8_t packet[NTP_PACKET_SIZE];
+    memset(packet, 0, sizeof(packet));
+    packet[0] = NTP_CLIENT_V4;
+    _cookie = ((uint32_t)random(0x10000) << 16) ^ (uint32_t)random(0x10000) ^ micros();
+    packet[44] = _cookie >> 24;
+    packet[45] = _cookie >> 16;
+    packet[46] = _cookie >> 8;
+    packet[47] = _cookie;
+
+    _socket.setDestination(server, NTP_PORT);
+    if (_socket.send(packet, sizeof(packet)) != sizeof(packet)) {
+        fail();
+        return;
+    }
+    _sentAt = millis();
+    _state = SNTP_WAITING;
+}
+
+/**
+ * @brief Private method to check for the server's answer without waiting.
+ * @details Datagrams that are not a reply to our request (wrong size, port, mode or
+ * cookie) are discarded. A kiss-o'-death (stratum 0) backs off to the longest interval.
+ */
+void SntpClient::receive(unsigned long now) {
+    while (_state == SNTP_WAITING) {
+        uint16_t available = _socket.rxAvailable();
+        if (available < UDP_HEADER_SIZE) {
+            return;
+        }
+
+        uint8_t header[UDP_HEADER_SIZE];
+        _socket.peekAt(0, header, sizeof(header));
+        uint16_t port = ((uint16_t)header[4] << 8) | header[5];
+        uint16_t length = ((uint16_t)header[6] << 8) | header[7];
+        if (available < UDP_HEADER_SIZE + length) {
+            return; // The chip is still copying the datagram in.
+        }
+
+        uint8_t packet[NTP_PACKET_SIZE];
+        bool valid = (port == NTP_PORT && length >= NTP_PACKET_SIZE);
+        if (valid) {
+            _socket.peekAt(UDP_HEADER_SIZE, packet, sizeof(packet));
+            uint32_t origin = ((uint32_t)packet[28] << 24) | ((uint32_t)packet[29] << 16) | ((uint32_t)packet[30] << 8) | packet[31];
+            valid = (packet[0] & 0x07) == 4 && origin == _cookie;
+        }
+        _socket.consume(UDP_HEADER_SIZE + length);
+        if (!valid) {
+            continue;
+        }
+
+        _socket.close();
+        _state = SNTP_IDLE;
+        if (packet[1] == 0) {
+            _nextDelay = _maxInterval; // Kiss-o'-death: the server asks us to go away.
+            return;
+        }
+
+        // Round trip without the server's own processing time (transmit - receive).
+        uint64_t received = ntpToUnixMillis(packet + 32);
+        uint64_t transmitted = ntpToUnixMillis(packet + 40);
+        unsigned long hold = transmitted > received ? (unsigned long)(transmitted - received) : 0;
+        unsigned long roundTrip = now - _sentAt;
+        roundTrip = roundTrip > hold ? roundTrip - hold : 0;
+
+        applySync(transmitted + roundTrip / 2, now);
+        _retry.reset();
+        _nextDelay = _interval;
+        if (_onSync) {
+            _onSync(*this);
+        }
+    }
+}
+
+/**
+ * @brief Private method to move the clock to serverTime, learn the drift and adapt the interval.
+ */
+void SntpClient::applySync(uint64_t serverTime, unsigned long now) {
+    if (_synced) {
+        uint64_t predicted = clockAt(now);
+        int64_t difference = (int64_t)serverTime - (int64_t)predicted;
+        long error = difference > 0x7FFFFFFFLL ? 0x7FFFFFFFL : difference < -0x7FFFFFFFLL ? -0x7FFFFFFFL : (long)difference;
+        _lastError = error;
+
+        long magnitude = error < 0 ? -error : error;
+        unsigned long window = now - _refMillis;
+        if (magnitude <= MAX_SLEW && window >= MIN_DRIFT_WINDOW) {
+            // Positive drift means millis() runs fast (the clock got ahead). Half of the
+            // newly seen drift is applied, which damps jitter in the round trip.
+            long measured = (long)(-(int64_t)error * 1000000 / (int64_t)window);
+            _driftPpm += measured / 2;
+            if (_driftPpm > MAX_DRIFT_PPM) _driftPpm = MAX_DRIFT_PPM;
+            if (_driftPpm < -MAX_DRIFT_PPM) _driftPpm = -MAX_DRIFT_PPM;
+        }
+
+        if ((unsigned long)magnitude <= _accuracy / 2) {
+            _interval = _interval > _maxInterval / 2 ? _maxInterval : _interval * 2;
+        } else if ((unsigned long)magnitude > _accuracy) {
+            _interval = _interval / 2 < _minInterval ? _minInterval : _interval / 2;
+        }
+
+        // A small step back is held rather than taken; a large error is stepped.
+        uint64_t shown = nowMillis();
+        _floor = (magnitude <= MAX_SLEW && shown > serverTime) ? shown : 0;
+    }
+
+    _refMillis = now;
+    _refTime = serverTime;
+    _synced = true;
+}
+
+/**
+ * @brief Private method to give up on the current query and back off.
+ */
+void SntpClient::fail() {
+    _socket.close();
+    _state = SNTP_IDLE;
+    _nextDelay = _retry.next();
+}
+
+} // namespace SimpleNet
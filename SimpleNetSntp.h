@@ -0,0 +1,152 @@
+#ifndef SIMPLE_NET_SNTP_H
+#define SIMPLE_NET_SNTP_H
+
+#include <Arduino.h>
+#include "SimpleNetManager.h"
+#include "SimpleNetSocket.h"
+#include "SimpleNetRetry.h"
+
+namespace SimpleNet {
+
+class SntpClient;
+
+/// Callback type run after each successful time sync.
+typedef void (*SntpCallback)(SntpClient& client);
+
+/**
+ * @brief An asynchronous SNTP (RFC 4330) client with a drift-corrected software clock.
+ * @details A query goes out as soon as the manager connects and the answer is
+ * picked up by a later loop() tick; nothing waits for the network. Between syncs
+ * now() interpolates from millis(), corrected by the drift measured between
+ * consecutive syncs, so reading the time costs no I/O. The poll interval adapts:
+ * it doubles after a sync that found the clock within the accuracy target and
+ * halves after one that did not, between the limits of setPollInterval().
+ *
+ * The clock is monotonic for small corrections: when a sync would move it back by
+ * up to a second, now() holds its value until real time catches up. Larger errors
+ * (the first sync, a server change) are stepped. The clock keeps running while
+ * disconnected; sinceSync() tells how stale it is. The UDP socket is only held
+ * while a query is in flight.
+ */
+class SntpClient : public NetService {
+public:
+    explicit SntpClient(SimpleNetManagerBase& manager);
+
+    /**
+     * @brief Sets the time server by address.
+     */
+    void setServer(IPAddress server);
+
+    /**
+     * @brief Sets the time server by name, resolved through the manager before each sync.
+     * The string must stay valid.
+     */
+    void setServer(const char* host);
+
+    /**
+     * @brief Sets the limits for the adaptive poll interval in milliseconds
+     * (default 64 s to 36 h). Syncs start at the minimum.
+     */
+    void setPollInterval(unsigned long minInterval, unsigned long maxInterval);
+
+    /**
+     * @brief Sets the error in milliseconds the poll interval is adapted to (default 100).
+     */
+    void setAccuracy(unsigned long accuracy) { _accuracy = accuracy; }
+
+    /**
+     * @brief Sets how long to wait for an answer (default 2,000 ms).
+     */
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+
+    /**
+     * @brief Sets the backoff after a failed query.
+     */
+    void setRetryPolicy(const RetryPolicy& policy) { _retry = policy; }
+
+    /**
+     * @brief Queries the server on the next tick instead of waiting for the interval.
+     */
+    void syncNow();
+
+    void onSync(SntpCallback callback) { _onSync = callback; }
+
+    bool isSynced() const { return _synced; }
+
+    /**
+     * @brief Returns the Unix time in seconds, or 0 before the first sync.
+     */
+    uint32_t now() const { return (uint32_t)(nowMillis() / 1000); }
+
+    /**
+     * @brief Returns the Unix time in milliseconds, or 0 before the first sync.
+     */
+    uint64_t nowMillis() const;
+
+    /**
+     * @brief Returns the milliseconds since the last successful sync.
+     */
+    unsigned long sinceSync() const { return millis() - _refMillis; }
+
+    /**
+     * @brief Returns how fast millis() runs relative to the server, in parts per million.
+     */
+    long driftPpm() const { return _driftPpm; }
+
+    /**
+     * @brief Returns the clock error found by the last sync in milliseconds (positive: the clock was behind).
+     */
+    long lastError() const { return _lastError; }
+
+    unsigned long pollInterval() const { return _interval; }
+
+protected:
+    void poll() override;
+    void networkUp() override;
+    void networkDown() override;
+    unsigned long wakeDelay() override;
+
+private:
+    enum SntpState { SNTP_IDLE, SNTP_RESOLVING, SNTP_WAITING };
+
+    SimpleNetManagerBase& _manager;
+    NetSocket      _socket;
+    SntpState      _state;
+
+    IPAddress      _server;
+    const char*    _host;
+    unsigned long  _minInterval;
+    unsigned long  _maxInterval;
+    unsigned long  _interval;     ///< Current poll interval.
+    unsigned long  _accuracy;
+    unsigned long  _timeout;
+    RetryPolicy    _retry;
+
+    unsigned long  _lastAttempt;
+    unsigned long  _nextDelay;    ///< From _lastAttempt to the next query.
+    unsigned long  _sentAt;
+    uint32_t       _cookie;       ///< Sent as our transmit time; the reply must echo it.
+
+    // The clock: Unix milliseconds _refTime at millis() _refMillis, plus the drift correction.
+    bool           _synced;
+    unsigned long  _refMillis;
+    uint64_t       _refTime;
+    uint64_t       _floor;        ///< now() does not go below this after a small backward correction.
+    long           _driftPpm;
+    long           _lastError;
+
+    SntpCallback   _onSync;
+
+    void startSync(unsigned long now);
+    void sendQuery(IPAddress server);
+    void receive(unsigned long now);
+    void applySync(uint64_t serverTime, unsigned long now);
+    void fail();
+    uint64_t clockAt(unsigned long ms) const;
+
+    static void onResolved(IPAddress ip, void* context);
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_SNTP_H
@@ -0,0 +1,296 @@
+#include "SimpleNetSocket.h"
+
+namespace SimpleNet {
+
+static const uint8_t STATUS_UNKNOWN = 0xFF; ///< Cached status after a command of ours.
+
+/**
+ * @brief Returns true for states that only change through a command of ours or a socket interrupt.
+ */
+static bool settled(uint8_t status) {
+    return status == SnSR::ESTABLISHED || status == SnSR::LISTEN || status == SnSR::INIT ||
+           status == SnSR::UDP || status == SnSR::IPRAW || status == SnSR::CLOSED;
+}
+
+NetSocket::NetSocket() {
+    _sock = MAX_SOCK_NUM;
+    _status = STATUS_UNKNOWN;
+    _protocol = SnMR::CLOSE;
+    _sendPending = false;
+    _sendFailed = false;
+    _sendMac = false;
+    _chip = &NetChip::library();
+}
+
+void NetSocket::attach(NetChip& chip) {
+    close();
+    _chip = &chip;
+}
+
+bool NetSocket::openTcp(uint16_t localPort) {
+    return open(SnMR::TCP, localPort);
+}
+
+bool NetSocket::openUdp(uint16_t localPort) {
+    return open(SnMR::UDP, localPort);
+}
+
+bool NetSocket::openRaw(uint8_t ipProtocol) {
+    return open(SnMR::IPRAW, 0, ipProtocol);
+}
+
+/**
+ * @brief Claims the first closed hardware socket and opens it in the given mode.
+ */
+bool NetSocket::open(uint8_t protocol, uint16_t localPort, uint8_t ipProtocol) {
+    close();
+
+    uint8_t expected = (protocol == SnMR::TCP) ? SnSR::INIT : (protocol == SnMR::IPRAW) ? SnSR::IPRAW : SnSR::UDP;
+    uint8_t count = _chip->maxSockets();
+
+    SPI.beginTransaction(NetSpi::settings());
+    for (uint8_t s = 0; s < count; s++) {
+        if (_chip->readSn(s, NET_SN_SR) != SnSR::CLOSED) continue;
+
+        _chip->writeSn(s, NET_SN_MR, protocol);
+        _chip->writeSn(s, NET_SN_IR, 0xFF);
+        if (protocol == SnMR::IPRAW) {
+            _chip->writeSn(s, NET_SN_PROTO, ipProtocol);
+        } else {
+            _chip->writeSn16(s, NET_SN_PORT, localPort ? localPort : ephemeralPort());
+        }
+        _chip->command(s, Sock_OPEN);
+        if (_chip->readSn(s, NET_SN_SR) == expected) {
+            _sock = s;
+            _status = expected;
+            _protocol = protocol;
+            _chip->socketOpened(s);
+            break;
+        }
+        _chip->command(s, Sock_CLOSE);
+    }
+    SPI.endTransaction();
+
+    _sendPending = false;
+    _sendFailed = false;
+    _sendMac = false;
+    return isOpen();
+}
+
+bool NetSocket::connect(IPAddress ip, uint16_t port) {
+    if (!isOpen()) return false;
+
+    uint8_t address[4] = { ip[0], ip[1], ip[2], ip[3] };
+    SPI.beginTransaction(NetSpi::settings());
+    _chip->writeSn(_sock, NET_SN_DIPR, address, 4);
+    _chip->writeSn16(_sock, NET_SN_DPORT, port);
+    _chip->command(_sock, Sock_CONNECT);
+    SPI.endTransaction();
+    _status = STATUS_UNKNOWN;
+    return true;
+}
+
+bool NetSocket::listen() {
+    if (!isOpen()) return false;
+
+    SPI.beginTransaction(NetSpi::settings());
+    _chip->command(_sock, Sock_LISTEN);
+    _status = _chip->readSn(_sock, NET_SN_SR);
+    SPI.endTransaction();
+    return _status == SnSR::LISTEN;
+}
+
+void NetSocket::disconnect() {
+    if (!isOpen()) return;
+    SPI.beginTransaction(NetSpi::settings());
+    _chip->command(_sock, Sock_DISCON);
+    SPI.endTransaction();
+    _status = STATUS_UNKNOWN;
+}
+
+void NetSocket::close() {
+    if (!isOpen()) return;
+    SPI.beginTransaction(NetSpi::settings());
+    _chip->command(_sock, Sock_CLOSE);
+    _chip->writeSn(_sock, NET_SN_IR, 0xFF);
+    _chip->socketClosed(_sock);
+    SPI.endTransaction();
+    _sock = MAX_SOCK_NUM;
+    _status = STATUS_UNKNOWN;
+    _sendPending = false;
+}
+
+/**
+ * @brief Reads the status register; with chip interrupts a settled status is
+ * answered from the last read until an event arrives.
+ */
+uint8_t NetSocket::status() {
+    if (!isOpen()) return SnSR::CLOSED;
+    if (settled(_status) && !_chip->hasFlags(_sock, NET_SN_IR_STATUS)) return _status;
+
+    _chip->clearFlags(_sock, NET_SN_IR_STATUS);
+    SPI.beginTransaction(NetSpi::settings());
+    _status = _chip->readSn(_sock, NET_SN_SR);
+    SPI.endTransaction();
+    return _status;
+}
+
+uint16_t NetSocket::txFree() {
+    if (!isOpen()) return 0;
+    SPI.beginTransaction(NetSpi::settings());
+    uint16_t free = readStable(NET_SN_TX_FSR);
+    SPI.endTransaction();
+    return free;
+}
+
+/**
+ * @brief Reads the received byte count; with chip interrupts an emptied buffer
+ * stays at 0 without a transfer until the next RECV interrupt.
+ */
+uint16_t NetSocket::rxAvailable() {
+    if (!isOpen() || !_chip->hasFlags(_sock, SnIR::RECV)) return 0;
+    SPI.beginTransaction(NetSpi::settings());
+    uint16_t available = readStable(NET_SN_RX_RSR);
+    SPI.endTransaction();
+    if (available == 0) _chip->clearFlags(_sock, SnIR::RECV);
+    return available;
+}
+
+uint16_t NetSocket::send(const uint8_t* buf, uint16_t len) {
+    if (!isOpen() || len == 0 || !sendComplete()) return 0;
+
+    SPI.beginTransaction(NetSpi::settings());
+    uint16_t free = readStable(NET_SN_TX_FSR);
+    if (len > free) len = free;
+    if (len > 0) {
+        uint16_t ptr = _chip->readSn16(_sock, NET_SN_TX_WR);
+        _chip->writeTx(_sock, ptr, buf, len);
+        _chip->writeSn16(_sock, NET_SN_TX_WR, ptr + len);
+        _chip->command(_sock, _sendMac ? Sock_SEND_MAC : Sock_SEND);
+        _sendPending = true;
+    }
+    SPI.endTransaction();
+    return len;
+}
+
+uint16_t NetSocket::recv(uint8_t* buf, uint16_t len) {
+    if (!isOpen() || len == 0 || !_chip->hasFlags(_sock, SnIR::RECV)) return 0;
+
+    SPI.beginTransaction(NetSpi::settings());
+    uint16_t available = readStable(NET_SN_RX_RSR);
+    if (len > available) len = available;
+    if (len > 0) {
+        uint16_t ptr = _chip->readSn16(_sock, NET_SN_RX_RD);
+        _chip->readRx(_sock, ptr, buf, len);
+        _chip->writeSn16(_sock, NET_SN_RX_RD, ptr + len);
+        _chip->command(_sock, Sock_RECV);
+    }
+    SPI.endTransaction();
+    if (available == 0) _chip->clearFlags(_sock, SnIR::RECV);
+    return len;
+}
+
+/**
+ * @brief Checks (and clears) SEND_OK for the last SEND without waiting for it.
+ * @details A TIMEOUT means the peer stopped answering (for UDP and IPRAW: the ARP
+ * request went unanswered), which sendFailed() reports afterwards. The chip closes a
+ * TCP socket on TIMEOUT, which the caller sees through status().
+ */
+bool NetSocket::sendComplete() {
+    if (!_sendPending) return true;
+    if (!isOpen() || !_chip->hasFlags(_sock, SnIR::SEND_OK | SnIR::TIMEOUT)) return false;
+
+    SPI.beginTransaction(NetSpi::settings());
+    uint8_t flags = _chip->takeFlags(_sock, SnIR::SEND_OK | SnIR::TIMEOUT);
+    if (flags) {
+        _sendPending = false;
+        _sendFailed = (flags & SnIR::SEND_OK) == 0;
+    }
+    SPI.endTransaction();
+    return !_sendPending;
+}
+
+void NetSocket::setDestination(IPAddress ip, uint16_t port) {
+    if (!isOpen()) return;
+
+    const uint8_t* mac = (_protocol == SnMR::UDP) ? _chip->pinnedMac(ip) : nullptr;
+    _sendMac = (mac != nullptr);
+
+    uint8_t address[4] = { ip[0], ip[1], ip[2], ip[3] };
+    SPI.beginTransaction(NetSpi::settings());
+    _chip->writeSn(_sock, NET_SN_DIPR, address, 4);
+    _chip->writeSn16(_sock, NET_SN_DPORT, port);
+    if (_sendMac) {
+        _chip->writeSn(_sock, NET_SN_DHAR, mac, 6);
+    }
+    SPI.endTransaction();
+}
+
+void NetSocket::destinationMac(uint8_t mac[6]) {
+    if (!isOpen()) return;
+
+    SPI.beginTransaction(NetSpi::settings());
+    _chip->readSn(_sock, NET_SN_DHAR, mac, 6);
+    SPI.endTransaction();
+}
+
+void NetSocket::writeAt(uint16_t offset, const uint8_t* buf, uint16_t len) {
+    if (!isOpen() || len == 0) return;
+
+    SPI.beginTransaction(NetSpi::settings());
+    _chip->writeTx(_sock, _chip->readSn16(_sock, NET_SN_TX_WR) + offset, buf, len);
+    SPI.endTransaction();
+}
+
+void NetSocket::commit(uint16_t len) {
+    if (!isOpen()) return;
+
+    SPI.beginTransaction(NetSpi::settings());
+    _chip->writeSn16(_sock, NET_SN_TX_WR, _chip->readSn16(_sock, NET_SN_TX_WR) + len);
+    _chip->command(_sock, _sendMac ? Sock_SEND_MAC : Sock_SEND);
+    SPI.endTransaction();
+    _sendPending = true;
+}
+
+void NetSocket::peekAt(uint16_t offset, uint8_t* buf, uint16_t len) {
+    if (!isOpen() || len == 0) return;
+
+    SPI.beginTransaction(NetSpi::settings());
+    _chip->readRx(_sock, _chip->readSn16(_sock, NET_SN_RX_RD) + offset, buf, len);
+    SPI.endTransaction();
+}
+
+void NetSocket::consume(uint16_t len) {
+    if (!isOpen() || len == 0) return;
+
+    SPI.beginTransaction(NetSpi::settings());
+    _chip->writeSn16(_sock, NET_SN_RX_RD, _chip->readSn16(_sock, NET_SN_RX_RD) + len);
+    _chip->command(_sock, Sock_RECV);
+    SPI.endTransaction();
+}
+
+uint8_t NetSocket::maxSockets() {
+    return NetChip::library().maxSockets();
+}
+
+/**
+ * @brief Reads a 16-bit counter register until two reads agree (W5x00 datasheet advice).
+ */
+uint16_t NetSocket::readStable(uint8_t reg) {
+    uint16_t value = _chip->readSn16(_sock, reg);
+    uint16_t previous;
+    do {
+        previous = value;
+        value = _chip->readSn16(_sock, reg);
+    } while (value != previous);
+    return value;
+}
+
+uint16_t NetSocket::ephemeralPort() {
+    static uint16_t port = 0;
+    if (port == 0) port = 49152 + (uint16_t)(micros() & 0x3FFF);
+    if (++port < 49152) port = 49152;
+    return port;
+}
+
+} // namespace SimpleNet
@@ -0,0 +1,181 @@
+#ifndef SIMPLE_NET_SOCKET_H
+#define SIMPLE_NET_SOCKET_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <Ethernet.h>
+#include <utility/w5100.h>
+#include "SimpleNetSpi.h"
+#include "SimpleNetChip.h"
+
+namespace SimpleNet {
+
+/**
+ * @brief A hardware socket of the W5x00, driven directly through its registers.
+ * @details EthernetClient::connect() and EthernetUDP::endPacket() wait for the chip
+ * to finish. The calls here never wait: they issue a command and return, and the
+ * caller polls status() or the return value on a later loop() tick. Sockets are
+ * taken from the same pool the Ethernet library uses (any socket in SnSR::CLOSED),
+ * so both can be used side by side. A socket belongs to the library chip unless
+ * attach() gives it another NetChip.
+ */
+class NetSocket {
+public:
+    NetSocket();
+
+    /**
+     * @brief Closes the socket, so a destroyed owner does not leak a hardware socket.
+     */
+    ~NetSocket() { close(); }
+
+    /**
+     * @brief Makes the socket use chip instead of the library chip; closes it first.
+     */
+    void attach(NetChip& chip);
+    NetChip& chip() const { return *_chip; }
+
+    /**
+     * @brief Opens a TCP socket in SnSR::INIT.
+     * @param localPort Local port, or 0 to pick an ephemeral one.
+     * @return false if all hardware sockets are taken.
+     */
+    bool openTcp(uint16_t localPort = 0);
+
+    /**
+     * @brief Opens a UDP socket bound to localPort.
+     */
+    bool openUdp(uint16_t localPort);
+
+    /**
+     * @brief Opens an IP raw socket for the given IP protocol (e.g. IPPROTO::ICMP).
+     * @details Received packets are preceded by a 6-byte header: source IP and length.
+     */
+    bool openRaw(uint8_t ipProtocol);
+
+    /**
+     * @brief Issues a TCP CONNECT and returns immediately.
+     * @details Poll status() until SnSR::ESTABLISHED, or SnSR::CLOSED on failure.
+     */
+    bool connect(IPAddress ip, uint16_t port);
+
+    /**
+     * @brief Puts a socket opened with openTcp(localPort) into SnSR::LISTEN.
+     * @details The chip completes the handshake by itself; poll status() until
+     * SnSR::ESTABLISHED. Several sockets can listen on the same port.
+     */
+    bool listen();
+
+    /**
+     * @brief Gracefully closes a TCP connection (FIN).
+     */
+    void disconnect();
+
+    /**
+     * @brief Closes the socket immediately and returns it to the pool.
+     */
+    void close();
+
+    bool    isOpen() const { return _sock < MAX_SOCK_NUM; }
+    uint8_t number() const { return _sock; }
+
+    /**
+     * @brief Returns the socket status register (SnSR::*).
+     */
+    uint8_t status();
+
+    /**
+     * @brief Returns the free space in the chip's TX buffer for this socket.
+     */
+    uint16_t txFree();
+
+    /**
+     * @brief Returns the number of received bytes waiting in the chip's RX buffer.
+     */
+    uint16_t rxAvailable();
+
+    /**
+     * @brief Queues up to len bytes and issues one SEND command.
+     * @details Returns 0 without copying while the previous SEND is unacknowledged
+     * or the TX buffer is full. Never waits.
+     * @return The number of bytes queued.
+     */
+    uint16_t send(const uint8_t* buf, uint16_t len);
+
+    /**
+     * @brief Copies up to len received bytes out of the chip in one burst.
+     * @return The number of bytes copied (0 if none are waiting).
+     */
+    uint16_t recv(uint8_t* buf, uint16_t len);
+
+    /**
+     * @brief Returns true once every issued SEND has been acknowledged by the chip.
+     */
+    bool sendComplete();
+
+    /**
+     * @brief Returns true if the last SEND completed with TIMEOUT instead of SEND_OK.
+     */
+    bool sendFailed() const { return _sendFailed; }
+
+    /**
+     * @brief Sets where the next UDP datagram goes. Only meaningful for UDP sockets.
+     * @details When a gateway MAC is pinned (see NetChip::pinGateway()) and the datagram is
+     * routed through the gateway, it is sent to that MAC without an ARP exchange.
+     */
+    void setDestination(IPAddress ip, uint16_t port);
+
+    /**
+     * @brief Copies the peer's MAC address the chip resolved for the last SEND or CONNECT.
+     */
+    void destinationMac(uint8_t mac[6]);
+
+    /**
+     * @brief Copies len bytes into the TX buffer, offset bytes past the write pointer.
+     * @details Nothing is sent and the write pointer does not move, so a packet can be
+     * filled in any order. The caller keeps offset + len within txFree().
+     */
+    void writeAt(uint16_t offset, const uint8_t* buf, uint16_t len);
+
+    /**
+     * @brief Moves the write pointer past len bytes written with writeAt() and issues one SEND.
+     */
+    void commit(uint16_t len);
+
+    /**
+     * @brief Copies len bytes from the RX buffer, offset bytes past the read pointer.
+     * @details Nothing is consumed. The caller keeps offset + len within rxAvailable().
+     */
+    void peekAt(uint16_t offset, uint8_t* buf, uint16_t len);
+
+    /**
+     * @brief Frees len bytes at the read pointer for new data (RECV).
+     */
+    void consume(uint16_t len);
+
+    /**
+     * @brief Returns the number of sockets the library chip provides.
+     */
+    static uint8_t maxSockets();
+
+    /**
+     * @brief Returns the next local port from the dynamic range (49152-65535).
+     */
+    static uint16_t ephemeralPort();
+
+private:
+    uint8_t _sock;
+    uint8_t _status;      ///< Last status read; see NetChip::enableInterrupts().
+    uint8_t _protocol;
+    bool    _sendPending;
+    bool    _sendFailed;
+    bool    _sendMac;     ///< The destination is the pinned gateway; SEND skips ARP.
+    NetChip* _chip;
+
+    bool open(uint8_t protocol, uint16_t localPort, uint8_t ipProtocol = 0);
+
+    uint16_t readStable(uint8_t reg);
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_SOCKET_H
@@ -0,0 +1,82 @@
+#include "SimpleNetSpi.h"
+#include <Ethernet.h>
+#include <utility/w5100.h>
+
+namespace SimpleNet {
+
+// Steps tried by probe(), from the default up. The MCU rounds each down to a clock it can make.
+static const uint32_t CLOCK_STEPS[] = { SIMPLE_NET_SPI_DEFAULT_CLOCK, 20000000, 28000000, 40000000, 56000000, 80000000 };
+static const uint8_t STEP_COUNT = sizeof(CLOCK_STEPS) / sizeof(CLOCK_STEPS[0]);
+
+static const uint8_t W5200_VERSION = 0x03;
+static const uint8_t W5500_VERSION = 0x04;
+
+SPISettings   NetSpi::_settings(SIMPLE_NET_SPI_DEFAULT_CLOCK, MSBFIRST, SPI_MODE0);
+uint32_t      NetSpi::_clock = SIMPLE_NET_SPI_DEFAULT_CLOCK;
+uint8_t       NetSpi::_mac[6];
+unsigned long NetSpi::_fallbacks = 0;
+
+uint32_t NetSpi::probe(uint32_t maxClock, const uint8_t mac[6]) {
+    memcpy(_mac, mac, 6);
+    use(SIMPLE_NET_SPI_DEFAULT_CLOCK);
+
+    for (uint8_t i = 1; i < STEP_COUNT && CLOCK_STEPS[i] <= maxClock; i++) {
+        if (!readsBack(CLOCK_STEPS[i], SIMPLE_NET_SPI_PROBE_READS)) {
+            break;
+        }
+        use(CLOCK_STEPS[i]);
+    }
+    return _clock;
+}
+
+uint32_t NetSpi::select(uint32_t clock, const uint8_t mac[6]) {
+    memcpy(_mac, mac, 6);
+    // Slower than the default needs no check; faster has to read back.
+    use(clock <= SIMPLE_NET_SPI_DEFAULT_CLOCK || readsBack(clock, SIMPLE_NET_SPI_PROBE_READS) ? clock : SIMPLE_NET_SPI_DEFAULT_CLOCK);
+    return _clock;
+}
+
+bool NetSpi::verify() {
+    if (_clock <= SIMPLE_NET_SPI_DEFAULT_CLOCK || readsBack(_clock, 1)) {
+        return true;
+    }
+
+    uint8_t step = STEP_COUNT - 1;
+    while (step > 0 && CLOCK_STEPS[step] >= _clock) step--;
+    use(CLOCK_STEPS[step]);
+    _fallbacks++;
+    return false;
+}
+
+/**
+ * @brief Private method: reads the version register and the MAC address `reads` times at clock.
+ * @details The version byte catches bit errors on single transfers, the 6-byte
+ * MAC address read those that only show up in bursts.
+ */
+bool NetSpi::readsBack(uint32_t clock, uint8_t reads) {
+    uint8_t chip = W5100.getChip();
+    if (chip != 52 && chip != 55) {
+        return false;
+    }
+
+    bool intact = true;
+    SPI.beginTransaction(SPISettings(clock, MSBFIRST, SPI_MODE0));
+    for (uint8_t i = 0; i < reads && intact; i++) {
+        uint8_t version = (chip == 55) ? W5100.readVERSIONR_W5500() : W5100.readVERSIONR_W5200();
+        uint8_t mac[6];
+        W5100.readSHAR(mac);
+        intact = version == (chip == 55 ? W5500_VERSION : W5200_VERSION) && memcmp(mac, _mac, 6) == 0;
+    }
+    SPI.endTransaction();
+    return intact;
+}
+
+/**
+ * @brief Private method to switch the library's transactions to clock.
+ */
+void NetSpi::use(uint32_t clock) {
+    _clock = clock;
+    _settings = SPISettings(clock, MSBFIRST, SPI_MODE0);
+}
+
+} // namespace SimpleNet
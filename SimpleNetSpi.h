@@ -0,0 +1,73 @@
+#ifndef SIMPLE_NET_SPI_H
+#define SIMPLE_NET_SPI_H
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#ifndef SIMPLE_NET_SPI_DEFAULT_CLOCK
+#define SIMPLE_NET_SPI_DEFAULT_CLOCK 14000000 ///< The Ethernet library's own SPI clock; the floor fallbacks return to.
+#endif
+
+#ifndef SIMPLE_NET_SPI_PROBE_READS
+#define SIMPLE_NET_SPI_PROBE_READS 16 ///< Register read-backs a clock must pass during probe().
+#endif
+
+namespace SimpleNet {
+
+/**
+ * @brief The SPI clock of the library's own chip transactions, verified against the chip.
+ * @details NetSocket and NetPhy begin their transactions with settings() instead of
+ * the Ethernet library's fixed SPI_ETHERNET_SETTINGS, so a faster clock speeds up
+ * every NetSocket transfer (HTTP server, MQTT, DHCP, DNS, SNTP, UDP endpoints). Transfers
+ * made by the Ethernet library itself (EthernetClient, EthernetUDP) keep its clock.
+ *
+ * A clock is accepted only if repeated reads of the chip's version register and a
+ * burst read of its MAC address register come back intact. verify() repeats that
+ * check cheaply at run time and steps the clock down when a read-back fails. The
+ * W5100 is specified for 14 MHz and has no version register, so it always keeps
+ * the default clock.
+ */
+class NetSpi {
+public:
+    static SPISettings settings() { return _settings; }
+    static uint32_t clock() { return _clock; }
+
+    /**
+     * @brief Finds the fastest clock up to maxClock that reads back correctly.
+     * @details Starts at SIMPLE_NET_SPI_DEFAULT_CLOCK and steps up while every
+     * read-back passes. Call after the chip has been initialised with mac.
+     * @return The clock in use afterwards.
+     */
+    static uint32_t probe(uint32_t maxClock, const uint8_t mac[6]);
+
+    /**
+     * @brief Uses clock if it reads back correctly, the default clock otherwise.
+     * Clocks at or below the default are taken as they are.
+     */
+    static uint32_t select(uint32_t clock, const uint8_t mac[6]);
+
+    /**
+     * @brief Checks one read-back at the current clock; on failure steps down one
+     * level (never below the default) and returns false.
+     * @details Costs nothing while the default clock is in use.
+     */
+    static bool verify();
+
+    /**
+     * @brief Returns how often verify() had to step the clock down.
+     */
+    static unsigned long fallbackCount() { return _fallbacks; }
+
+private:
+    static SPISettings   _settings;
+    static uint32_t      _clock;
+    static uint8_t       _mac[6];     ///< The MAC address register should read back as this.
+    static unsigned long _fallbacks;
+
+    static bool readsBack(uint32_t clock, uint8_t reads);
+    static void use(uint32_t clock);
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_SPI_H
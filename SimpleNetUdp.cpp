@@ -0,0 +1,129 @@
+#include "SimpleNetUdp.h"
+
+namespace SimpleNet {
+
+// Every datagram in a W5x00 UDP RX buffer is preceded by sender IP, port and length.
+static const uint8_t UDP_HEADER_SIZE = 8;
+
+UdpEndpoint::UdpEndpoint() {
+    _port = 0;
+    _txOpen = false;
+    _txCapacity = 0;
+    _txLength = 0;
+    _rxOpen = false;
+    _rxLength = 0;
+    memset(_remoteIp, 0, sizeof(_remoteIp));
+    _remotePort = 0;
+}
+
+/**
+ * @brief Sets the destination and reserves the free TX space for the datagram.
+ */
+bool UdpEndpoint::beginPacket(IPAddress ip, uint16_t port) {
+    if (!isOpen() || !_socket.sendComplete()) {
+        return false;
+    }
+
+    _socket.setDestination(ip, port);
+    _txCapacity = _socket.txFree();
+    _txLength = 0;
+    _txOpen = true;
+    return true;
+}
+
+uint16_t UdpEndpoint::write(uint16_t offset, const uint8_t* data, uint16_t len) {
+    if (!_txOpen || offset >= _txCapacity) {
+        return 0;
+    }
+
+    if (len > _txCapacity - offset) len = _txCapacity - offset;
+    _socket.writeAt(offset, data, len);
+    if (offset + len > _txLength) _txLength = offset + len;
+    return len;
+}
+
+bool UdpEndpoint::endPacket() {
+    if (!_txOpen) {
+        return false;
+    }
+
+    _txOpen = false;
+    _socket.commit(_txLength);
+    return true;
+}
+
+/**
+ * @brief Reads the 8-byte datagram header in place; the payload stays in the chip.
+ */
+uint16_t UdpEndpoint::parsePacket() {
+    discard();
+    if (!isOpen() || _socket.rxAvailable() < UDP_HEADER_SIZE) {
+        return 0;
+    }
+
+    uint8_t header[UDP_HEADER_SIZE];
+    _socket.peekAt(0, header, UDP_HEADER_SIZE);
+    memcpy(_remoteIp, header, 4);
+    _remotePort = ((uint16_t)header[4] << 8) | header[5];
+    _rxLength = ((uint16_t)header[6] << 8) | header[7];
+    _rxOpen = true;
+
+    if (_rxLength == 0) {
+        discard();
+    }
+    return _rxLength;
+}
+
+uint16_t UdpEndpoint::read(uint16_t offset, uint8_t* buf, uint16_t len) {
+    if (!_rxOpen || offset >= _rxLength) {
+        return 0;
+    }
+
+    if (len > _rxLength - offset) len = _rxLength - offset;
+    _socket.peekAt(UDP_HEADER_SIZE + offset, buf, len);
+    return len;
+}
+
+int UdpEndpoint::peek(uint16_t offset) {
+    uint8_t value;
+    return read(offset, &value, 1) == 1 ? value : -1;
+}
+
+void UdpEndpoint::discard() {
+    if (!_rxOpen) {
+        return;
+    }
+
+    _socket.consume(UDP_HEADER_SIZE + _rxLength);
+    _rxOpen = false;
+    _rxLength = 0;
+}
+
+/**
+ * @brief Binds the hardware socket to the endpoint's port; called on entering NET_CONNECTED.
+ */
+void UdpEndpoint::open() {
+    if (_port != 0 && !isOpen()) {
+        _socket.openUdp(_port);
+    }
+}
+
+bool UdpEndpoint::open(uint16_t port) {
+    close();
+    _port = port;
+    return _socket.openUdp(port);
+}
+
+void UdpEndpoint::close() {
+    _socket.close();
+    _txOpen = false;
+    _rxOpen = false;
+    _rxLength = 0;
+}
+
+void UdpEndpoint::attach(NetChip& chip) {
+    close();
+    _socket.attach(chip);
+}
+
+} // namespace SimpleNet
@@ -0,0 +1,119 @@
+#ifndef SIMPLE_NET_UDP_H
+#define SIMPLE_NET_UDP_H
+
+#include <Arduino.h>
+#include "SimpleNetSocket.h"
+
+#ifndef SIMPLE_NET_UDP_ENDPOINTS
+#define SIMPLE_NET_UDP_ENDPOINTS 1 ///< UDP endpoints the manager can hand out with getUdp().
+#endif
+
+namespace SimpleNet {
+
+/**
+ * @brief A UDP port whose datagrams are built and read in place in the chip's buffers.
+ * @details Nothing is staged in SRAM. A datagram is written straight into the TX
+ * buffer at any offset and sent with one SEND command by endPacket(). A received
+ * datagram stays in the RX buffer; read() copies only the bytes asked for, from any
+ * offset, until the next parsePacket() or discard() frees it.
+ *
+ * Endpoints handed out by the manager (see SimpleNetManagerBase::getUdp()) are
+ * open while it is in NET_CONNECTED and closed otherwise. A module can also own
+ * one and open(port) it itself. All calls are harmless no-ops while it is closed.
+ */
+class UdpEndpoint {
+public:
+    UdpEndpoint();
+
+    bool     isOpen() const { return _socket.isOpen(); }
+    uint16_t localPort() const { return _port; }
+
+    /**
+     * @brief Binds an endpoint owned by a module, not the manager, to port.
+     * @return false if all hardware sockets are taken.
+     */
+    bool open(uint16_t port);
+
+    /**
+     * @brief Releases the hardware socket and drops any half-built or unread datagram.
+     */
+    void close();
+
+    /**
+     * @brief Moves the endpoint to another chip; closes it first.
+     */
+    void attach(NetChip& chip);
+
+    /**
+     * @brief Starts a datagram to ip:port.
+     * @return false if the socket is closed or the previous datagram is still being sent.
+     */
+    bool beginPacket(IPAddress ip, uint16_t port);
+
+    /**
+     * @brief Returns the largest datagram the current packet can hold.
+     */
+    uint16_t capacity() const { return _txCapacity; }
+
+    /**
+     * @brief Writes len bytes at offset within the current datagram.
+     * @return The number of bytes written; less than len if the datagram would not fit.
+     */
+    uint16_t write(uint16_t offset, const uint8_t* data, uint16_t len);
+
+    /**
+     * @brief Appends len bytes after the furthest byte written so far.
+     */
+    uint16_t write(const uint8_t* data, uint16_t len) { return write(_txLength, data, len); }
+
+    /**
+     * @brief Sends the datagram (up to the furthest byte written) and returns at once.
+     * @return false if no datagram was started.
+     */
+    bool endPacket();
+
+    /**
+     * @brief Discards the current datagram, if any, and looks at the next one.
+     * @return The payload length of the new datagram, or 0 if none is waiting.
+     */
+    uint16_t parsePacket();
+
+    IPAddress remoteIP() const { return IPAddress(_remoteIp); }
+    uint16_t  remotePort() const { return _remotePort; }
+    uint16_t  packetLength() const { return _rxLength; }
+
+    /**
+     * @brief Copies up to len payload bytes starting at offset into buf.
+     * @return The number of bytes copied.
+     */
+    uint16_t read(uint16_t offset, uint8_t* buf, uint16_t len);
+
+    /**
+     * @brief Returns the payload byte at offset, or -1 past the end.
+     */
+    int peek(uint16_t offset);
+
+    /**
+     * @brief Frees the current datagram's space in the RX buffer.
+     */
+    void discard();
+
+private:
+    friend class SimpleNetManagerBase;
+
+    NetSocket _socket;
+    uint16_t  _port;        ///< 0 while the endpoint is unassigned.
+    bool      _txOpen;
+    uint16_t  _txCapacity;
+    uint16_t  _txLength;
+    bool      _rxOpen;
+    uint16_t  _rxLength;
+    uint8_t   _remoteIp[4];
+    uint16_t  _remotePort;
+
+    void open();
+};
+
+} // namespace SimpleNet
+
+#endif // SIMPLE_NET_UDP_H
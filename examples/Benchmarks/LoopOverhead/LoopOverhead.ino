@@ -0,0 +1,87 @@
+#include <SPI.h>
+#include <Ethernet.h>
+#include <SimpleNetManager.h>
+
+using namespace SimpleNet;
+
+//-----------------------------------------------------
+// Benchmark: cost of one netManager.loop() call
+//-----------------------------------------------------
+// Times every loop() call with micros() and prints one CSV row per network state
+// every REPORT_INTERVAL milliseconds:
+//
+//   bench,state,calls,avg_us,max_us
+//   loop,connected,48211,18,1460
+//   loop,disconnected,51873,9,212
+//
+// Calls are counted under the state the manager was in when the call started.
+// Pull the cable while it runs to get rows for both states. All serial output
+// happens outside the timed section; no debug stream is given to the manager.
+
+// Set to 1 to benchmark a static configuration instead of DHCP.
+#define USE_STATIC_IP 0
+
+byte mac[] = { 0xDE, 0xAD, 0xBE, 0xEF, 0xFE, 0xED };
+
+SimpleNetManager netManager(mac);
+
+const unsigned long REPORT_INTERVAL = 5000;
+
+struct LoopTiming {
+  unsigned long calls;
+  unsigned long totalMicros;
+  unsigned long maxMicros;
+};
+
+LoopTiming connectedTiming;
+LoopTiming disconnectedTiming;
+unsigned long lastReport = 0;
+
+void printRow(const char* state, LoopTiming& timing) {
+  if (timing.calls == 0) {
+    return;
+  }
+
+  Serial.print(F("loop,"));
+  Serial.print(state);
+  Serial.print(',');
+  Serial.print(timing.calls);
+  Serial.print(',');
+  Serial.print(timing.totalMicros / timing.calls);
+  Serial.print(',');
+  Serial.println(timing.maxMicros);
+  memset(&timing, 0, sizeof(timing));
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) { ; }
+
+#if USE_STATIC_IP
+  netManager.begin(IPAddress(192, 168, 1, 177), IPAddress(192, 168, 1, 1),
+                   IPAddress(192, 168, 1, 1), IPAddress(255, 255, 255, 0));
+#else
+  netManager.begin();
+#endif
+
+  Serial.println(F("bench,state,calls,avg_us,max_us"));
+  lastReport = millis();
+}
+
+void loop() {
+  LoopTiming& timing = netManager.isConnected() ? connectedTiming : disconnectedTiming;
+
+  unsigned long start = micros();
+  netManager.loop();
+  unsigned long elapsed = micros() - start;
+
+  timing.calls++;
+  timing.totalMicros += elapsed;
+  if (elapsed > timing.maxMicros) timing.maxMicros = elapsed;
+
+  if (millis() - lastReport >= REPORT_INTERVAL) {
+    printRow("connected", connectedTiming);
+    printRow("disconnected", disconnectedTiming);
+    lastReport = millis();
+  }
+}
@@ -0,0 +1,121 @@
+#include <SPI.h>
+#include <Ethernet.h>
+#include <SimpleNetManager.h>
+
+using namespace SimpleNet;
+
+//-----------------------------------------------------
+// Benchmark: sustained TCP and UDP send throughput
+//-----------------------------------------------------
+// Streams data to a sink on another machine for TEST_DURATION milliseconds per
+// protocol, alternating TCP and UDP, and prints one CSV row per run:
+//
+//   bench,proto,bytes,ms,kbps
+//   throughput,tcp,412672,10000,330
+//   throughput,udp,598016,10000,478
+//
+// Start the sinks first, for example with netcat:
+//
+//   nc -lk 5001 > /dev/null      (TCP)
+//   nc -lku 5002 > /dev/null     (UDP)
+//
+// TCP goes through netManager.getClient(); UDP through a zero-copy endpoint from
+// netManager.getUdp(). UDP bytes are counted as sent; compare with the sink to
+// see how many arrived. netManager.loop() keeps running between writes, so the
+// figures include the manager's own overhead.
+
+byte mac[] = { 0xDE, 0xAD, 0xBE, 0xEF, 0xFE, 0xED };
+
+SimpleNetManager netManager(mac);
+
+IPAddress sinkIp(192, 168, 1, 10);
+const uint16_t TCP_SINK_PORT = 5001;
+const uint16_t UDP_SINK_PORT = 5002;
+const uint16_t UDP_LOCAL_PORT = 5002;
+
+const unsigned long TEST_DURATION = 10000;
+const uint16_t TCP_CHUNK = 512;
+const uint16_t UDP_PAYLOAD = 1024;
+
+uint8_t chunk[TCP_CHUNK];
+
+void printRow(const char* proto, unsigned long bytes, unsigned long ms) {
+  Serial.print(F("throughput,"));
+  Serial.print(proto);
+  Serial.print(',');
+  Serial.print(bytes);
+  Serial.print(',');
+  Serial.print(ms);
+  Serial.print(',');
+  Serial.println(ms > 0 ? (unsigned long)((unsigned long long)bytes * 8 / ms) : 0);
+}
+
+void runTcp() {
+  EthernetClient& client = netManager.getClient();
+  if (!client.connect(sinkIp, TCP_SINK_PORT)) {
+    Serial.println(F("# tcp sink not reachable"));
+    return;
+  }
+
+  unsigned long bytes = 0;
+  unsigned long start = millis();
+  while (millis() - start < TEST_DURATION && client.connected() && netManager.isConnected()) {
+    bytes += client.write(chunk, sizeof(chunk));
+    netManager.loop();
+  }
+  unsigned long elapsed = millis() - start;
+  client.stop();
+
+  printRow("tcp", bytes, elapsed);
+}
+
+void runUdp() {
+  UdpEndpoint* udp = netManager.getUdp(UDP_LOCAL_PORT);
+  if (!udp) {
+    Serial.println(F("# no free UDP endpoint"));
+    return;
+  }
+
+  unsigned long bytes = 0;
+  unsigned long start = millis();
+  while (millis() - start < TEST_DURATION && netManager.isConnected()) {
+    // beginPacket() fails while the previous datagram is still going out.
+    if (udp->beginPacket(sinkIp, UDP_SINK_PORT)) {
+      uint16_t length = 0;
+      while (length < UDP_PAYLOAD) {
+        uint16_t part = UDP_PAYLOAD - length;
+        if (part > sizeof(chunk)) part = sizeof(chunk);
+        uint16_t written = udp->write(chunk, part);
+        if (written == 0) break; // TX buffer smaller than UDP_PAYLOAD.
+        length += written;
+      }
+      udp->endPacket();
+      bytes += length;
+    }
+    netManager.loop();
+  }
+
+  printRow("udp", bytes, millis() - start);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) { ; }
+
+  for (uint16_t i = 0; i < sizeof(chunk); i++) {
+    chunk[i] = (uint8_t)i;
+  }
+
+  netManager.begin();
+  Serial.println(F("bench,proto,bytes,ms,kbps"));
+}
+
+void loop() {
+  netManager.loop();
+  if (!netManager.isConnected()) {
+    return;
+  }
+
+  runTcp();
+  runUdp();
+}
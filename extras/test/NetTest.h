@@ -0,0 +1,47 @@
+// Minimal checks for the host tests: each failed check prints its location and the
+// test's exit code becomes non-zero, which is all ctest looks at.
+#ifndef SIMPLE_NET_TEST_H
+#define SIMPLE_NET_TEST_H
+
+#include <stdio.h>
+#include <string.h>
+
+static int netTestFailures = 0;
+
+#define NET_CHECK(cond)                                                       \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);   \
+            netTestFailures++;                                                \
+        }                                                                     \
+    } while (0)
+
+#define NET_CHECK_EQ(actual, expected)                                        \
+    do {                                                                      \
+        long long netActual = (long long)(actual);                            \
+        long long netExpected = (long long)(expected);                        \
+        if (netActual != netExpected) {                                       \
+            printf("%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__,  \
+                   #actual, netActual, netExpected);                          \
+            netTestFailures++;                                                \
+        }                                                                     \
+    } while (0)
+
+#define NET_CHECK_STR_EQ(actual, expected)                                    \
+    do {                                                                      \
+        const char* netActual = (actual);                                     \
+        const char* netExpected = (expected);                                 \
+        if (strcmp(netActual, netExpected) != 0) {                            \
+            printf("%s:%d: %s is \"%s\", expected \"%s\"\n", __FILE__,        \
+                   __LINE__, #actual, netActual, netExpected);                \
+            netTestFailures++;                                                \
+        }                                                                     \
+    } while (0)
+
+/// Returns the exit code for main(): 0 when every check passed.
+static inline int netTestResult() {
+    if (netTestFailures == 0) printf("OK\n");
+    return netTestFailures == 0 ? 0 : 1;
+}
+
+#endif // SIMPLE_NET_TEST_H
@@ -0,0 +1,200 @@
+// Host stand-in for the Arduino core: only what the library and its tests use.
+// millis() and micros() are declared here and defined by NetSim (SIMPLE_NET_SIM=1).
+#ifndef SIMPLE_NET_STUB_ARDUINO_H
+#define SIMPLE_NET_STUB_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+unsigned long millis();
+unsigned long micros();
+inline void delay(unsigned long) {}
+inline void delayMicroseconds(unsigned int) {}
+inline void yield() {}
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+#define LOW          0x0
+#define HIGH         0x1
+#define CHANGE       1
+#define FALLING      2
+#define RISING       3
+
+// Pins hold a level; a test changes it with hostSetPin(), which runs an attached
+// interrupt handler whose edge matches. Pins from HOST_PIN_COUNT on have no interrupt.
+static const uint8_t HOST_PIN_COUNT = 64;
+#define NOT_AN_INTERRUPT -1
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int  digitalRead(uint8_t pin);
+inline int digitalPinToInterrupt(uint8_t pin) { return pin < HOST_PIN_COUNT ? pin : NOT_AN_INTERRUPT; }
+void attachInterrupt(uint8_t interrupt, void (*handler)(), int mode);
+void detachInterrupt(uint8_t interrupt);
+inline void noInterrupts() {}
+inline void interrupts() {}
+void hostSetPin(uint8_t pin, int level);
+
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+inline uint8_t     pgm_read_byte(const void* p) { return *(const uint8_t*)p; }
+inline uint16_t    pgm_read_word(const void* p) { return *(const uint16_t*)p; }
+inline const void* pgm_read_ptr(const void* p) { return *(const void* const*)p; }
+#define memcpy_P  memcpy
+#define strlen_P  strlen
+#define strncmp_P strncmp
+#define strcmp_P  strcmp
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+class Printable;
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size--) n += write(*buffer++);
+        return n;
+    }
+    size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+    size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+    virtual int  availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    int  getWriteError() { return _writeError; }
+    void clearWriteError() { setWriteError(0); }
+
+    size_t print(const __FlashStringHelper* s) { return write((const char*)s); }
+    size_t print(const char* s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char n, int base = 10) { return print((unsigned long)n, base); }
+    size_t print(int n, int base = 10) { return print((long)n, base); }
+    size_t print(unsigned int n, int base = 10) { return print((unsigned long)n, base); }
+    size_t print(long n, int base = 10) { return base == 10 ? printNumber("%ld", n) : print((unsigned long)n, base); }
+    size_t print(unsigned long n, int base = 10) { return printNumber(base == 16 ? "%lX" : "%lu", n); }
+    size_t print(double n, int digits = 2) {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.*f", digits, n);
+        return write(buffer);
+    }
+    size_t print(const Printable& x);
+
+    size_t println() { return write("\r\n"); }
+    template <typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+    template <typename T> size_t println(T value, int base) { size_t n = print(value, base); return n + println(); }
+
+protected:
+    void setWriteError(int error = 1) { _writeError = error; }
+
+private:
+    int _writeError = 0;
+
+    size_t printNumber(const char* format, unsigned long n) {
+        char buffer[24];
+        snprintf(buffer, sizeof(buffer), format, n);
+        return write(buffer);
+    }
+    size_t printNumber(const char* format, long n) {
+        char buffer[24];
+        snprintf(buffer, sizeof(buffer), format, n);
+        return write(buffer);
+    }
+};
+
+class Printable {
+public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print& p) const = 0;
+};
+
+inline size_t Print::print(const Printable& x) { return x.printTo(*this); }
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    void setTimeout(unsigned long) {}
+};
+
+class IPAddress : public Printable {
+public:
+    IPAddress() { _address.dword = 0; }
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+        _address.bytes[0] = a;
+        _address.bytes[1] = b;
+        _address.bytes[2] = c;
+        _address.bytes[3] = d;
+    }
+    IPAddress(uint32_t address) { _address.dword = address; }
+    IPAddress(const uint8_t* address) { memcpy(_address.bytes, address, 4); }
+
+    bool fromString(const char* address) {
+        unsigned int part[4];
+        char extra;
+        if (sscanf(address, "%u.%u.%u.%u%c", &part[0], &part[1], &part[2], &part[3], &extra) != 4) return false;
+        for (uint8_t i = 0; i < 4; i++) {
+            if (part[i] > 255) return false;
+            _address.bytes[i] = (uint8_t)part[i];
+        }
+        return true;
+    }
+
+    operator uint32_t() const { return _address.dword; }
+    bool operator==(const IPAddress& other) const { return _address.dword == other._address.dword; }
+    bool operator!=(const IPAddress& other) const { return !(*this == other); }
+    bool operator==(const uint8_t* address) const { return memcmp(address, _address.bytes, 4) == 0; }
+    uint8_t  operator[](int index) const { return _address.bytes[index]; }
+    uint8_t& operator[](int index) { return _address.bytes[index]; }
+    IPAddress& operator=(const uint8_t* address) { memcpy(_address.bytes, address, 4); return *this; }
+    IPAddress& operator=(uint32_t address) { _address.dword = address; return *this; }
+
+    size_t printTo(Print& p) const override {
+        size_t n = 0;
+        for (uint8_t i = 0; i < 4; i++) {
+            if (i) n += p.print('.');
+            n += p.print(_address.bytes[i], 10);
+        }
+        return n;
+    }
+
+    uint8_t* raw_address() { return _address.bytes; }
+
+private:
+    union {
+        uint8_t  bytes[4];
+        uint32_t dword;
+    } _address;
+};
+
+const IPAddress INADDR_NONE(0, 0, 0, 0);
+
+class HardwareSerial : public Stream {
+public:
+    void   begin(unsigned long) {}
+    size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+    using Print::write;
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    int availableForWrite() override { return 64; }
+    operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif // SIMPLE_NET_STUB_ARDUINO_H
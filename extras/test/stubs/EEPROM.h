@@ -0,0 +1,22 @@
+// Host stand-in for the EEPROM library: 1 KB of RAM, erased to 0xFF, with a count of
+// the cells written.
+#ifndef SIMPLE_NET_STUB_EEPROM_H
+#define SIMPLE_NET_STUB_EEPROM_H
+
+#include "Arduino.h"
+
+struct EEPROMClass {
+    EEPROMClass() : writes(0) { memset(mem, 0xFF, sizeof(mem)); }
+
+    uint8_t  read(int address) { return mem[address]; }
+    void     write(int address, uint8_t value) { mem[address] = value; writes++; }
+    void     update(int address, uint8_t value) { if (mem[address] != value) write(address, value); }
+    uint16_t length() { return sizeof(mem); }
+
+    uint8_t       mem[1024];
+    unsigned long writes;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif // SIMPLE_NET_STUB_EEPROM_H
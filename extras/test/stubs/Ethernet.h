@@ -0,0 +1,119 @@
+// Host stand-in for the Ethernet library. The manager reaches the network through
+// NetSimBackend, and the library's own sockets through the W5100 register model, so
+// these classes only have to compile and answer plausibly.
+#ifndef SIMPLE_NET_STUB_ETHERNET_H
+#define SIMPLE_NET_STUB_ETHERNET_H
+
+#include "Arduino.h"
+#include "Client.h"
+#include "Server.h"
+#include "Udp.h"
+
+#ifndef MAX_SOCK_NUM
+#define MAX_SOCK_NUM 8
+#endif
+
+enum EthernetLinkStatus { Unknown, LinkON, LinkOFF };
+enum EthernetHardwareStatus { EthernetNoHardware, EthernetW5100, EthernetW5200, EthernetW5500 };
+
+class EthernetClass {
+public:
+    int  begin(uint8_t*, unsigned long = 60000, unsigned long = 4000) { return 1; }
+    void begin(uint8_t*, IPAddress) {}
+    void begin(uint8_t*, IPAddress, IPAddress) {}
+    void begin(uint8_t*, IPAddress, IPAddress, IPAddress) {}
+    void begin(uint8_t*, IPAddress, IPAddress, IPAddress, IPAddress) {}
+    static void init(uint8_t = 10) {}
+    int  maintain() { return 0; }
+
+    EthernetLinkStatus     linkStatus() { return LinkON; }
+    EthernetHardwareStatus hardwareStatus() { return EthernetW5500; }
+
+    void      MACAddress(uint8_t*) {}
+    IPAddress localIP() { return IPAddress(); }
+    IPAddress subnetMask() { return IPAddress(); }
+    IPAddress gatewayIP() { return IPAddress(); }
+    IPAddress dnsServerIP() { return IPAddress(); }
+    void setMACAddress(const uint8_t*) {}
+    void setLocalIP(const IPAddress) {}
+    void setSubnetMask(const IPAddress) {}
+    void setGatewayIP(const IPAddress) {}
+    void setDnsServerIP(const IPAddress) {}
+    void setRetransmissionTimeout(uint16_t) {}
+    void setRetransmissionCount(uint8_t) {}
+};
+
+extern EthernetClass Ethernet;
+
+class EthernetUDP : public UDP {
+public:
+    uint8_t begin(uint16_t) override { return 1; }
+    uint8_t beginMulticast(IPAddress, uint16_t) { return 1; }
+    void    stop() override {}
+    int     beginPacket(IPAddress, uint16_t) override { return 1; }
+    int     beginPacket(const char*, uint16_t) override { return 1; }
+    int     endPacket() override { return 1; }
+    size_t  write(uint8_t) override { return 1; }
+    size_t  write(const uint8_t*, size_t size) override { return size; }
+    using Print::write;
+    int       parsePacket() override { return 0; }
+    int       available() override { return 0; }
+    int       read() override { return -1; }
+    int       read(unsigned char*, size_t) override { return 0; }
+    int       read(char*, size_t) override { return 0; }
+    int       peek() override { return -1; }
+    void      flush() override {}
+    IPAddress remoteIP() override { return IPAddress(); }
+    uint16_t  remotePort() override { return 0; }
+    uint16_t  localPort() { return 0; }
+};
+
+/**
+ * A client that connects at once and accepts every byte; tests derive from it to
+ * script short writes or a lost connection.
+ */
+class EthernetClient : public Client {
+public:
+    EthernetClient() : _connected(false) {}
+    explicit EthernetClient(uint8_t) : _connected(false) {}
+
+    uint8_t status() { return 0; }
+    int     connect(IPAddress, uint16_t) override { _connected = true; return 1; }
+    int     connect(const char*, uint16_t) override { _connected = true; return 1; }
+    int     availableForWrite() override { return 2048; }
+    size_t  write(uint8_t) override { return 1; }
+    size_t  write(const uint8_t*, size_t size) override { return size; }
+    using Print::write;
+    int     available() override { return 0; }
+    int     read() override { return -1; }
+    int     read(uint8_t*, size_t) override { return 0; }
+    int     peek() override { return -1; }
+    void    flush() override {}
+    void    stop() override { _connected = false; }
+    uint8_t connected() override { return _connected; }
+    operator bool() override { return _connected; }
+
+    uint8_t   getSocketNumber() const { return 0; }
+    uint16_t  localPort() { return 0; }
+    IPAddress remoteIP() { return IPAddress(); }
+    uint16_t  remotePort() { return 0; }
+    void      setConnectionTimeout(uint16_t) {}
+
+private:
+    bool _connected;
+};
+
+class EthernetServer : public Server {
+public:
+    explicit EthernetServer(uint16_t) {}
+
+    EthernetClient available() { return EthernetClient(); }
+    EthernetClient accept() { return EthernetClient(); }
+    void   begin() override {}
+    size_t write(uint8_t) override { return 1; }
+    size_t write(const uint8_t*, size_t size) override { return size; }
+    using Print::write;
+    operator bool() { return true; }
+};
+
+#endif // SIMPLE_NET_STUB_ETHERNET_H
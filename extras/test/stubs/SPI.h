@@ -0,0 +1,33 @@
+// Host stand-in for the SPI library. Transfers echo the byte sent; chip traffic of
+// the library chip goes through the W5100 register model instead (utility/w5100.h).
+#ifndef SIMPLE_NET_STUB_SPI_H
+#define SIMPLE_NET_STUB_SPI_H
+
+#include "Arduino.h"
+
+#define MSBFIRST  1
+#define SPI_MODE0 0
+
+class SPISettings {
+public:
+    SPISettings(uint32_t clock = 4000000, uint8_t bitOrder = MSBFIRST, uint8_t dataMode = SPI_MODE0)
+        : clock(clock), bitOrder(bitOrder), dataMode(dataMode) {}
+
+    uint32_t clock;
+    uint8_t  bitOrder;
+    uint8_t  dataMode;
+};
+
+class SPIClass {
+public:
+    void    begin() {}
+    void    beginTransaction(SPISettings) {}
+    void    endTransaction() {}
+    uint8_t transfer(uint8_t data) { return data; }
+    void    transfer(void*, size_t) {}
+    void    usingInterrupt(uint8_t) {}
+};
+
+extern SPIClass SPI;
+
+#endif // SIMPLE_NET_STUB_SPI_H
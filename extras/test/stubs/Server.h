@@ -0,0 +1,12 @@
+// Host stand-in for the Arduino core's Server interface.
+#ifndef SIMPLE_NET_STUB_SERVER_H
+#define SIMPLE_NET_STUB_SERVER_H
+
+#include "Arduino.h"
+
+class Server : public Print {
+public:
+    virtual void begin() = 0;
+};
+
+#endif // SIMPLE_NET_STUB_SERVER_H
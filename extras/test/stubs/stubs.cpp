@@ -0,0 +1,301 @@
+// Globals of the host stand-ins, the pin model and the W5500 register model.
+#include "Arduino.h"
+#include "SPI.h"
+#include "Ethernet.h"
+#include "EEPROM.h"
+#include "utility/w5100.h"
+
+HardwareSerial Serial;
+SPIClass       SPI;
+EthernetClass  Ethernet;
+W5100Class     W5100;
+EEPROMClass    EEPROM;
+
+// --- random() ---------------------------------------------------------------
+
+static unsigned long randomState = 1;
+
+void randomSeed(unsigned long seed) {
+    if (seed != 0) randomState = seed;
+}
+
+long random(long howbig) {
+    if (howbig <= 0) return 0;
+    randomState = randomState * 1103515245UL + 12345UL;
+    return (long)((randomState >> 8) % (unsigned long)howbig);
+}
+
+long random(long howsmall, long howbig) {
+    return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+// --- Pins -------------------------------------------------------------------
+
+static uint8_t pinLevel[HOST_PIN_COUNT];
+static bool    pinLevelSet[HOST_PIN_COUNT];
+static void  (*pinHandler[HOST_PIN_COUNT])();
+static int     pinEdge[HOST_PIN_COUNT];
+
+static uint8_t levelOf(uint8_t pin) {
+    return pinLevelSet[pin] ? pinLevel[pin] : HIGH; // An untouched input reads as pulled up.
+}
+
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+    hostSetPin(pin, level);
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < HOST_PIN_COUNT ? levelOf(pin) : LOW;
+}
+
+void attachInterrupt(uint8_t interrupt, void (*handler)(), int mode) {
+    if (interrupt >= HOST_PIN_COUNT) return;
+    pinHandler[interrupt] = handler;
+    pinEdge[interrupt] = mode;
+}
+
+void detachInterrupt(uint8_t interrupt) {
+    if (interrupt < HOST_PIN_COUNT) pinHandler[interrupt] = nullptr;
+}
+
+void hostSetPin(uint8_t pin, int level) {
+    if (pin >= HOST_PIN_COUNT) return;
+    uint8_t previous = levelOf(pin);
+    pinLevel[pin] = level ? HIGH : LOW;
+    pinLevelSet[pin] = true;
+    if (previous == pinLevel[pin] || !pinHandler[pin]) return;
+
+    bool falling = pinLevel[pin] == LOW;
+    if (pinEdge[pin] == CHANGE || (pinEdge[pin] == FALLING && falling) || (pinEdge[pin] == RISING && !falling)) {
+        pinHandler[pin]();
+    }
+}
+
+// --- W5500 register model ---------------------------------------------------
+
+// Register offsets of the W5500 as the library maps it: common block at 0x0000,
+// socket s at 0x1000 + s * 0x100.
+static const uint16_t SIR = 0x0017;
+static const uint16_t SIMR = 0x0018;
+static const uint16_t VERSIONR = 0x0039;
+static const uint16_t SOCKET_BASE = 0x1000;
+static const uint8_t  SN_MR = 0x00, SN_IR = 0x02, SN_SR = 0x03, SN_TX_FSR = 0x20, SN_TX_RD = 0x22,
+                      SN_TX_WR = 0x24, SN_RX_RSR = 0x26, SN_RX_RD = 0x28, SN_RX_WR = 0x2A, SN_IMR = 0x2C;
+static const uint8_t  SOCKETS = 8;
+
+static uint8_t       memory[0x10000];
+static uint8_t       sent[SOCKETS][W5100Class::SSIZE];
+static uint16_t      sentLength[SOCKETS];
+static unsigned long sends[SOCKETS];
+static unsigned long transferCount;
+static int           interruptPin = -1;
+
+static uint8_t* socketReg(uint8_t s, uint8_t reg) {
+    return memory + SOCKET_BASE + s * 0x100 + reg;
+}
+
+static uint16_t read16(uint8_t s, uint8_t reg) {
+    const uint8_t* p = socketReg(s, reg);
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static void write16(uint8_t s, uint8_t reg, uint16_t value) {
+    uint8_t* p = socketReg(s, reg);
+    p[0] = (uint8_t)(value >> 8);
+    p[1] = (uint8_t)value;
+}
+
+/**
+ * Recomputes what the chip derives: free TX space, SIR and the INTn line.
+ */
+static void update() {
+    uint8_t pending = 0;
+    for (uint8_t s = 0; s < SOCKETS; s++) {
+        write16(s, SN_TX_FSR, (uint16_t)(W5100Class::SSIZE - (uint16_t)(read16(s, SN_TX_WR) - read16(s, SN_TX_RD))));
+        if (*socketReg(s, SN_IR) & *socketReg(s, SN_IMR)) pending |= (uint8_t)(1 << s);
+    }
+    memory[SIR] = pending;
+    if (interruptPin >= 0) {
+        hostSetPin((uint8_t)interruptPin, (pending & memory[SIMR]) ? LOW : HIGH);
+    }
+}
+
+static uint8_t socketOf(uint16_t address, uint8_t& reg) {
+    if (address < SOCKET_BASE || address >= SOCKET_BASE + SOCKETS * 0x100) return SOCKETS;
+    reg = (uint8_t)(address & 0xFF);
+    return (uint8_t)((address - SOCKET_BASE) >> 8);
+}
+
+uint16_t W5100Class::read(uint16_t address, uint8_t* buffer, uint16_t len) {
+    transferCount++;
+    for (uint16_t i = 0; i < len; i++) buffer[i] = memory[(uint16_t)(address + i)];
+    return len;
+}
+
+uint8_t W5100Class::read(uint16_t address) {
+    uint8_t value;
+    read(address, &value, 1);
+    return value;
+}
+
+uint16_t W5100Class::write(uint16_t address, const uint8_t* buffer, uint16_t len) {
+    transferCount++;
+    for (uint16_t i = 0; i < len; i++) {
+        uint16_t at = (uint16_t)(address + i);
+        uint8_t reg = 0;
+        if (socketOf(at, reg) < SOCKETS && reg == SN_IR) {
+            memory[at] &= (uint8_t)~buffer[i]; // Written ones clear flags.
+        } else if (at != SIR && at != VERSIONR) {
+            memory[at] = buffer[i];
+        }
+    }
+    update();
+    return len;
+}
+
+uint8_t W5100Class::write(uint16_t address, uint8_t data) {
+    write(address, &data, 1);
+    return 1;
+}
+
+void W5100Class::execCmdSn(SOCKET s, SockCMD command) {
+    transferCount++;
+    if (s >= SOCKETS) return;
+
+    uint8_t& status = *socketReg(s, SN_SR);
+    uint8_t& flags = *socketReg(s, SN_IR);
+    switch (command) {
+        case Sock_OPEN:
+            switch (*socketReg(s, SN_MR) & 0x0F) {
+                case 0x01: status = SnSR::INIT; break;
+                case 0x02: status = SnSR::UDP; break;
+                case 0x03: status = SnSR::IPRAW; break;
+                case 0x04: status = SnSR::MACRAW; break;
+                default:   status = SnSR::CLOSED; break;
+            }
+            write16(s, SN_TX_RD, 0);
+            write16(s, SN_TX_WR, 0);
+            write16(s, SN_RX_RD, 0);
+            write16(s, SN_RX_WR, 0);
+            write16(s, SN_RX_RSR, 0);
+            break;
+
+        case Sock_LISTEN:
+            if (status == SnSR::INIT) status = SnSR::LISTEN;
+            break;
+
+        case Sock_CONNECT:
+            if (status == SnSR::INIT) {
+                status = SnSR::ESTABLISHED;
+                flags |= SnIR::CON;
+            }
+            break;
+
+        case Sock_DISCON:
+            if (status == SnSR::ESTABLISHED || status == SnSR::CLOSE_WAIT) {
+                status = SnSR::CLOSED;
+                flags |= SnIR::DISCON;
+            }
+            break;
+
+        case Sock_CLOSE:
+            status = SnSR::CLOSED;
+            break;
+
+        case Sock_SEND:
+        case Sock_SEND_MAC:
+        case Sock_SEND_KEEP: {
+            uint16_t from = read16(s, SN_TX_RD);
+            uint16_t length = (uint16_t)(read16(s, SN_TX_WR) - from);
+            for (uint16_t i = 0; i < length; i++) {
+                sent[s][i] = memory[SBASE(s) + ((from + i) & SMASK)];
+            }
+            sentLength[s] = length;
+            sends[s]++;
+            write16(s, SN_TX_RD, read16(s, SN_TX_WR));
+            flags |= SnIR::SEND_OK;
+            break;
+        }
+
+        case Sock_RECV:
+            write16(s, SN_RX_RSR, (uint16_t)(read16(s, SN_RX_WR) - read16(s, SN_RX_RD)));
+            break;
+    }
+    update();
+}
+
+namespace HostChip {
+
+void reset() {
+    memset(memory, 0, sizeof(memory));
+    memory[VERSIONR] = 0x04;
+    memset(sentLength, 0, sizeof(sentLength));
+    memset(sends, 0, sizeof(sends));
+    transferCount = 0;
+    update();
+}
+
+void deliver(uint8_t s, const uint8_t* data, uint16_t len) {
+    uint16_t at = read16(s, SN_RX_WR);
+    for (uint16_t i = 0; i < len; i++) {
+        memory[W5100Class::RBASE(s) + ((at + i) & W5100Class::SMASK)] = data[i];
+    }
+    write16(s, SN_RX_WR, (uint16_t)(at + len));
+    write16(s, SN_RX_RSR, (uint16_t)(read16(s, SN_RX_RSR) + len));
+    *socketReg(s, SN_IR) |= SnIR::RECV;
+    update();
+}
+
+void deliverUdp(uint8_t s, IPAddress from, uint16_t port, const uint8_t* data, uint16_t len) {
+    uint8_t header[8] = { from[0], from[1], from[2], from[3],
+                          (uint8_t)(port >> 8), (uint8_t)port, (uint8_t)(len >> 8), (uint8_t)len };
+    uint16_t at = read16(s, SN_RX_WR);
+    for (uint16_t i = 0; i < sizeof(header); i++) {
+        memory[W5100Class::RBASE(s) + ((at + i) & W5100Class::SMASK)] = header[i];
+    }
+    write16(s, SN_RX_WR, (uint16_t)(at + sizeof(header)));
+    write16(s, SN_RX_RSR, (uint16_t)(read16(s, SN_RX_RSR) + sizeof(header)));
+    deliver(s, data, len);
+}
+
+void peerConnect(uint8_t s) {
+    if (*socketReg(s, SN_SR) == SnSR::LISTEN) {
+        *socketReg(s, SN_SR) = SnSR::ESTABLISHED;
+        *socketReg(s, SN_IR) |= SnIR::CON;
+        update();
+    }
+}
+
+void peerClose(uint8_t s) {
+    if (*socketReg(s, SN_SR) == SnSR::ESTABLISHED) {
+        *socketReg(s, SN_SR) = SnSR::CLOSE_WAIT;
+        *socketReg(s, SN_IR) |= SnIR::DISCON;
+        update();
+    }
+}
+
+uint8_t status(uint8_t s) {
+    return *socketReg(s, SN_SR);
+}
+
+const uint8_t* lastSent(uint8_t s, uint16_t& len) {
+    len = sentLength[s];
+    return sent[s];
+}
+
+unsigned long sendCount(uint8_t s) {
+    return sends[s];
+}
+
+unsigned long transfers() {
+    return transferCount;
+}
+
+void wireInterrupt(uint8_t pin) {
+    interruptPin = pin;
+    update();
+}
+
+} // namespace HostChip
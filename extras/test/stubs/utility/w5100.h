@@ -0,0 +1,107 @@
+// Host stand-in for the Ethernet library's chip driver: a register model of a W5500.
+// read() and write() go to 64 KB of register and buffer memory laid out like the
+// library's W5500 mapping. execCmdSn() carries out the socket commands on it: OPEN,
+// LISTEN, CONNECT, DISCON, CLOSE, SEND and RECV update the status, pointers and
+// interrupt flags the way the chip does, so NetSocket and the services built on it
+// run unchanged. HostChip holds the test side: delivering data, reading what was
+// sent, closing from the peer and the INTn line.
+#ifndef SIMPLE_NET_STUB_W5100_H
+#define SIMPLE_NET_STUB_W5100_H
+
+#include <SPI.h>
+
+typedef uint8_t SOCKET;
+
+#define SPI_ETHERNET_SETTINGS SPISettings(14000000, MSBFIRST, SPI_MODE0)
+
+class SnMR {
+public:
+    static const uint8_t CLOSE = 0x00, TCP = 0x21, UDP = 0x02, IPRAW = 0x03, MACRAW = 0x04, PPPOE = 0x05, ND = 0x20, MULTI = 0x80;
+};
+
+enum SockCMD {
+    Sock_OPEN = 0x01, Sock_LISTEN = 0x02, Sock_CONNECT = 0x04, Sock_DISCON = 0x08, Sock_CLOSE = 0x10,
+    Sock_SEND = 0x20, Sock_SEND_MAC = 0x21, Sock_SEND_KEEP = 0x22, Sock_RECV = 0x40
+};
+
+class SnIR {
+public:
+    static const uint8_t SEND_OK = 0x10, TIMEOUT = 0x08, RECV = 0x04, DISCON = 0x02, CON = 0x01;
+};
+
+class SnSR {
+public:
+    static const uint8_t CLOSED = 0x00, INIT = 0x13, LISTEN = 0x14, SYNSENT = 0x15, SYNRECV = 0x16, ESTABLISHED = 0x17,
+                         FIN_WAIT = 0x18, CLOSING = 0x1A, TIME_WAIT = 0x1B, CLOSE_WAIT = 0x1C, LAST_ACK = 0x1D,
+                         UDP = 0x22, IPRAW = 0x32, MACRAW = 0x42, PPPOE = 0x5F;
+};
+
+class IPPROTO {
+public:
+    static const uint8_t IP = 0, ICMP = 1, IGMP = 2, GGP = 3, TCP = 6, PUP = 12, UDP = 17, IDP = 22, ND = 77, RAW = 255;
+};
+
+class W5100Class {
+public:
+    static uint8_t init() { return 1; }
+    static uint8_t getChip() { return 55; }
+    static void    setSS(uint8_t) {}
+
+    static uint16_t read(uint16_t address, uint8_t* buffer, uint16_t len);
+    static uint8_t  read(uint16_t address);
+    static uint16_t write(uint16_t address, const uint8_t* buffer, uint16_t len);
+    static uint8_t  write(uint16_t address, uint8_t data);
+    static void     execCmdSn(SOCKET s, SockCMD command);
+
+    static uint8_t  readVERSIONR_W5200() { return read(0x001F); }
+    static uint8_t  readVERSIONR_W5500() { return read(0x0039); }
+    static uint16_t readSHAR(uint8_t* buffer) { return read(0x0009, buffer, 6); }
+
+    // Socket buffers: 2 KB each, TX from 0x8000 and RX from 0xC000.
+    static uint16_t SBASE(uint8_t s) { return 0x8000 + s * SSIZE; }
+    static uint16_t RBASE(uint8_t s) { return 0xC000 + s * SSIZE; }
+    static bool     hasOffsetAddressMapping() { return false; }
+    static const uint16_t SSIZE = 2048;
+    static const uint16_t SMASK = 0x07FF;
+};
+
+extern W5100Class W5100;
+
+/**
+ * The test side of the register model.
+ */
+namespace HostChip {
+
+/// Clears all registers and buffers: every socket CLOSED, no flags, INTn released.
+void reset();
+
+/// Copies data into socket s's RX buffer and raises RECV, like an arriving segment.
+void deliver(uint8_t s, const uint8_t* data, uint16_t len);
+
+/// Delivers a datagram to a UDP socket with the 8-byte header the chip prepends.
+void deliverUdp(uint8_t s, IPAddress from, uint16_t port, const uint8_t* data, uint16_t len);
+
+/// A peer connects to listening socket s: ESTABLISHED and CON.
+void peerConnect(uint8_t s);
+
+/// The peer closes socket s's connection: CLOSE_WAIT and DISCON.
+void peerClose(uint8_t s);
+
+/// Returns the status register of socket s.
+uint8_t status(uint8_t s);
+
+/// Returns the payload of the last SEND on socket s, and its length in len.
+const uint8_t* lastSent(uint8_t s, uint16_t& len);
+
+/// Returns the SEND commands socket s has carried out since the last reset().
+unsigned long sendCount(uint8_t s);
+
+/// Returns the number of read(), write() and execCmdSn() calls since the last reset().
+unsigned long transfers();
+
+/// Drives pin like the chip's INTn line: low while any socket flag is unmasked.
+void wireInterrupt(uint8_t pin);
+
+} // namespace HostChip
+
+#endif // SIMPLE_NET_STUB_W5100_H
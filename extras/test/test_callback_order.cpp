@@ -0,0 +1,60 @@
+// The order a sketch sees things in: on connect the services come up before the
+// onConnect callback and the events follow, one per loop(); on a lost link the
+// services go down before onDisconnect.
+#include <string>
+#include "NetTest.h"
+#include "SimpleNetSim.h"
+
+using namespace SimpleNet;
+
+static byte mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x05 };
+static std::string trail;
+
+class RecordingService : public NetService {
+public:
+    explicit RecordingService(SimpleNetManagerBase& manager) : NetService(manager) {}
+    void networkUp() override { trail += "up "; }
+    void networkDown() override { trail += "down "; }
+};
+
+static void onConnect() { trail += "onConnect "; }
+static void onDisconnect() { trail += "onDisconnect "; }
+
+static void onEvent(NetEvent event, void*) {
+    switch (event) {
+        case NET_EVENT_CONNECTED:    trail += "CONNECTED "; break;
+        case NET_EVENT_DISCONNECTED: trail += "DISCONNECTED "; break;
+        case NET_EVENT_LINK_UP:      trail += "LINK_UP "; break;
+        case NET_EVENT_LINK_DOWN:    trail += "LINK_DOWN "; break;
+        case NET_EVENT_IP_CHANGED:   trail += "IP_CHANGED "; break;
+        default:                     trail += "other "; break;
+    }
+}
+
+int main() {
+    NetSim sim;
+    SimpleNetManagerT<NET_MODE_DHCP, NetNoDebug, 10, NetSimBackend> manager(mac);
+    RecordingService service(manager);
+    manager.onConnect(onConnect);
+    manager.onDisconnect(onDisconnect);
+    manager.addEventListener(onEvent);
+    manager.begin();
+
+    sim.runUntil(manager, NET_CONNECTED, 10000);
+    sim.runUntil(manager, NET_DISCONNECTED, 100);
+    NET_CHECK_STR_EQ(trail.c_str(), "up onConnect LINK_UP CONNECTED IP_CHANGED ");
+
+    trail.clear();
+    sim.setLink(false);
+    sim.runUntil(manager, NET_DISCONNECTED, 1000);
+    sim.runUntil(manager, NET_CONNECTED, 100);
+    NET_CHECK_STR_EQ(trail.c_str(), "down onDisconnect LINK_DOWN DISCONNECTED ");
+
+    // A reconnect to the same lease does not report an IP change.
+    trail.clear();
+    sim.setLink(true);
+    sim.runUntil(manager, NET_CONNECTED, 20000);
+    sim.runUntil(manager, NET_DISCONNECTED, 100);
+    NET_CHECK_STR_EQ(trail.c_str(), "up onConnect LINK_UP CONNECTED ");
+    return netTestResult();
+}
@@ -0,0 +1,65 @@
+// INTn is per manager: an event on one manager's chip is serviced by that manager
+// alone, and the other one's loop() makes no extra chip transfer for it.
+#include "NetTest.h"
+#include "SimpleNetSim.h"
+#include "utility/w5100.h"
+
+using namespace SimpleNet;
+
+static byte macA[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x09 };
+static byte macB[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x0A };
+
+typedef SimpleNetManagerT<NET_MODE_DHCP, NetNoDebug, 10, NetSimBackend> Manager;
+
+static const uint8_t INT_A = 4;
+static const uint8_t INT_B = 5;
+
+/**
+ * Returns the chip transfers manager makes in the given number of loop() calls.
+ */
+static unsigned long transfersOf(Manager& manager, uint8_t loops) {
+    unsigned long before = HostChip::transfers();
+    for (uint8_t i = 0; i < loops; i++) manager.loop();
+    return HostChip::transfers() - before;
+}
+
+int main() {
+    NetSim sim;
+    HostChip::reset();
+    Manager a(macA);
+    Manager b(macB);
+    NET_CHECK(a.setInterruptPin(INT_A));
+    NET_CHECK(b.setInterruptPin(INT_B));
+    NET_CHECK(!b.setInterruptPin(INT_A)); // Taken by a.
+    HostChip::wireInterrupt(INT_A);       // The model's INTn is a's line.
+    a.begin();
+    b.begin();
+    UdpEndpoint* udp = a.getUdp(5000);
+    NET_CHECK(udp != nullptr);
+    // Both managers drive the one register model; b connects first so that a's
+    // interrupt masks are the ones in effect.
+    sim.runUntil(b, NET_CONNECTED, 10000);
+    sim.runUntil(a, NET_CONNECTED, 10000);
+    NET_CHECK(udp && udp->isOpen());
+
+    // Settle, then measure b's loop() without any chip event.
+    transfersOf(a, 10);
+    transfersOf(b, 10);
+    unsigned long quiet = transfersOf(b, 10);
+
+    // A datagram for a's endpoint pulls INTn low on a's pin only.
+    uint8_t socket = 0;
+    while (socket < 7 && HostChip::status(socket) != SnSR::UDP) socket++;
+    NET_CHECK_EQ(HostChip::status(socket), SnSR::UDP);
+    const uint8_t payload[] = { 1, 2, 3 };
+    HostChip::deliverUdp(socket, IPAddress(192, 168, 1, 2), 9, payload, sizeof(payload));
+    NET_CHECK_EQ(digitalRead(INT_A), LOW);
+    NET_CHECK_EQ(digitalRead(INT_B), HIGH);
+    NET_CHECK_EQ(transfersOf(b, 10), quiet);
+
+    // a services its chip: the flags are cleared and the datagram is there.
+    NET_CHECK(transfersOf(a, 1) > 0);
+    NET_CHECK_EQ(digitalRead(INT_A), HIGH);
+    NET_CHECK(udp && udp->parsePacket() == sizeof(payload));
+    return netTestResult();
+}
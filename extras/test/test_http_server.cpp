@@ -0,0 +1,90 @@
+// HttpServer request framing: a repeated Content-Length is refused with 400, a
+// single one reaches the handler, and a body larger than the chip's RX buffer gets 413.
+#include "NetTest.h"
+#include "SimpleNetSim.h"
+#include "SimpleNetServer.h"
+#include "utility/w5100.h"
+
+using namespace SimpleNet;
+
+static byte mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x07 };
+static long handledLength = -1;
+
+typedef SimpleNetManagerT<NET_MODE_DHCP, NetNoDebug, 10, NetSimBackend> Manager;
+
+static void onSubmit(HttpExchange& exchange) {
+    handledLength = exchange.contentLength();
+    exchange.begin(200);
+}
+
+static const char submitPath[] PROGMEM = "/submit";
+
+static const HttpRoute routes[] PROGMEM = {
+    { HTTP_POST, submitPath, nullptr, onSubmit },
+};
+
+/**
+ * Connects a peer to a listening server socket, sends request and runs the
+ * manager until the response is out. Returns its status line up to the code.
+ */
+static const char* exchange(NetSim& sim, Manager& manager, const char* request) {
+    static char status[13];
+    status[0] = '\0';
+    uint8_t socket = 0xFF;
+    for (uint8_t s = 0; s < 8 && socket == 0xFF; s++) {
+        if (HostChip::status(s) == SnSR::LISTEN) socket = s;
+    }
+    NET_CHECK(socket != 0xFF);
+    if (socket == 0xFF) return status;
+
+    unsigned long before = HostChip::sendCount(socket);
+    HostChip::peerConnect(socket);
+    HostChip::deliver(socket, (const uint8_t*)request, (uint16_t)strlen(request));
+    for (uint8_t i = 0; i < 50 && HostChip::sendCount(socket) == before; i++) {
+        manager.loop();
+        sim.advance(1);
+    }
+    for (uint8_t i = 0; i < 10; i++) {
+        manager.loop();
+        sim.advance(1);
+    }
+    if (HostChip::sendCount(socket) == before) return status;
+    uint16_t length;
+    const uint8_t* sent = HostChip::lastSent(socket, length);
+    if (length > sizeof(status) - 1) length = sizeof(status) - 1;
+    memcpy(status, sent, length);
+    status[length] = '\0';
+    return status;
+}
+
+int main() {
+    NetSim sim;
+    HostChip::reset();
+    Manager manager(mac);
+    HttpServer server(manager);
+    server.begin(80, routes);
+    manager.begin();
+    sim.runUntil(manager, NET_CONNECTED, 10000);
+    for (uint8_t i = 0; i < 5; i++) manager.loop();
+
+    // Two Content-Length headers, even agreeing ones, are not added together.
+    NET_CHECK_STR_EQ(exchange(sim, manager,
+        "POST /submit HTTP/1.1\r\nContent-Length: 5\r\nContent-Length: 5\r\n\r\nhello"), "HTTP/1.1 400");
+    NET_CHECK_EQ(handledLength, -1);
+
+    // A list where a single length belongs is refused as well.
+    NET_CHECK_STR_EQ(exchange(sim, manager,
+        "POST /submit HTTP/1.1\r\nContent-Length: 5, 5\r\n\r\nhello"), "HTTP/1.1 400");
+    NET_CHECK_EQ(handledLength, -1);
+
+    NET_CHECK_STR_EQ(exchange(sim, manager,
+        "POST /submit HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello"), "HTTP/1.1 200");
+    NET_CHECK_EQ(handledLength, 5);
+
+    // The limit is the serving chip's RX buffer, 2 KB here.
+    handledLength = -1;
+    NET_CHECK_STR_EQ(exchange(sim, manager,
+        "POST /submit HTTP/1.1\r\nContent-Length: 3000\r\n\r\n"), "HTTP/1.1 413");
+    NET_CHECK_EQ(handledLength, -1);
+    return netTestResult();
+}
@@ -0,0 +1,42 @@
+// The server refuses the renewal at half the one-hour lease: the manager drops the
+// connection at the next lease check and gets a fresh lease on the retry.
+#include "NetTest.h"
+#include "SimpleNetSim.h"
+
+using namespace SimpleNet;
+
+static byte mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x02 };
+static int connects = 0;
+static int disconnects = 0;
+
+static void onUp() { connects++; }
+static void onDown() { disconnects++; }
+
+int main() {
+    NetSim sim;
+    SimpleNetManagerT<NET_MODE_DHCP, NetNoDebug, 10, NetSimBackend> manager(mac);
+    manager.onConnect(onUp);
+    manager.onDisconnect(onDown);
+    manager.begin();
+
+    sim.runUntil(manager, NET_CONNECTED, 10000);
+    NET_CHECK_EQ(connects, 1);
+
+    // Renewal is due 1800 s in; the lease check runs once a second.
+    sim.revokeLease();
+    sim.runUntil(manager, NET_DISCONNECTED, 4000000, 100);
+    NET_CHECK(sim.lastRunMillis() >= 1800000UL);
+    NET_CHECK(sim.lastRunMillis() <= 1802000UL);
+    NET_CHECK_EQ(disconnects, 1);
+
+    sim.runUntil(manager, NET_CONNECTED, 60000);
+    NET_CHECK_EQ(sim.lastRunMillis(), 10010);
+    NET_CHECK_EQ(connects, 2);
+    NET_CHECK(sim.chipIp() == IPAddress(192, 168, 1, 100));
+
+    // A renewal the server answers keeps the connection.
+    sim.runUntil(manager, NET_DISCONNECTED, 2000000, 100);
+    NET_CHECK(manager.isConnected());
+    NET_CHECK_EQ(disconnects, 1);
+    return netTestResult();
+}
@@ -0,0 +1,52 @@
+// A lease read out of either DHCP client has the same bytes whatever the memory held
+// before, padding included, so EepromLeaseStore writes nothing for an unchanged lease.
+#include "NetTest.h"
+#include "SimpleNetSim.h"
+#include "SimpleNetEepromLeaseStore.h"
+
+using namespace SimpleNet;
+
+static byte mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x0C };
+
+template <class Client>
+static void checkStableBytes(const Client& client) {
+    DhcpLease first;
+    DhcpLease second;
+    memset(&first, 0xAA, sizeof(first));
+    memset(&second, 0x55, sizeof(second));
+    client.getLease(first);
+    client.getLease(second);
+    NET_CHECK(memcmp(&first, &second, sizeof(DhcpLease)) == 0);
+}
+
+int main() {
+    NetSim sim;
+    DhcpClient idle;
+    checkStableBytes(idle);
+
+    NetSimDhcp dhcp;
+    NET_CHECK(dhcp.start(mac, 1000));
+    while (dhcp.step() != DHCP_BOUND && sim.millis() < 1000) sim.advance(1);
+    checkStableBytes(dhcp);
+
+    // The first save writes the record; saving the same lease again, read into
+    // memory holding other garbage, writes no cell.
+    EepromLeaseStore store(16);
+    DhcpLease lease;
+    memset(&lease, 0xAA, sizeof(lease));
+    dhcp.getLease(lease);
+    store.save(lease);
+    NET_CHECK(EEPROM.writes > 0);
+    unsigned long writes = EEPROM.writes;
+
+    memset(&lease, 0x55, sizeof(lease));
+    dhcp.getLease(lease);
+    store.save(lease);
+    NET_CHECK_EQ(EEPROM.writes, writes);
+
+    DhcpLease loaded;
+    NET_CHECK(store.load(loaded));
+    NET_CHECK(memcmp(loaded.localIp, lease.localIp, 4) == 0);
+    NET_CHECK_EQ(loaded.leaseTime, 3600);
+    return netTestResult();
+}
@@ -0,0 +1,41 @@
+// A 500 ms cable pull: the loss is seen at the next link check, LINK_DOWN is
+// published, and the retry after the 10 s connection retry interval brings it back.
+#include "NetTest.h"
+#include "SimpleNetSim.h"
+
+using namespace SimpleNet;
+
+static byte mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+static int linkDowns = 0;
+static int linkUps = 0;
+
+static void onEvent(NetEvent event, void*) {
+    if (event == NET_EVENT_LINK_DOWN) linkDowns++;
+    if (event == NET_EVENT_LINK_UP) linkUps++;
+}
+
+int main() {
+    NetSim sim;
+    SimpleNetManagerT<NET_MODE_DHCP, NetNoDebug, 10, NetSimBackend> manager(mac);
+    manager.addEventListener(onEvent);
+    manager.begin();
+
+    // DISCOVER/OFFER and REQUEST/ACK take 5 ms each.
+    sim.runUntil(manager, NET_CONNECTED, 10000);
+    NET_CHECK_EQ(sim.lastRunMillis(), 10);
+    NET_CHECK(manager.isConnected());
+    NET_CHECK(sim.chipIp() == IPAddress(192, 168, 1, 100));
+
+    sim.flapLink(500);
+    sim.runUntil(manager, NET_DISCONNECTED, 10000);
+    NET_CHECK(sim.lastRunMillis() <= 100); // One link check interval.
+    NET_CHECK(!manager.isConnected());
+
+    sim.runUntil(manager, NET_CONNECTED, 60000);
+    NET_CHECK_EQ(sim.lastRunMillis(), 10010); // Retry interval plus the exchange.
+
+    sim.runUntil(manager, NET_DISCONNECTED, 100); // Let the queued events drain.
+    NET_CHECK_EQ(linkDowns, 1);
+    NET_CHECK_EQ(linkUps, 2);
+    return netTestResult();
+}
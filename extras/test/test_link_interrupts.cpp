@@ -0,0 +1,85 @@
+// Link pin interrupts are per manager: a change on one manager's pin makes only that
+// manager check its link, and the four shared pin interrupt slots are handed out and
+// released correctly. A pin without an interrupt is refused without taking a slot.
+#include "NetTest.h"
+#include "SimpleNetSim.h"
+
+using namespace SimpleNet;
+
+static byte macA[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x07 };
+static byte macB[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x08 };
+
+typedef SimpleNetManagerT<NET_MODE_DHCP, NetNoDebug, 10, NetSimBackend> Manager;
+
+static const uint8_t PIN_A = 2;
+static const uint8_t PIN_B = 3;
+static const uint8_t PIN_NO_INTERRUPT = HOST_PIN_COUNT;
+
+static void loopBoth(NetSim& sim, Manager& a, Manager& b, unsigned long ms) {
+    for (unsigned long i = 0; i < ms; i++) {
+        a.loop();
+        b.loop();
+        sim.advance(1);
+    }
+}
+
+int main() {
+    NetSim sim;
+    {
+        Manager a(macA);
+        Manager b(macB);
+        NET_CHECK(a.setLinkInterruptPin(PIN_A));
+        NET_CHECK(b.setLinkInterruptPin(PIN_B));
+        NET_CHECK(!b.setLinkInterruptPin(PIN_A)); // Taken by a.
+        a.setHealthCheckIntervals(600000, 1000);  // Only the interrupt triggers a check.
+        b.setHealthCheckIntervals(600000, 1000);
+        a.begin();
+        b.begin();
+        loopBoth(sim, a, b, 50);
+        NET_CHECK(a.isConnected());
+        NET_CHECK(b.isConnected());
+
+        // Both cables share the simulated link; only a's pin reports the change.
+        sim.setLink(false);
+        hostSetPin(PIN_A, LOW);
+        loopBoth(sim, a, b, 5);
+        NET_CHECK(!a.isConnected());
+        NET_CHECK(b.isConnected());
+
+        hostSetPin(PIN_B, LOW);
+        loopBoth(sim, a, b, 5);
+        NET_CHECK(!b.isConnected());
+        hostSetPin(PIN_A, HIGH);
+        hostSetPin(PIN_B, HIGH);
+        sim.setLink(true);
+
+        // Four slots in all: a and b hold two, two more fit and the fifth does not.
+        Manager* c = new Manager(macA);
+        Manager d(macA);
+        Manager e(macA);
+        NET_CHECK(c->setLinkInterruptPin(4));
+        NET_CHECK(d.setLinkInterruptPin(5));
+        NET_CHECK(!e.setLinkInterruptPin(6));
+
+        // Moving a pin reuses the manager's own slot; destroying one frees its slot.
+        NET_CHECK(a.setLinkInterruptPin(7));
+        NET_CHECK(!e.setLinkInterruptPin(PIN_A));
+        delete c;
+        NET_CHECK(e.setLinkInterruptPin(PIN_A));
+    }
+
+    // The managers released their slots when destroyed.
+    Manager f(macA);
+    Manager g(macB);
+    NET_CHECK(f.setLinkInterruptPin(PIN_A));
+    NET_CHECK(g.setLinkInterruptPin(PIN_B));
+
+    // f keeps PIN_A, and the refused pin left the other two slots free.
+    NET_CHECK(!f.setLinkInterruptPin(PIN_NO_INTERRUPT));
+    NET_CHECK(!g.setLinkInterruptPin(PIN_A));
+    Manager h(macA);
+    Manager i(macB);
+    NET_CHECK(h.setLinkInterruptPin(4));
+    NET_CHECK(i.setLinkInterruptPin(5));
+    return netTestResult();
+}
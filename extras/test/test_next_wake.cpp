@@ -0,0 +1,44 @@
+// nextWakeMs() for each compiled mode, including DHCP-only managers, which have no
+// static link timeout. The values follow the retry, link and lease timers.
+#include "NetTest.h"
+#include "SimpleNetSim.h"
+
+using namespace SimpleNet;
+
+static byte mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x0B };
+
+int main() {
+    NetSim sim;
+
+    // The Ethernet backend in DHCP-only mode compiles nextWakeMs(); before begin()
+    // the first attempt is due at once.
+    SimpleNetManagerT<NET_MODE_DHCP, NetNoDebug, 10> ethernet(mac);
+    NET_CHECK_EQ(ethernet.nextWakeMs(), 0);
+
+    SimpleNetManagerT<NET_MODE_DHCP, NetNoDebug, 10, NetSimBackend> dhcp(mac);
+    dhcp.begin();
+    NET_CHECK_EQ(dhcp.loop(), NET_CONNECTING);
+    NET_CHECK_EQ(dhcp.nextWakeMs(), 0); // The exchange is stepped by every call.
+    sim.runUntil(dhcp, NET_CONNECTED, 10000);
+    dhcp.loop(); // Drain the connect events.
+    dhcp.loop();
+    dhcp.loop();
+    NET_CHECK_EQ(dhcp.nextWakeMs(), 100); // Next link check.
+    sim.advance(60);
+    NET_CHECK_EQ(dhcp.nextWakeMs(), 40);
+
+    // Lost link: the retry is 10 s after the last attempt.
+    sim.setLink(false);
+    sim.runUntil(dhcp, NET_DISCONNECTED, 1000);
+    for (uint8_t i = 0; i < 5; i++) dhcp.loop();
+    unsigned long wake = dhcp.nextWakeMs();
+    NET_CHECK(wake > 9000 && wake <= 10000);
+
+    // Static-only: an attempt without link sleeps until the 10 s link timeout.
+    SimpleNetManagerT<NET_MODE_STATIC, NetNoDebug, 10, NetSimBackend> fixed(mac);
+    fixed.begin(IPAddress(10, 0, 0, 5), IPAddress(10, 0, 0, 1), IPAddress(10, 0, 0, 1), IPAddress(255, 255, 255, 0));
+    NET_CHECK_EQ(fixed.loop(), NET_CONNECTING);
+    for (uint8_t i = 0; i < 5; i++) fixed.loop();
+    NET_CHECK(fixed.nextWakeMs() <= 100); // The link check comes before the timeout.
+    return netTestResult();
+}
@@ -0,0 +1,67 @@
+// With the DHCP server silent, attempts time out after 500 ms and the delays between
+// them double from 1 s up to the 8 s cap. A successful connect restarts the backoff.
+#include "NetTest.h"
+#include "SimpleNetSim.h"
+
+using namespace SimpleNet;
+
+static byte mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x04 };
+
+typedef SimpleNetManagerT<NET_MODE_DHCP, NetNoDebug, 10, NetSimBackend> Manager;
+
+/**
+ * Runs the manager for durationMs and records when each connection attempt started.
+ */
+static uint8_t recordAttempts(NetSim& sim, Manager& manager, unsigned long durationMs, unsigned long* starts, uint8_t capacity) {
+    uint8_t count = 0;
+    NetState previous = NET_DISCONNECTED;
+    unsigned long end = sim.millis() + durationMs;
+    while (sim.millis() < end) {
+        NetState state = manager.loop();
+        if (state == NET_CONNECTING && previous != NET_CONNECTING && count < capacity) {
+            starts[count++] = sim.millis();
+        }
+        previous = state;
+        sim.advance(1);
+    }
+    return count;
+}
+
+int main() {
+    NetSim sim;
+    sim.setDhcpServer(false);
+    Manager manager(mac);
+    manager.setRetryPolicy(RetryPolicy(1000, 8000, 2, 0));
+    manager.setDhcpTimeout(500);
+    manager.begin();
+
+    // Each attempt: 500 ms timeout, then 1, 2, 4, 8, 8 s.
+    const unsigned long expected[] = { 0, 1500, 4000, 8500, 17000, 25500 };
+    unsigned long starts[8];
+    uint8_t count = recordAttempts(sim, manager, 26000, starts, 8);
+    NET_CHECK_EQ(count, 6);
+    for (uint8_t i = 0; i < count && i < 6; i++) {
+        NET_CHECK_EQ(starts[i], expected[i]);
+    }
+
+    // The server comes back: the next attempt connects.
+    sim.setDhcpServer(true);
+    sim.runUntil(manager, NET_CONNECTED, 20000);
+    NET_CHECK(manager.isConnected());
+
+    // After a lost link the backoff starts over: the first retry waits the 1 s
+    // minimum, not the 8 s reached above, and the next one 2 s.
+    sim.setDhcpServer(false);
+    sim.setLink(false);
+    sim.runUntil(manager, NET_DISCONNECTED, 1000);
+    NET_CHECK(!manager.isConnected());
+    sim.setLink(true);
+    unsigned long lost = sim.millis();
+    count = recordAttempts(sim, manager, 5000, starts, 8);
+    NET_CHECK_EQ(count, 2);
+    if (count == 2) {
+        NET_CHECK_EQ(starts[0] - lost, 1000);
+        NET_CHECK_EQ(starts[1] - starts[0], 2500);
+    }
+    return netTestResult();
+}
@@ -0,0 +1,152 @@
+// Services that go away while the manager runs: requests deleted from their own
+// onComplete, onError and onData callbacks, one deleted mid-pass by another service, one destroyed
+// while a budgeted loop() was due to resume with it and one leaving from networkDown().
+#include "NetTest.h"
+#include "SimpleNetSim.h"
+#include "SimpleNetHttp.h"
+#include "utility/w5100.h"
+
+using namespace SimpleNet;
+
+static byte mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x06 };
+static int completed = 0;
+static int failed = 0;
+static int received = 0;
+
+typedef SimpleNetManagerT<NET_MODE_DHCP, NetNoDebug, 10, NetSimBackend> Manager;
+
+class CountingService : public NetService {
+public:
+    explicit CountingService(SimpleNetManagerBase& manager) : NetService(manager), polls(0), costMicros(0), victim(nullptr) {}
+    void poll() override {
+        polls++;
+        NetSim::current()->advanceMicros(costMicros);
+        if (victim) {
+            delete victim;
+            victim = nullptr;
+        }
+    }
+
+    unsigned long    polls;
+    unsigned long    costMicros; ///< Simulated time each poll() takes.
+    CountingService* victim;     ///< Deleted on the next poll().
+};
+
+static int downs = 0;
+
+class LeavingService : public NetService {
+public:
+    explicit LeavingService(SimpleNetManagerBase& manager) : NetService(manager) {}
+    void networkDown() override {
+        downs++;
+        delete this;
+    }
+};
+
+static void onComplete(HttpRequest& request) {
+    completed++;
+    delete &request;
+}
+
+static void onError(HttpRequest& request) {
+    failed++;
+    delete &request;
+}
+
+static void onData(HttpRequest& request) {
+    received++;
+    delete &request;
+}
+
+/**
+ * Sends a heap request, answers it with response and runs the manager until the
+ * request's callbacks are done with it; they delete it.
+ */
+static void runRequest(NetSim& sim, Manager& manager, HttpRequest* request, const char* response) {
+    NET_CHECK(request->begin(IPAddress(192, 168, 1, 2), 80, "example.com", "GET", "/"));
+    NET_CHECK(request->send());
+    uint8_t socket = 0xFF;
+    for (uint8_t i = 0; i < 50 && socket == 0xFF; i++) {
+        manager.loop();
+        sim.advance(1);
+        for (uint8_t s = 0; s < 8; s++) {
+            if (HostChip::status(s) == SnSR::ESTABLISHED) socket = s;
+        }
+    }
+    NET_CHECK(socket != 0xFF);
+    if (socket == 0xFF) return;
+
+    for (uint8_t i = 0; i < 10; i++) {
+        manager.loop();
+        sim.advance(1);
+    }
+    HostChip::deliver(socket, (const uint8_t*)response, (uint16_t)strlen(response));
+    for (uint8_t i = 0; i < 20; i++) {
+        manager.loop();
+        sim.advance(1);
+    }
+    NET_CHECK_EQ(HostChip::status(socket), SnSR::CLOSED);
+}
+
+int main() {
+    NetSim sim;
+    HostChip::reset();
+    Manager manager(mac);
+    CountingService survivor(manager);
+    manager.begin();
+    sim.runUntil(manager, NET_CONNECTED, 10000);
+
+    // Heap requests that delete themselves when the response is complete, when the
+    // status line is malformed, and on the first body bytes.
+    HttpRequest* request = new HttpRequest(manager);
+    request->onComplete(onComplete);
+    runRequest(sim, manager, request, "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok");
+    NET_CHECK_EQ(completed, 1);
+
+    request = new HttpRequest(manager);
+    request->onError(onError);
+    runRequest(sim, manager, request, "garbage\r\nmore\r\n");
+    NET_CHECK_EQ(failed, 1);
+
+    request = new HttpRequest(manager);
+    request->onData(onData);
+    runRequest(sim, manager, request, "HTTP/1.1 200 OK\r\nContent-Length: 4\r\n\r\nbody");
+    NET_CHECK_EQ(received, 1);
+    NET_CHECK_EQ(completed, 1);
+
+    // One service deletes the next one in the list from its poll().
+    CountingService* victim = new CountingService(manager);
+    CountingService* killer = new CountingService(manager); // Polled before victim.
+    killer->victim = victim;
+    unsigned long before = survivor.polls;
+    manager.loop();
+    manager.loop();
+    NET_CHECK_EQ(killer->polls, 2);
+    NET_CHECK(survivor.polls > before);
+
+    // A slow service uses up the budget, so loop() stops with the next one, parked,
+    // due first on the next call. Destroying parked then is safe.
+    CountingService* parked = new CountingService(manager);
+    CountingService* slow = new CountingService(manager); // Polled before parked.
+    slow->costMicros = 100;
+    for (uint8_t i = 0; i < 20 && slow->polls == 0; i++) manager.loop(10);
+    NET_CHECK_EQ(slow->polls, 1);
+    NET_CHECK_EQ(parked->polls, 0);
+    delete parked;
+    before = survivor.polls;
+    for (uint8_t i = 0; i < 20 && survivor.polls == before; i++) manager.loop(10);
+    NET_CHECK_EQ(survivor.polls, before + 1);
+    delete slow;
+
+    // A service that deletes itself from networkDown() does not break the transition.
+    delete killer;
+    new LeavingService(manager);
+    sim.setLink(false);
+    sim.runUntil(manager, NET_DISCONNECTED, 1000);
+    NET_CHECK(!manager.isConnected());
+    NET_CHECK_EQ(downs, 1);
+    before = survivor.polls;
+    manager.loop();
+    NET_CHECK_EQ(survivor.polls, before + 1);
+    return netTestResult();
+}
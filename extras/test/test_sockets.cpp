@@ -0,0 +1,80 @@
+// NetSocket and UdpEndpoint against the W5500 register model: the same register
+// traffic a board sees, checked through what the chip ends up sending.
+#include "NetTest.h"
+#include "SimpleNetSim.h"
+#include "SimpleNetUdp.h"
+#include "utility/w5100.h"
+
+using namespace SimpleNet;
+
+static void testUdp() {
+    HostChip::reset();
+    UdpEndpoint udp;
+    NET_CHECK(udp.open(5000));
+    NET_CHECK_EQ(HostChip::status(0), SnSR::UDP);
+
+    const uint8_t request[] = { 'p', 'i', 'n', 'g' };
+    NET_CHECK(udp.beginPacket(IPAddress(192, 168, 1, 2), 7));
+    NET_CHECK_EQ(udp.write(request, sizeof(request)), sizeof(request));
+    NET_CHECK(udp.endPacket());
+    uint16_t length = 0;
+    const uint8_t* sent = HostChip::lastSent(0, length);
+    NET_CHECK_EQ(HostChip::sendCount(0), 1);
+    NET_CHECK_EQ(length, sizeof(request));
+    NET_CHECK(memcmp(sent, request, sizeof(request)) == 0);
+
+    NET_CHECK_EQ(udp.parsePacket(), 0);
+    const uint8_t reply[] = { 'p', 'o', 'n', 'g', '!' };
+    HostChip::deliverUdp(0, IPAddress(192, 168, 1, 2), 7, reply, sizeof(reply));
+    NET_CHECK_EQ(udp.parsePacket(), sizeof(reply));
+    NET_CHECK(udp.remoteIP() == IPAddress(192, 168, 1, 2));
+    NET_CHECK_EQ(udp.remotePort(), 7);
+    uint8_t buffer[8] = { 0 };
+    NET_CHECK_EQ(udp.read(1, buffer, sizeof(buffer)), sizeof(reply) - 1);
+    NET_CHECK(memcmp(buffer, reply + 1, sizeof(reply) - 1) == 0);
+    NET_CHECK_EQ(udp.parsePacket(), 0);
+
+    // A second endpoint takes the next free socket.
+    UdpEndpoint other;
+    NET_CHECK(other.open(5001));
+    NET_CHECK_EQ(HostChip::status(1), SnSR::UDP);
+    udp.close();
+    other.close();
+    NET_CHECK_EQ(HostChip::status(0), SnSR::CLOSED);
+    NET_CHECK_EQ(HostChip::status(1), SnSR::CLOSED);
+}
+
+static void testTcp() {
+    HostChip::reset();
+    NetSocket socket;
+    NET_CHECK(socket.openTcp());
+    NET_CHECK_EQ(socket.status(), SnSR::INIT);
+    NET_CHECK(socket.connect(IPAddress(192, 168, 1, 2), 80));
+    NET_CHECK_EQ(socket.status(), SnSR::ESTABLISHED);
+
+    const uint8_t data[] = "GET / HTTP/1.0\r\n\r\n";
+    NET_CHECK_EQ(socket.send(data, sizeof(data) - 1), sizeof(data) - 1);
+    uint16_t length = 0;
+    HostChip::lastSent(socket.number(), length);
+    NET_CHECK_EQ(length, sizeof(data) - 1);
+
+    const uint8_t body[] = { 'o', 'k' };
+    HostChip::deliver(socket.number(), body, sizeof(body));
+    NET_CHECK_EQ(socket.rxAvailable(), sizeof(body));
+    uint8_t buffer[4] = { 0 };
+    NET_CHECK_EQ(socket.recv(buffer, sizeof(buffer)), sizeof(body));
+    NET_CHECK(buffer[0] == 'o' && buffer[1] == 'k');
+    NET_CHECK_EQ(socket.rxAvailable(), 0);
+
+    HostChip::peerClose(socket.number());
+    NET_CHECK_EQ(socket.status(), SnSR::CLOSE_WAIT);
+    socket.close();
+    NET_CHECK_EQ(HostChip::status(0), SnSR::CLOSED);
+}
+
+int main() {
+    NetSim sim; // Supplies millis() and micros().
+    testUdp();
+    testTcp();
+    return netTestResult();
+}
@@ -0,0 +1,33 @@
+// Static addressing without a cable: each attempt waits out the 10 s link timeout,
+// and after the third failed attempt the chip is configured again. Plugging the
+// cable in connects at the next attempt.
+#include "NetTest.h"
+#include "SimpleNetSim.h"
+
+using namespace SimpleNet;
+
+static byte mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x03 };
+
+int main() {
+    NetSim sim;
+    sim.setLink(false);
+    SimpleNetManagerT<NET_MODE_STATIC, NetNoDebug, 10, NetSimBackend> manager(mac);
+    manager.begin(IPAddress(10, 0, 0, 5), IPAddress(10, 0, 0, 1), IPAddress(10, 0, 0, 1), IPAddress(255, 255, 255, 0));
+    NET_CHECK_EQ(sim.configureCount(), 1);
+
+    // Attempts start at 0, 20, 40 and 60 s (10 s timeout, 10 s retry interval).
+    sim.runUntil(manager, NET_CONNECTED, 59000, 10);
+    NET_CHECK(manager.loop() != NET_CONNECTED);
+    NET_CHECK_EQ(sim.configureCount(), 1);
+
+    sim.runUntil(manager, NET_CONNECTED, 2000, 10);
+    NET_CHECK_EQ(sim.configureCount(), 2);
+
+    sim.setLink(true);
+    sim.runUntil(manager, NET_CONNECTED, 60000, 10);
+    NET_CHECK(manager.isConnected());
+    NET_CHECK(sim.lastRunMillis() <= 100);
+    NET_CHECK(sim.chipIp() == IPAddress(10, 0, 0, 5));
+    NET_CHECK_EQ(sim.configureCount(), 2);
+    return netTestResult();
+}